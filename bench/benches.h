@@ -0,0 +1,13 @@
+#ifndef DODGEBALL_BENCHES_H
+#define DODGEBALL_BENCHES_H
+
+#include "benchmark.h"
+#include "shader/shader.h"
+
+/// @brief Collision, bounce, checkBounds-style integration and the bubble loop (World::step).
+void registerPhysicsBenchmarks(BenchmarkRunner &runner, Shader &shapeShader, Shader &playerShader);
+
+/// @brief FontRenderer::renderText layout (GL calls go to the mock).
+void registerTextBenchmarks(BenchmarkRunner &runner, Shader &textShader);
+
+#endif //DODGEBALL_BENCHES_H
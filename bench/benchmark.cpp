@@ -0,0 +1,72 @@
+#include "benchmark.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <ctime>
+#include <iostream>
+#include <thread>
+
+BenchmarkRunner::BenchmarkRunner(double minTime, std::string filter) : minTime(minTime), filter(std::move(filter)) {}
+
+static double timeRun(const std::function<void(uint64_t)> &body, uint64_t iterations) {
+    auto start = std::chrono::steady_clock::now();
+    body(iterations);
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+void BenchmarkRunner::run(const std::string &name, const std::function<void(uint64_t)> &body, double itemsPerOp) {
+    if (!filter.empty() && name.find(filter) == std::string::npos) {
+        return;
+    }
+
+    // Find an iteration count that takes at least minTime
+    uint64_t iterations = 1;
+    double elapsed = timeRun(body, iterations);
+    while (elapsed < minTime) {
+        double scale = elapsed > 0 ? 1.4 * minTime / elapsed : 10;
+        iterations = std::max<uint64_t>(iterations + 1, static_cast<uint64_t>(iterations * std::min(scale, 10.0)));
+        elapsed = timeRun(body, iterations);
+    }
+
+    double times[REPETITIONS];
+    for (double &time : times) {
+        time = timeRun(body, iterations) * 1e9 / iterations;
+    }
+    std::sort(times, times + REPETITIONS);
+
+    BenchmarkResult result = {name, iterations, times[REPETITIONS / 2], times[0], times[REPETITIONS - 1], itemsPerOp};
+    results.push_back(result);
+
+    // Human readable progress goes to stderr so stdout stays valid JSON
+    fprintf(stderr, "%-44s %14.1f ns/op %12llu iterations\n", name.c_str(), result.medianNs,
+            static_cast<unsigned long long>(iterations));
+}
+
+void BenchmarkRunner::writeJson(std::ostream &out) const {
+    char date[64];
+    std::time_t now = std::time(nullptr);
+    std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+
+    out << "{\n  \"context\": {\n";
+    out << "    \"date\": \"" << date << "\",\n";
+    out << "    \"num_cpus\": " << std::thread::hardware_concurrency() << ",\n";
+#ifdef NDEBUG
+    out << "    \"library_build_type\": \"release\"\n";
+#else
+    out << "    \"library_build_type\": \"debug\"\n";
+#endif
+    out << "  },\n  \"benchmarks\": [";
+
+    char line[512];
+    for (size_t i = 0; i < results.size(); ++i) {
+        const BenchmarkResult &result = results[i];
+        snprintf(line, sizeof(line),
+                 "%s\n    {\"name\": \"%s\", \"iterations\": %llu, \"real_time\": %.3f, \"min_time\": %.3f, "
+                 "\"max_time\": %.3f, \"time_unit\": \"ns\", \"items_per_second\": %.1f}",
+                 i == 0 ? "" : ",", result.name.c_str(), static_cast<unsigned long long>(result.iterations),
+                 result.medianNs, result.minNs, result.maxNs, result.itemsPerOp * 1e9 / result.medianNs);
+        out << line;
+    }
+    out << "\n  ]\n}\n";
+}
@@ -0,0 +1,60 @@
+#ifndef DODGEBALL_BENCHMARK_H
+#define DODGEBALL_BENCHMARK_H
+
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/// @brief Keeps the compiler from optimizing away a value computed by a benchmark.
+template <typename T>
+inline void doNotOptimize(const T &value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const void *sink;
+    sink = &value;
+#endif
+}
+
+/// @brief The timing of one benchmark (times are per operation, in nanoseconds).
+struct BenchmarkResult {
+    std::string name;
+    uint64_t iterations;
+    double medianNs;
+    double minNs;
+    double maxNs;
+    /// @brief Work items per operation (e.g. pair tests), used to report items per second
+    double itemsPerOp;
+};
+
+/**
+ * @brief Runs microbenchmarks and collects their results.
+ * @details Each benchmark body is called with an iteration count and must do its operation that many times.
+ * The count is raised until one run takes minTime, then the run is repeated and the median is reported.
+ */
+class BenchmarkRunner {
+    public:
+        /// @param minTime Minimum time of one repetition in seconds
+        /// @param filter Only benchmarks whose name contains this are run (empty runs all)
+        BenchmarkRunner(double minTime, std::string filter);
+
+        /// @brief Times body and records the result.
+        /// @param name Name of the benchmark
+        /// @param body Does the benchmarked operation `iterations` times
+        /// @param itemsPerOp Work items per operation (for items_per_second)
+        void run(const std::string &name, const std::function<void(uint64_t iterations)> &body, double itemsPerOp = 1);
+
+        /// @brief Writes every result as JSON (same layout as Google Benchmark's --benchmark_format=json).
+        void writeJson(std::ostream &out) const;
+
+    private:
+        static const int REPETITIONS = 5;
+
+        double minTime;
+        std::string filter;
+        std::vector<BenchmarkResult> results;
+};
+
+#endif //DODGEBALL_BENCHMARK_H
@@ -0,0 +1,50 @@
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include "benches.h"
+#include "mockGL.h"
+
+// dodgeball_bench [--filter <substring>] [--min-time <seconds>] [--out <file.json>]
+// Progress is printed to stderr, the JSON results to stdout (or --out).
+int main(int argc, char *argv[]) {
+    std::string filter;
+    std::string outPath;
+    double minTime = 0.2;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--filter" && i + 1 < argc) {
+            filter = argv[++i];
+        }
+        else if (arg == "--min-time" && i + 1 < argc) {
+            minTime = std::stod(argv[++i]);
+        }
+        else if (arg == "--out" && i + 1 < argc) {
+            outPath = argv[++i];
+        }
+        else {
+            std::cerr << "Usage: " << argv[0] << " [--filter <substring>] [--min-time <seconds>] [--out <file.json>]" << std::endl;
+            return 1;
+        }
+    }
+
+    // No window: the shapes and font renderer run against stand-in GL functions
+    installMockGL();
+    Shader shapeShader, playerShader, textShader;
+    shapeShader.ID = 1;
+    playerShader.ID = 2;
+    textShader.ID = 3;
+
+    BenchmarkRunner runner(minTime, filter);
+    registerPhysicsBenchmarks(runner, shapeShader, playerShader);
+    registerTextBenchmarks(runner, textShader);
+
+    if (outPath.empty()) {
+        runner.writeJson(std::cout);
+    }
+    else {
+        std::ofstream out(outPath);
+        runner.writeJson(out);
+    }
+    return 0;
+}
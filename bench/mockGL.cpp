@@ -0,0 +1,64 @@
+#include "mockGL.h"
+#include <glad/glad.h>
+
+// Every object name is unique so code that compares IDs behaves as it would on a real driver
+static GLuint nextName = 1;
+
+static void APIENTRY mockGenNames(GLsizei n, GLuint *names) {
+    for (GLsizei i = 0; i < n; ++i) {
+        names[i] = nextName++;
+    }
+}
+static void APIENTRY mockDeleteNames(GLsizei, const GLuint *) {}
+static void APIENTRY mockBind(GLenum, GLuint) {}
+static void APIENTRY mockBindVertexArray(GLuint) {}
+static void APIENTRY mockBufferData(GLenum, GLsizeiptr, const void *, GLenum) {}
+static void APIENTRY mockBufferSubData(GLenum, GLintptr, GLsizeiptr, const void *) {}
+static void APIENTRY mockVertexAttribPointer(GLuint, GLint, GLenum, GLboolean, GLsizei, const void *) {}
+static void APIENTRY mockEnableVertexAttribArray(GLuint) {}
+static void APIENTRY mockDrawArrays(GLenum, GLint, GLsizei) {}
+static void APIENTRY mockDrawElements(GLenum, GLsizei, GLenum, const void *) {}
+static GLint APIENTRY mockGetUniformLocation(GLuint, const GLchar *) { return 0; }
+static void APIENTRY mockUniform1f(GLint, GLfloat) {}
+static void APIENTRY mockUniform1i(GLint, GLint) {}
+static void APIENTRY mockUniform2f(GLint, GLfloat, GLfloat) {}
+static void APIENTRY mockUniform3f(GLint, GLfloat, GLfloat, GLfloat) {}
+static void APIENTRY mockUniform4f(GLint, GLfloat, GLfloat, GLfloat, GLfloat) {}
+static void APIENTRY mockUniformMatrix4fv(GLint, GLsizei, GLboolean, const GLfloat *) {}
+static void APIENTRY mockUseProgram(GLuint) {}
+static void APIENTRY mockActiveTexture(GLenum) {}
+static void APIENTRY mockTexImage2D(GLenum, GLint, GLint, GLsizei, GLsizei, GLint, GLenum, GLenum, const void *) {}
+static void APIENTRY mockTexParameteri(GLenum, GLenum, GLint) {}
+static void APIENTRY mockPixelStorei(GLenum, GLint) {}
+static GLenum APIENTRY mockGetError() { return GL_NO_ERROR; }
+
+void installMockGL() {
+    glad_glGenVertexArrays = mockGenNames;
+    glad_glGenBuffers = mockGenNames;
+    glad_glGenTextures = mockGenNames;
+    glad_glDeleteVertexArrays = mockDeleteNames;
+    glad_glDeleteBuffers = mockDeleteNames;
+    glad_glDeleteTextures = mockDeleteNames;
+    glad_glBindVertexArray = mockBindVertexArray;
+    glad_glBindBuffer = mockBind;
+    glad_glBindTexture = mockBind;
+    glad_glBufferData = mockBufferData;
+    glad_glBufferSubData = mockBufferSubData;
+    glad_glVertexAttribPointer = mockVertexAttribPointer;
+    glad_glEnableVertexAttribArray = mockEnableVertexAttribArray;
+    glad_glDrawArrays = mockDrawArrays;
+    glad_glDrawElements = mockDrawElements;
+    glad_glGetUniformLocation = mockGetUniformLocation;
+    glad_glUniform1f = mockUniform1f;
+    glad_glUniform1i = mockUniform1i;
+    glad_glUniform2f = mockUniform2f;
+    glad_glUniform3f = mockUniform3f;
+    glad_glUniform4f = mockUniform4f;
+    glad_glUniformMatrix4fv = mockUniformMatrix4fv;
+    glad_glUseProgram = mockUseProgram;
+    glad_glActiveTexture = mockActiveTexture;
+    glad_glTexImage2D = mockTexImage2D;
+    glad_glTexParameteri = mockTexParameteri;
+    glad_glPixelStorei = mockPixelStorei;
+    glad_glGetError = mockGetError;
+}
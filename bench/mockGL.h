@@ -0,0 +1,9 @@
+#ifndef DODGEBALL_MOCKGL_H
+#define DODGEBALL_MOCKGL_H
+
+/// @brief Points GLAD's OpenGL function pointers at do-nothing stand-ins.
+/// @details Lets the shapes, shaders and font renderer run without a window or GL context.
+/// Object names (VAOs, buffers, textures, programs) are handed out from a counter.
+void installMockGL();
+
+#endif //DODGEBALL_MOCKGL_H
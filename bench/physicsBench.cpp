@@ -0,0 +1,145 @@
+#include "benches.h"
+
+#include <cmath>
+#include <vector>
+
+#include "shapes/circle.h"
+#include "shapes/rect.h"
+#include "shapes/collision.h"
+#include "game/hazards.h"
+#include "game/level.h"
+#include "game/physics.h"
+#include "game/world.h"
+#include "framework/random.h"
+
+namespace {
+
+const float DELTA_TIME = 1.0f / 60.0f;
+const int SAMPLE_COUNT = 1024;
+
+/// @brief n bubbles with level 5's radii and speeds, on a playfield scaled so the density matches level 5.
+struct BubbleField {
+    vec2 bounds;
+    Arena arena;
+    LevelSpawns spawns;
+    /// @brief The same bubbles as entities (for World)
+    Registry registry;
+
+    BubbleField(int count, uint64_t seed) : arena(getSpawnArenaSize(count)) {
+        LevelConfig config = getLevelConfig(LAST_LEVEL);
+        float scale = std::sqrt(float(count) / config.numberOfBubbles);
+        bounds = vec2(1600, 1200) * scale;
+
+        config.numberOfBubbles = count;
+        spawns = generateBubbles(config, unsigned(bounds.x), unsigned(bounds.y), seed, arena);
+        registry.reserve(count);
+        for (int i = 0; i < spawns.count; ++i) {
+            const BubbleSpawn &spawn = spawns.bubbles[i];
+            spawnBubble(registry, spawn);
+        }
+    }
+};
+
+}
+
+void registerPhysicsBenchmarks(BenchmarkRunner &runner, Shader &shapeShader, Shader &playerShader) {
+    Random random(1234);
+
+    // Random pairs of circles, roughly half of them overlapping
+    std::vector<Circle> circles;
+    circles.reserve(SAMPLE_COUNT * 2);
+    for (int i = 0; i < SAMPLE_COUNT * 2; ++i) {
+        circles.emplace_back(shapeShader, vec2(random.nextFloat(0, 100), random.nextFloat(0, 100)),
+                             random.nextFloat(5, 25), vec2(random.nextFloat(-50, 50), random.nextFloat(-50, 50)), vec4(1));
+        circles.back().setVelocity(vec2(random.nextFloat(-50, 50), random.nextFloat(-50, 50)));
+    }
+    Rect player(playerShader, vec2(50, 50), 20, color(1, 1, 1));
+
+    runner.run("Circle::isOverlapping(Circle)", [&](uint64_t iterations) {
+        for (uint64_t i = 0; i < iterations; ++i) {
+            size_t pair = (i % SAMPLE_COUNT) * 2;
+            doNotOptimize(circles[pair].isOverlapping(circles[pair + 1]));
+        }
+    });
+
+    // Cold callers that only have a Shape go through the type table
+    const Shape &playerShape = player;
+    runner.run("Circle::isOverlapping(Shape=Rect)", [&](uint64_t iterations) {
+        for (uint64_t i = 0; i < iterations; ++i) {
+            doNotOptimize(circles[i % (SAMPLE_COUNT * 2)].isOverlapping(playerShape));
+        }
+    });
+
+    runner.run("Circle::isOverlapping(Rect)", [&](uint64_t iterations) {
+        for (uint64_t i = 0; i < iterations; ++i) {
+            doNotOptimize(circles[i % (SAMPLE_COUNT * 2)].isOverlapping(player));
+        }
+    });
+
+    runner.run("overlaps<Circle, Rect>", [&](uint64_t iterations) {
+        for (uint64_t i = 0; i < iterations; ++i) {
+            doNotOptimize(overlaps(circles[i % (SAMPLE_COUNT * 2)], player));
+        }
+    });
+
+    // Every pair is put back before it bounces so each operation does a full collision response
+    std::vector<vec2> positions, velocities;
+    for (const Circle &circle : circles) {
+        positions.push_back(circle.getPos());
+        velocities.push_back(circle.getVelocity());
+    }
+    for (int i = 0; i < SAMPLE_COUNT * 2; i += 2) {
+        positions[i + 1] = positions[i] + vec2(circles[i].getRadius(), 0);
+    }
+    runner.run("Circle::bounce", [&](uint64_t iterations) {
+        for (uint64_t i = 0; i < iterations; ++i) {
+            size_t pair = (i % SAMPLE_COUNT) * 2;
+            Circle &a = circles[pair];
+            Circle &b = circles[pair + 1];
+            a.setPos(positions[pair]);
+            a.setVelocity(velocities[pair]);
+            b.setPos(positions[pair + 1]);
+            b.setVelocity(velocities[pair + 1]);
+            a.bounce(b);
+            doNotOptimize(a.getPos());
+        }
+    });
+
+    // Same work as Engine::checkBounds for every bubble of a frame (the movement part of World::step), on the
+    // bubble entities' components
+    {
+        BubbleField field(1000, 42);
+        const ComponentArray<CircleCollider> &colliders = field.registry.components<CircleCollider>();
+        ComponentArray<Transform> &transforms = field.registry.components<Transform>();
+        ComponentArray<Velocity> &velocities = field.registry.components<Velocity>();
+        runner.run("checkBounds/1000", [&](uint64_t iterations) {
+            for (uint64_t i = 0; i < iterations; ++i) {
+                for (size_t bubble = 0; bubble < colliders.size(); ++bubble) {
+                    Entity entity = colliders.getEntities()[bubble];
+                    moveInBounds(transforms.get(entity).position, velocities.get(entity).value,
+                                 colliders.data()[bubble].radius, DELTA_TIME, field.bounds);
+                }
+            }
+        }, 1000);
+    }
+
+    // The bubble loop from Engine::update: world step, then the HazardQuery around the player
+    for (int count : {100, 1000, 10000}) {
+        BubbleField field(count, 42);
+        World world(field.bounds);
+        world.load(field.registry);
+        HazardQuery hazards;
+        vec2 playerMin(playerShape.getLeft(), playerShape.getBottom());
+        vec2 playerMax(playerShape.getRight(), playerShape.getTop());
+        int hits = 0;
+        runner.run("update/" + std::to_string(count), [&](uint64_t iterations) {
+            for (uint64_t i = 0; i < iterations; ++i) {
+                world.step(field.registry, DELTA_TIME);
+                if (hazards.update(world, playerMin, playerMax).hit.isValid()) {
+                    hits++;
+                }
+            }
+            doNotOptimize(hits);
+        }, count);
+    }
+}
@@ -0,0 +1,26 @@
+#include "benches.h"
+
+#include <string>
+
+#include "font/fontRenderer.h"
+
+void registerTextBenchmarks(BenchmarkRunner &runner, Shader &textShader) {
+    FontRenderer fontRenderer(textShader, PROJECT_SOURCE_DIR "/res/fonts/MxPlus_IBM_BIOS.ttf", 24);
+    const glm::mat4 projection = glm::ortho(0.0f, 1600.0f, 0.0f, 1200.0f);
+
+    // A HUD line drawn every frame while playing, and the longest line on the start screen
+    const std::string hud = "LVL 3";
+    const std::string description = "Avoid the balls & survive 20 seconds to reach the next level";
+
+    runner.run("FontRenderer::renderText/hud", [&](uint64_t iterations) {
+        for (uint64_t i = 0; i < iterations; ++i) {
+            fontRenderer.renderText(hud, 100, 1000, projection, 1, glm::vec3(1, 1, 1));
+        }
+    }, hud.length());
+
+    runner.run("FontRenderer::renderText/description", [&](uint64_t iterations) {
+        for (uint64_t i = 0; i < iterations; ++i) {
+            fontRenderer.renderText(description, 100, 1000, projection, 1, glm::vec3(1, 1, 1));
+        }
+    }, description.length());
+}
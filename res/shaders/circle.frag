@@ -1,5 +1,7 @@
 #version 330 core
 
+#include "include/sdf.glsl"
+
 out vec4 FragColor;
 in vec2 FragPos;
 
@@ -7,12 +9,29 @@ uniform vec4 shapeColor;
 uniform float radius;
 uniform vec2 center;
 
+// Outline inside the edge (0 width for none)
+uniform float outlineWidth;
+uniform vec4 outlineColor;
+// Glow outside the edge in the circle's color, fading out over glowWidth (0 width for none)
+uniform float glowWidth;
+uniform float glowStrength;
+
 void main()
 {
-    // Calculate the distance from the center to the fragment
-    if (length(FragPos - center) > radius) {
-        // Discard all fragments outside the circle
-        discard;
+    float dist = sdCircle(FragPos, center, radius);
+    float edge = pixelEdge(dist);
+
+    float coverage = edgeCoverage(dist, edge);
+    vec4 fill = shapeColor;
+    if (outlineWidth > 0.0) {
+        fill = mix(shapeColor, outlineColor, smoothstep(-outlineWidth - edge, -outlineWidth + edge, dist));
+    }
+
+    float glow = 0.0;
+    if (glowWidth > 0.0) {
+        float falloff = 1.0 - smoothstep(0.0, glowWidth, dist);
+        glow = glowStrength * falloff * falloff;
     }
-    FragColor = shapeColor;
+    // Transparent rather than discarded outside the circle (discard turns off early depth tests)
+    FragColor = vec4(mix(shapeColor.rgb, fill.rgb, coverage), mix(shapeColor.a * glow, fill.a, coverage));
 }
@@ -1,15 +1,18 @@
 #version 330 core
 
+// Unit quad (-0.5 to 0.5), stretched around the circle
 layout (location = 0) in vec2 aPos;
 
-uniform mat4 model;
 uniform mat4 projection;
+uniform vec2 center;
+uniform float radius;
+// Room around the circle for its glow and the anti-aliased edge
+uniform float padding;
 
 out vec2 FragPos;
 
 void main()
 {
-    vec4 worldPos = model * vec4(aPos.x, aPos.y, 0.0, 1.0);
-    FragPos = worldPos.xy;
-    gl_Position = projection * worldPos;
+    FragPos = center + aPos * 2.0 * (radius + padding);
+    gl_Position = projection * vec4(FragPos, 0.0, 1.0);
 }
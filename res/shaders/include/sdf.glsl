@@ -0,0 +1,18 @@
+// Signed distance helpers (distances are negative inside the shape)
+
+float sdCircle(vec2 point, vec2 center, float radius)
+{
+    return length(point - center) - radius;
+}
+
+// Half a pixel in distance units, whatever the projection (fragment shaders only)
+float pixelEdge(float dist)
+{
+    return max(fwidth(dist), 0.0001) * 0.5;
+}
+
+// How much of the pixel is inside the shape (smooth over about one pixel, so edges are anti-aliased at any size)
+float edgeCoverage(float dist, float edge)
+{
+    return 1.0 - smoothstep(-edge, edge, dist);
+}
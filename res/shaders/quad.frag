@@ -0,0 +1,23 @@
+#version 330 core
+
+out vec4 FragColor;
+
+uniform vec4 shapeColor;
+
+#ifdef TEXTURED
+in vec2 TexCoords;
+uniform sampler2D image;
+#endif
+
+void main()
+{
+#if defined(TEXTURED) && defined(GLYPH)
+    // Glyph textures only have a red channel (how much of the pixel the glyph covers)
+    FragColor = shapeColor * vec4(1.0, 1.0, 1.0, texture(image, TexCoords).r);
+#elif defined(TEXTURED)
+    // The color tints the texture
+    FragColor = shapeColor * texture(image, TexCoords);
+#else
+    FragColor = shapeColor;
+#endif
+}
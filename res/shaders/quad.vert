@@ -0,0 +1,26 @@
+#version 330 core
+
+// Shapes (MODEL_MATRIX), sprites (MODEL_MATRIX + TEXTURED) and text (TEXTURED + GLYPH) are variants of this source
+#ifdef TEXTURED
+layout (location = 0) in vec4 vertex; // <vec2 position, vec2 texCoords>
+out vec2 TexCoords;
+#else
+layout (location = 0) in vec2 vertex;
+#endif
+
+uniform mat4 projection;
+#ifdef MODEL_MATRIX
+uniform mat4 model;
+#endif
+
+void main()
+{
+    vec4 position = vec4(vertex.xy, 0.0, 1.0);
+#ifdef MODEL_MATRIX
+    position = model * position;
+#endif
+#ifdef TEXTURED
+    TexCoords = vertex.zw;
+#endif
+    gl_Position = projection * position;
+}
@@ -1,14 +0,0 @@
-#version 330 core
-// Both position and texture coordinates contain two floats, so we combine them into a single vertex attribute
-layout (location = 0) in vec4 vertex; // <vec2 position, vec2 texCoords>
-
-out vec2 TexCoords;
-
-uniform mat4 model;
-uniform mat4 projection;
-
-void main()
-{
-    TexCoords = vertex.zw;
-    gl_Position = projection * model * vec4(vertex.xy, 0.0, 1.0);
-}
\ No newline at end of file
@@ -0,0 +1,109 @@
+#ifndef GRAPHICS_COMPONENTARRAY_H
+#define GRAPHICS_COMPONENTARRAY_H
+
+#include <cstdint>
+#include <vector>
+#include "entity.h"
+#include "../framework/snapshot.h"
+
+using std::vector;
+
+/**
+ * @brief Dense storage for one component type (sparse set).
+ * @details Components are packed in one array with no holes, so systems iterate them linearly.
+ * sparse maps an entity's index to its component; removing swaps the last component into the hole,
+ * so the order changes when components are removed.
+ */
+template <typename T>
+class ComponentArray {
+    public:
+        void reserve(size_t capacity) {
+            dense.reserve(capacity);
+            entities.reserve(capacity);
+            sparse.reserve(capacity);
+        }
+
+        /// @brief Adds the component to the entity (or replaces the one it has).
+        T &add(Entity entity, const T &component) {
+            if (T *existing = find(entity)) {
+                *existing = component;
+                return *existing;
+            }
+            if (entity.index >= sparse.size()) {
+                sparse.resize(entity.index + 1, NONE);
+            }
+            sparse[entity.index] = static_cast<uint32_t>(dense.size());
+            dense.push_back(component);
+            entities.push_back(entity);
+            return dense.back();
+        }
+
+        /// @brief Removes the entity's component (does nothing if it has none).
+        void remove(Entity entity) {
+            if (!has(entity)) {
+                return;
+            }
+            uint32_t hole = sparse[entity.index];
+            uint32_t last = static_cast<uint32_t>(dense.size() - 1);
+            if (hole != last) {
+                dense[hole] = dense[last];
+                entities[hole] = entities[last];
+                sparse[entities[hole].index] = hole;
+            }
+            dense.pop_back();
+            entities.pop_back();
+            sparse[entity.index] = NONE;
+        }
+
+        bool has(Entity entity) const {
+            return entity.index < sparse.size() && sparse[entity.index] != NONE && entities[sparse[entity.index]] == entity;
+        }
+
+        /// @brief Returns the entity's component, or nullptr if it has none.
+        T *find(Entity entity)             { return has(entity) ? &dense[sparse[entity.index]] : nullptr; }
+        const T *find(Entity entity) const { return has(entity) ? &dense[sparse[entity.index]] : nullptr; }
+
+        /// @brief Returns the entity's component (the entity must have one).
+        T &get(Entity entity)             { return dense[sparse[entity.index]]; }
+        const T &get(Entity entity) const { return dense[sparse[entity.index]]; }
+
+        void clear() {
+            dense.clear();
+            entities.clear();
+            sparse.clear();
+        }
+
+        size_t size() const { return dense.size(); }
+
+        /// @brief The packed components and the entity each one belongs to (same order).
+        T *data()                          { return dense.data(); }
+        const T *data() const              { return dense.data(); }
+        const Entity *getEntities() const  { return entities.data(); }
+
+        typename vector<T>::iterator begin()             { return dense.begin(); }
+        typename vector<T>::iterator end()               { return dense.end(); }
+        typename vector<T>::const_iterator begin() const { return dense.begin(); }
+        typename vector<T>::const_iterator end() const   { return dense.end(); }
+
+        /// @brief Writes every component (and the index) to a snapshot.
+        void save(SnapshotWriter &snapshot) const {
+            snapshot.writeArray(dense);
+            snapshot.writeArray(entities);
+            snapshot.writeArray(sparse);
+        }
+
+        /// @brief Replaces every component with the ones in a snapshot.
+        bool load(SnapshotReader &snapshot) {
+            return snapshot.readArray(dense) && snapshot.readArray(entities) && snapshot.readArray(sparse) &&
+                   dense.size() == entities.size();
+        }
+
+    private:
+        static constexpr uint32_t NONE = 0xFFFFFFFF;
+
+        vector<T> dense;
+        vector<Entity> entities;
+        vector<uint32_t> sparse;
+};
+
+#endif //GRAPHICS_COMPONENTARRAY_H
@@ -0,0 +1,65 @@
+#ifndef GRAPHICS_COMPONENTS_H
+#define GRAPHICS_COMPONENTS_H
+
+#include <cstdint>
+#include "glm/glm.hpp"
+
+using glm::vec2, glm::vec4;
+
+// Components are plain data (no pointers, no OpenGL), so component arrays can be copied with memcpy.
+
+/// @brief Where an entity is and how big it is.
+struct Transform {
+    /// @brief Center of the entity
+    vec2 position;
+    /// @brief Width and height (a circle's diameter)
+    vec2 size;
+};
+
+/// @brief Movement in units per second.
+struct Velocity {
+    vec2 value;
+};
+
+/// @brief Circle used for collisions (bubbles). Entities with one are moved and bounced by the World.
+struct CircleCollider {
+    float radius;
+};
+
+/// @brief Axis aligned box used for collisions and mouse clicks (player, buttons).
+struct RectCollider {
+    vec2 halfSize;
+};
+
+/// @brief Mesh an entity is drawn with.
+enum class Mesh : uint8_t {
+    circle,
+    rect
+};
+
+/// @brief Groups of entities each screen draws (see RenderSystem::draw()).
+enum class Layer : uint8_t {
+    player,
+    bubble,
+    button,
+    playerPreview,
+    confetti,
+    pixelArt,
+    /// @brief Not drawn (e.g. the hidden God Mode button)
+    hidden
+};
+const int LAYER_COUNT = static_cast<int>(Layer::hidden) + 1;
+
+/// @brief How an entity is drawn.
+struct Renderable {
+    vec4 color;
+    Mesh mesh;
+    Layer layer;
+};
+
+/// @brief Seconds until the entity expires (see lifetimeSystem()).
+struct Lifetime {
+    float remaining;
+};
+
+#endif //GRAPHICS_COMPONENTS_H
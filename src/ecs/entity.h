@@ -0,0 +1,22 @@
+#ifndef GRAPHICS_ENTITY_H
+#define GRAPHICS_ENTITY_H
+
+#include <cstdint>
+
+/**
+ * @brief Handle to a game object in a Registry.
+ * @details index is reused once the entity is destroyed; generation tells an old handle apart from the new entity.
+ */
+struct Entity {
+    uint32_t index = INVALID;
+    uint32_t generation = 0;
+
+    static constexpr uint32_t INVALID = 0xFFFFFFFF;
+
+    bool isValid() const { return index != INVALID; }
+
+    bool operator==(const Entity &other) const { return index == other.index && generation == other.generation; }
+    bool operator!=(const Entity &other) const { return !(*this == other); }
+};
+
+#endif //GRAPHICS_ENTITY_H
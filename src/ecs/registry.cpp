@@ -0,0 +1,80 @@
+#include "registry.h"
+
+void Registry::reserve(size_t entities) {
+    transforms.reserve(entities);
+    velocities.reserve(entities);
+    circleColliders.reserve(entities);
+    rectColliders.reserve(entities);
+    renderables.reserve(entities);
+    lifetimes.reserve(entities);
+    generations.reserve(entities);
+    freeIndices.reserve(entities);
+}
+
+Entity Registry::create() {
+    Entity entity;
+    if (!freeIndices.empty()) {
+        entity.index = freeIndices.back();
+        freeIndices.pop_back();
+    }
+    else {
+        entity.index = static_cast<uint32_t>(generations.size());
+        generations.push_back(0);
+    }
+    entity.generation = generations[entity.index];
+    return entity;
+}
+
+void Registry::destroy(Entity entity) {
+    if (!isAlive(entity)) {
+        return;
+    }
+    transforms.remove(entity);
+    velocities.remove(entity);
+    circleColliders.remove(entity);
+    rectColliders.remove(entity);
+    renderables.remove(entity);
+    lifetimes.remove(entity);
+    generations[entity.index]++;
+    freeIndices.push_back(entity.index);
+}
+
+bool Registry::isAlive(Entity entity) const {
+    return entity.index < generations.size() && generations[entity.index] == entity.generation;
+}
+
+void Registry::clear() {
+    transforms.clear();
+    velocities.clear();
+    circleColliders.clear();
+    rectColliders.clear();
+    renderables.clear();
+    lifetimes.clear();
+    // Keep the generations so handles to the old entities stay invalid
+    freeIndices.clear();
+    for (uint32_t index = static_cast<uint32_t>(generations.size()); index > 0; --index) {
+        generations[index - 1]++;
+        freeIndices.push_back(index - 1);
+    }
+}
+
+void Registry::save(SnapshotWriter &snapshot) const {
+    transforms.save(snapshot);
+    velocities.save(snapshot);
+    circleColliders.save(snapshot);
+    rectColliders.save(snapshot);
+    renderables.save(snapshot);
+    lifetimes.save(snapshot);
+    snapshot.writeArray(generations);
+    snapshot.writeArray(freeIndices);
+}
+
+bool Registry::load(SnapshotReader &snapshot) {
+    bool loaded = transforms.load(snapshot) && velocities.load(snapshot) && circleColliders.load(snapshot) &&
+                  rectColliders.load(snapshot) && renderables.load(snapshot) && lifetimes.load(snapshot) &&
+                  snapshot.readArray(generations) && snapshot.readArray(freeIndices);
+    if (!loaded) {
+        clear();
+    }
+    return loaded;
+}
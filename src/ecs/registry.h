@@ -0,0 +1,128 @@
+#ifndef GRAPHICS_REGISTRY_H
+#define GRAPHICS_REGISTRY_H
+
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+#include "entity.h"
+#include "components.h"
+#include "componentArray.h"
+
+using std::vector;
+
+/**
+ * @brief Owns every entity and its components.
+ * @details One ComponentArray per component type. Systems iterate one array linearly and look up the other
+ * components of each entity through the sparse index (see each()).
+ */
+class Registry {
+    public:
+        /// @brief Reserves room for the given number of entities in every array.
+        void reserve(size_t entities);
+
+        /// @brief Creates an entity with no components.
+        Entity create();
+
+        /// @brief Removes every component of the entity and frees its index.
+        /// @details Don't destroy entities (or remove components) from inside each().
+        void destroy(Entity entity);
+
+        bool isAlive(Entity entity) const;
+
+        /// @brief Number of entities alive.
+        size_t getEntityCount() const { return generations.size() - freeIndices.size(); }
+
+        /// @brief Destroys every entity.
+        void clear();
+
+        /// @brief Writes every entity and component to a snapshot.
+        void save(SnapshotWriter &snapshot) const;
+
+        /// @brief Replaces every entity and component with the ones in a snapshot.
+        /// @details Handles saved with the snapshot are valid again afterwards. Doesn't allocate if the registry
+        /// already held as many entities.
+        /// @return false if the snapshot is cut short (the registry is left cleared)
+        bool load(SnapshotReader &snapshot);
+
+        /// @brief Returns the array storing every component of type T.
+        template <typename T>
+        ComponentArray<T> &components() {
+            return const_cast<ComponentArray<T> &>(static_cast<const Registry *>(this)->components<T>());
+        }
+
+        template <typename T>
+        const ComponentArray<T> &components() const {
+            if constexpr (std::is_same_v<T, Transform>)           return transforms;
+            else if constexpr (std::is_same_v<T, Velocity>)       return velocities;
+            else if constexpr (std::is_same_v<T, CircleCollider>) return circleColliders;
+            else if constexpr (std::is_same_v<T, RectCollider>)   return rectColliders;
+            else if constexpr (std::is_same_v<T, Renderable>)     return renderables;
+            else {
+                static_assert(std::is_same_v<T, Lifetime>, "Not a component type");
+                return lifetimes;
+            }
+        }
+
+        template <typename T>
+        T &add(Entity entity, const T &component) { return components<T>().add(entity, component); }
+
+        template <typename T>
+        void remove(Entity entity) { components<T>().remove(entity); }
+
+        template <typename T>
+        bool has(Entity entity) const { return components<T>().has(entity); }
+
+        /// @brief Returns the entity's component (the entity must have one).
+        template <typename T>
+        T &get(Entity entity) { return components<T>().get(entity); }
+        template <typename T>
+        const T &get(Entity entity) const { return components<T>().get(entity); }
+
+        /// @brief Returns the entity's component, or nullptr if it has none.
+        template <typename T>
+        T *find(Entity entity) { return components<T>().find(entity); }
+
+        /**
+         * @brief Calls function(entity, first, others...) for every entity that has all the given components.
+         * @details Walks First's array in order, so put the rarest component first.
+         */
+        template <typename First, typename... Others, typename Function>
+        void each(Function function) {
+            ComponentArray<First> &firstArray = components<First>();
+            const Entity *entities = firstArray.getEntities();
+            First *firsts = firstArray.data();
+            for (size_t i = 0; i < firstArray.size(); ++i) {
+                Entity entity = entities[i];
+                if ((components<Others>().has(entity) && ...)) {
+                    function(entity, firsts[i], components<Others>().get(entity)...);
+                }
+            }
+        }
+
+        template <typename First, typename... Others, typename Function>
+        void each(Function function) const {
+            const ComponentArray<First> &firstArray = components<First>();
+            const Entity *entities = firstArray.getEntities();
+            const First *firsts = firstArray.data();
+            for (size_t i = 0; i < firstArray.size(); ++i) {
+                Entity entity = entities[i];
+                if ((components<Others>().has(entity) && ...)) {
+                    function(entity, firsts[i], components<Others>().get(entity)...);
+                }
+            }
+        }
+
+    private:
+        ComponentArray<Transform> transforms;
+        ComponentArray<Velocity> velocities;
+        ComponentArray<CircleCollider> circleColliders;
+        ComponentArray<RectCollider> rectColliders;
+        ComponentArray<Renderable> renderables;
+        ComponentArray<Lifetime> lifetimes;
+
+        /// @brief Current generation of every index (bumped when the entity using it is destroyed)
+        vector<uint32_t> generations;
+        vector<uint32_t> freeIndices;
+};
+
+#endif //GRAPHICS_REGISTRY_H
@@ -0,0 +1,94 @@
+#include "renderSystem.h"
+#include "../framework/debug.h"
+#include "../framework/profiler.h"
+
+RenderSystem::RenderSystem(Shader &circleShader, Shader &rectShader) :
+    circleShader(circleShader), rectShader(rectShader),
+    circle(circleShader, vec2(0), 1.0f, vec2(0), vec4(1)),
+    rect(rectShader, vec2(0), vec2(1), color(1, 1, 1)) {}
+
+void RenderSystem::prepare(const Registry &registry) {
+    // Nothing draws the hidden layer, so skipping it leaves every other layer complete
+    static const vector<Entity> none;
+    prepare(registry, Layer::hidden, none);
+}
+
+void RenderSystem::prepare(const Registry &registry, Layer culledLayer, const vector<Entity> &visible) {
+    PROFILE_SCOPE("RenderSystem::prepare");
+    for (vector<DrawItem> &items : drawLists) {
+        items.clear();
+    }
+    const ComponentArray<Renderable> &renderables = registry.components<Renderable>();
+    const ComponentArray<Transform> &transforms = registry.components<Transform>();
+    for (size_t i = 0; i < renderables.size(); ++i) {
+        const Renderable &renderable = renderables.data()[i];
+        if (renderable.layer == culledLayer) {
+            continue;
+        }
+        const Transform &transform = transforms.get(renderables.getEntities()[i]);
+        drawLists[static_cast<int>(renderable.layer)].push_back(
+            {transform.position, transform.size, renderable.color, renderable.mesh});
+    }
+    vector<DrawItem> &culled = drawLists[static_cast<int>(culledLayer)];
+    for (Entity entity : visible) {
+        const Renderable &renderable = renderables.get(entity);
+        const Transform &transform = transforms.get(entity);
+        culled.push_back({transform.position, transform.size, renderable.color, renderable.mesh});
+    }
+}
+
+void RenderSystem::setProjection(const mat4 &projection) {
+    circleShader.use().setMatrix4("projection", projection);
+    rectShader.use().setMatrix4("projection", projection);
+}
+
+void RenderSystem::fill(const Registry &registry, Layer layer, vector<DrawItem> &items) {
+    items.clear();
+    const ComponentArray<Renderable> &renderables = registry.components<Renderable>();
+    const ComponentArray<Transform> &transforms = registry.components<Transform>();
+    for (size_t i = 0; i < renderables.size(); ++i) {
+        const Renderable &renderable = renderables.data()[i];
+        if (renderable.layer == layer) {
+            const Transform &transform = transforms.get(renderables.getEntities()[i]);
+            items.push_back({transform.position, transform.size, renderable.color, renderable.mesh});
+        }
+    }
+}
+
+void RenderSystem::draw(const Registry &registry, Layer layer) {
+    fill(registry, layer, drawLists[static_cast<int>(layer)]);
+    draw(layer);
+}
+
+void RenderSystem::draw(Layer layer) {
+    circle.setStyle(styles[static_cast<int>(layer)]);
+    Shader *current = nullptr;
+    bool styleSet = false;
+    for (const DrawItem &item : drawLists[static_cast<int>(layer)]) {
+        Shader &shader = item.mesh == Mesh::circle ? circleShader : rectShader;
+        if (current != &shader) {
+            shader.use();
+            current = &shader;
+        }
+        if (item.mesh == Mesh::circle) {
+            // The style is the same for the whole layer (and uniforms stay set when another program is used)
+            if (!styleSet) {
+                circle.setStyleUniforms();
+                styleSet = true;
+            }
+            circle.setPos(item.position);
+            circle.setRadius(item.size.x / 2);
+            circle.setColor(item.color);
+            circle.setInstanceUniforms();
+            circle.draw();
+        }
+        else {
+            rect.setPos(item.position);
+            rect.setSize(item.size);
+            rect.setColor(item.color);
+            rect.setUniforms();
+            rect.draw();
+        }
+        glCheckError();
+    }
+}
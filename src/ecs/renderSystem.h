@@ -0,0 +1,62 @@
+#ifndef GRAPHICS_RENDERSYSTEM_H
+#define GRAPHICS_RENDERSYSTEM_H
+
+#include "registry.h"
+#include "../shapes/circle.h"
+#include "../shapes/rect.h"
+#include "../shader/shader.h"
+
+/// @brief One entity to draw, copied out of the registry.
+struct DrawItem {
+    vec2 position;
+    vec2 size;
+    vec4 color;
+    Mesh mesh;
+};
+
+/**
+ * @brief Draws Renderable entities.
+ * @details Every entity is drawn with the same circle or rect mesh (moved, scaled and colored through uniforms),
+ * so entities don't own any OpenGL objects. Drawing is split in two: prepare() copies the entities into one draw
+ * list per layer without touching OpenGL (any thread), then draw(layer) submits a list (the OpenGL thread).
+ */
+class RenderSystem {
+    public:
+        /// @param circleShader Shader for Mesh::circle (circle.vert/frag, a quad with a distance-based edge)
+        /// @param rectShader Shader for Mesh::rect (the quad program's SHADER_MODEL_MATRIX variant)
+        RenderSystem(Shader &circleShader, Shader &rectShader);
+
+        /// @brief Fills every layer's draw list from the registry (no OpenGL calls).
+        /// @details Doesn't allocate once the lists have grown to the largest layers.
+        void prepare(const Registry &registry);
+
+        /// @brief Same as prepare(), but culledLayer only gets the visible entities (the ones on screen).
+        void prepare(const Registry &registry, Layer culledLayer, const vector<Entity> &visible);
+
+        /// @brief Sets the projection both shaders draw with (OpenGL thread).
+        /// @details Layers in the arena are drawn through the camera, the rest of the screen with a fixed projection.
+        void setProjection(const mat4 &projection);
+
+        /// @brief Draws the layer's list from the last prepare(), in the order the entities were added.
+        void draw(Layer layer);
+
+        /// @brief Prepares one layer and draws it right away.
+        void draw(const Registry &registry, Layer layer);
+
+        /// @brief Outline and glow of the layer's circles (none by default).
+        void setStyle(Layer layer, const CircleStyle &style) { styles[static_cast<int>(layer)] = style; }
+        const CircleStyle &getStyle(Layer layer) const { return styles[static_cast<int>(layer)]; }
+
+    private:
+        Shader &circleShader;
+        Shader &rectShader;
+        /// @brief The shared meshes (their position, size and color are set for each entity)
+        Circle circle;
+        Rect rect;
+        vector<DrawItem> drawLists[LAYER_COUNT];
+        CircleStyle styles[LAYER_COUNT];
+
+        static void fill(const Registry &registry, Layer layer, vector<DrawItem> &items);
+};
+
+#endif //GRAPHICS_RENDERSYSTEM_H
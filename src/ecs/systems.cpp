@@ -0,0 +1,46 @@
+#include "systems.h"
+#include "../game/physics.h"
+
+void movementSystem(Registry &registry, float deltaTime) {
+    const ComponentArray<CircleCollider> &circles = registry.components<CircleCollider>();
+    registry.each<Velocity, Transform>([&](Entity entity, Velocity &velocity, Transform &transform) {
+        if (!circles.has(entity)) {
+            transform.position += velocity.value * deltaTime;
+        }
+    });
+}
+
+int lifetimeSystem(Registry &registry, float deltaTime, vector<Entity> &expired) {
+    expired.clear();
+    registry.each<Lifetime>([&](Entity entity, Lifetime &lifetime) {
+        lifetime.remaining -= deltaTime;
+        if (lifetime.remaining <= 0) {
+            expired.push_back(entity);
+        }
+    });
+    // Destroyed after the loop, since destroying moves components around
+    for (Entity entity : expired) {
+        registry.destroy(entity);
+    }
+    return static_cast<int>(expired.size());
+}
+
+Entity findOverlappingCircle(const Registry &registry, vec2 rectMin, vec2 rectMax) {
+    Entity found;
+    const ComponentArray<CircleCollider> &circles = registry.components<CircleCollider>();
+    const ComponentArray<Transform> &transforms = registry.components<Transform>();
+    for (size_t i = 0; i < circles.size(); ++i) {
+        Entity entity = circles.getEntities()[i];
+        if (circleRectOverlap(transforms.get(entity).position, circles.data()[i].radius, rectMin, rectMax)) {
+            found = entity;
+            break;
+        }
+    }
+    return found;
+}
+
+bool containsPoint(const Transform &transform, vec2 point) {
+    vec2 halfSize = transform.size / 2.0f;
+    return point.x >= transform.position.x - halfSize.x && point.x <= transform.position.x + halfSize.x &&
+           point.y >= transform.position.y - halfSize.y && point.y <= transform.position.y + halfSize.y;
+}
@@ -0,0 +1,27 @@
+#ifndef GRAPHICS_SYSTEMS_H
+#define GRAPHICS_SYSTEMS_H
+
+#include <vector>
+#include "registry.h"
+
+using std::vector, glm::vec2;
+
+// Game logic systems. Each one walks a component array in order; none of them touch OpenGL.
+// Bubble movement and bounces (entities with a CircleCollider) are done by World::step().
+
+/// @brief Moves every entity with a Velocity (except circle colliders, which the World moves).
+void movementSystem(Registry &registry, float deltaTime);
+
+/// @brief Counts down every Lifetime and destroys the entities whose time ran out.
+/// @param expired Filled with the destroyed entities (reuse the same vector every frame to avoid allocating)
+/// @return The number of entities destroyed
+int lifetimeSystem(Registry &registry, float deltaTime, vector<Entity> &expired);
+
+/// @brief Returns the first circle collider that overlaps the rectangle [rectMin, rectMax] (invalid if none).
+/// @details Checks every circle. The game checks the player with a HazardQuery, which only looks near it.
+Entity findOverlappingCircle(const Registry &registry, vec2 rectMin, vec2 rectMax);
+
+/// @brief Checks if a point is inside the entity's rectangle (buttons).
+bool containsPoint(const Transform &transform, vec2 point);
+
+#endif //GRAPHICS_SYSTEMS_H
@@ -3,13 +3,14 @@
 #include <chrono>
 #include <fstream>
 #include <thread>
-#include <random>
+#include <cstdio>
 
 #include "shapes/circle.h"
 
 // Screen settings
 enum state {start, selection, play, lvlUP, lost, over, win};
 state screen;
+const char *screenNames[] = {"start", "selection", "play", "lvlUP", "lost", "over", "win"};
 // Start = rules / objective
 // Selection = choose player color
 // Play = start / play level
@@ -41,7 +42,7 @@ bool selected = false;
 // --- Level ---
 // Level count and Level timer
 float countDownStarts;
-int countDownTime = 20;
+int countDownTime = LEVEL_TIME;
 int lvl = 1;
 // --- Player ---
 // Players life count, default color, time survived, and godMode status
@@ -57,14 +58,58 @@ bool EE1 = false;
 // Player Placeholder For Player Location Viewing
 color samplePLayerColor = WHITE;
 
-// Second way of generating my random values -> dist(rd)
-std::random_device rd;
-std::uniform_int_distribution<> dist(0, 10000);
+namespace {
+/// @brief The game state above, copied into snapshots in one piece
+struct GameState {
+    state screen;
+    float gameCountDown;
+    int startTime;
+    bool selected;
+    float countDownStarts;
+    int countDownTime;
+    int lvl;
+    int life;
+    vec4 playerColor;
+    float timeSurvived;
+    bool playerGodMode;
+    bool startGame;
+    bool EE1;
+};
+
+const uint32_t SNAPSHOT_VERSION = 1;
+}
 
-Engine::Engine() : keys() {
-    this->initWindow();
-    this->initShaders();
+Engine::Engine(uint64_t seed, bool headless, int arenaScreens) :
+    arenaScreens(std::max(arenaScreens, 1)),
+    arenaSize(vec2(WIDTH, HEIGHT) * float(this->arenaScreens)),
+    camera(vec2(WIDTH, HEIGHT)),
+    random(seed),
+    levelArena(getLevelArenaSize(LAST_LEVEL, this->arenaScreens)),
+    world(arenaSize) {
+    // Reserve up front so adding entities never reallocates
+    const int maxBubbles = getLevelConfig(LAST_LEVEL, this->arenaScreens).numberOfBubbles;
+    registry.reserve(maxBubbles + CONFETTI_COUNT + MAX_PIXELS + 16);
+    bubbles.reserve(maxBubbles);
+    visibleBubbles.reserve(maxBubbles);
+    expiredConfetti.reserve(CONFETTI_COUNT);
+
+    // Print the seed so the game can be replayed with --seed
+    cout << "Seed: " << seed << endl;
+
+    // Headless games (replays) only run the game logic
+    if (!headless) {
+        this->initWindow();
+        this->initShaders();
+    }
     this->initShapes();
+    if (!headless) {
+        shaderManager->pollCompiles();
+    }
+    this->loadLevel(generateLevel(lvl, arenaSize.x, arenaSize.y, getLevelSeed(lvl), levelArena, this->arenaScreens));
+    // Only now wait for the shaders (they compiled while the font and the first level were loaded)
+    if (!headless) {
+        this->finishShaders();
+    }
 }
 
 Engine::~Engine() {}
@@ -87,36 +132,61 @@ unsigned int Engine::initWindow(bool debug) {
 
     // glad: load all OpenGL function pointers
     if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
-        cout << "Failed to initialize GLAD" << endl;
+        LOG_ERROR("Failed to initialize GLAD");
         return -1;
     }
+#ifdef DODGEBALL_GL_STATS
+    // Count draw calls and GL objects from here on (shown in the F3 overlay)
+    GLStats::install();
+#endif
 
     // OpenGL configuration
     glViewport(0, 0, WIDTH, HEIGHT);
     glEnable(GL_BLEND);
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
     glfwSwapInterval(1);
+    // Full resolution until setRenderScale() says otherwise
+    renderScale = make_unique<RenderScale>(WIDTH, HEIGHT, RenderScaleSettings());
 
     return 0;
 }
 
 void Engine::initShaders() {
+    PROFILE_SCOPE("initShaders");
     // Load shader manager
     shaderManager = make_unique<ShaderManager>();
+    // Let the driver compile on its own threads if it can (looked up here, not every glad build loads the extension)
+    auto maxCompilerThreads = reinterpret_cast<void (APIENTRY *)(GLuint)>(
+        glfwGetProcAddress("glMaxShaderCompilerThreadsKHR"));
+    if (maxCompilerThreads == nullptr) {
+        maxCompilerThreads = reinterpret_cast<void (APIENTRY *)(GLuint)>(
+            glfwGetProcAddress("glMaxShaderCompilerThreadsARB"));
+    }
+    shaderManager->enableParallelCompile(maxCompilerThreads);
+
+    // Sources (each variant is compiled the first time it's asked for)
+    shaderManager->addProgram("circle", "../res/shaders/circle.vert", "../res/shaders/circle.frag");
+    // Rectangles, sprites and text are all variants of one textured/untextured quad
+    shaderManager->addProgram("quad", "../res/shaders/quad.vert", "../res/shaders/quad.frag");
 
     // Bubble / Circle shader
-    shapeShader = this->shaderManager->loadShader("../res/shaders/circle.vert",
-                                                  "../res/shaders/circle.frag",
-                                                  nullptr, "circle");
+    shapeShader = shaderManager->getVariant("circle");
     // Player / Rectangle shader
-    playerShader = this->shaderManager->loadShader("../res/shaders/shape.vert",
-                                              "../res/shaders/shape.frag",
-                                              nullptr, "shape");
-
+    playerShader = shaderManager->getVariant("quad", SHADER_MODEL_MATRIX);
 
     // Configure text shader and renderer
-    textShader = shaderManager->loadShader("../res/shaders/text.vert", "../res/shaders/text.frag", nullptr, "text");
-    fontRenderer = make_unique<FontRenderer>(shaderManager->getShader("text"), "../res/fonts/MxPlus_IBM_BIOS.ttf", 24);
+    textShader = shaderManager->getVariant("quad", SHADER_TEXTURED | SHADER_GLYPH);
+    // The glyphs are rasterized while the driver compiles the shaders above
+    fontRenderer = make_unique<FontRenderer>(textShader, "../res/fonts/MxPlus_IBM_BIOS.ttf", 24);
+    // Log the ones the driver is already done with, while the rest keep compiling
+    shaderManager->pollCompiles();
+
+    renderSystem = make_unique<RenderSystem>(shapeShader, playerShader);
+}
+
+void Engine::finishShaders() {
+    PROFILE_SCOPE("finishShaders");
+    shaderManager->finishCompiles();
 
     // Set uniforms
     textShader.setVector2f("vertex", vec4(100, 100, .5, .5));
@@ -129,272 +199,301 @@ void Engine::initShaders() {
 }
 
 void Engine::initShapes() {
+    PROFILE_SCOPE("initShapes");
 
     // Player (Square/Rect) centered in the middle
-    player = make_unique<Rect>(playerShader, vec2{WIDTH/2,HEIGHT/2}, 20, playerColor);
+    player = createRect(vec2{WIDTH/2,HEIGHT/2}, vec2(PLAYER_SIZE), playerColor, Layer::player);
+    registry.add(player, RectCollider{vec2(PLAYER_SIZE / 2)});
     // --- Player color options (buttons) ---
     //White
-    whitePlayer = make_unique<Rect>(playerShader, vec2{WIDTH/2,HEIGHT/2.4}, vec2{100, 80}, WHITE);
+    whitePlayer = createRect(vec2{WIDTH/2,HEIGHT/2.4}, vec2{100, 80}, WHITE, Layer::button);
     //Red
-    redPlayer = make_unique<Rect>(playerShader, vec2{WIDTH/2.4,HEIGHT/2.4}, vec2{100, 80}, RED);
+    redPlayer = createRect(vec2{WIDTH/2.4,HEIGHT/2.4}, vec2{100, 80}, RED, Layer::button);
     //Blue
-    bluePlayer = make_unique<Rect>(playerShader, vec2{WIDTH/2 + 130,HEIGHT/2.4}, vec2{100, 80}, BLUE);
+    bluePlayer = createRect(vec2{WIDTH/2 + 130,HEIGHT/2.4}, vec2{100, 80}, BLUE, Layer::button);
     //Yellow
-    yellowPlayer = make_unique<Rect>(playerShader, vec2{WIDTH/2.4,HEIGHT/3}, vec2{100, 80}, YELLOW);
+    yellowPlayer = createRect(vec2{WIDTH/2.4,HEIGHT/3}, vec2{100, 80}, YELLOW, Layer::button);
     //Gray
-    grayPlayer = make_unique<Rect>(playerShader, vec2{WIDTH/2,HEIGHT/3}, vec2{100, 80}, GRAY);
+    grayPlayer = createRect(vec2{WIDTH/2,HEIGHT/3}, vec2{100, 80}, GRAY, Layer::button);
     //Purple
-    purplePlayer = make_unique<Rect>(playerShader, vec2{WIDTH/2 + 130,HEIGHT/3}, vec2{100, 80}, PURPLE);
+    purplePlayer = createRect(vec2{WIDTH/2 + 130,HEIGHT/3}, vec2{100, 80}, PURPLE, Layer::button);
 
     // --- Other ---
-    //God Mode
-    godMode = make_unique<Rect>(playerShader, vec2{WIDTH/10, HEIGHT/20.1}, vec2{100, 80}, WHITE);
+    //God Mode (never drawn)
+    godMode = createRect(vec2{WIDTH/10, HEIGHT/20.1}, vec2{100, 80}, WHITE, Layer::hidden);
     // Player Location Placeholder For Viewing
-    playerLocation = make_unique<Rect>(playerShader, vec2{WIDTH/2,HEIGHT/2}, 20, samplePLayerColor);
-
-    // Bubble Stats
-    int numberOfBubbles;
-    float minRadius;
-    float maxRadius;
-    float maxSpeed ;
-    vec4 color;
-
-    // Update Bubble stats based on level
-    // (LVL 1) Small bubbles, slow speed, fewewr spawn in
-    if(lvl == 1) {
-        numberOfBubbles = 75;
-        minRadius = 5;
-        maxRadius = 15;
-        maxSpeed = 35;
-    }
-    // (LVL 2) Bubble size increases, Speed increases, Spawn count increases
-    if(lvl == 2) {
-        //set new level
-        numberOfBubbles = 80;
-        minRadius = 5;
-        maxRadius = 18;
-        maxSpeed = 40;
-    }
-    // (LVL 3) Bubble size increases, Speed increases, Spawn count increases
-    if(lvl == 3) {
-        //Set new level
-        numberOfBubbles = 85;
-        minRadius = 5;
-        maxRadius = 20;
-        maxSpeed = 45;
-    }
-    // (LVL 4) Bubble size increases, Speed increases
-    if(lvl == 4) {
-        //set new level
-        numberOfBubbles = 90;
-        minRadius = 5;
-        maxRadius = 23;
-        maxSpeed = 50;
-    }
-    // (LVL 5) Bubble size increases, Speed increases, Spawn count increases
-    if(lvl == 5) {
-        //set new level
-        numberOfBubbles = 95;
-        minRadius = 5;
-        maxRadius = 25;
-        maxSpeed = 55;
-    }
-
-    //Create Bubbles
-    for (int i = 0; i < numberOfBubbles; ++i) {
-
-        float x = dist(rd) % WIDTH;
-        float y = dist(rd) % HEIGHT;
-        vec2 position = vec2(x, y);
-        float radius = dist(rd) % int(maxRadius - minRadius) + minRadius;
-        vec2 velocity(dist(rd) % int(maxSpeed), dist(rd) % int(maxSpeed));
-
-        // Each Level Has A Unique Color Pallet
-        if(lvl == 1) {
-            // Shades of Green/White
-            color = vec4(0.7f + (dist(rd) % 55) / 255.0f, 0.9f + (dist(rd) % 35) / 255.0f, 0.6f + (dist(rd) % 45) / 255.0f, dist(rd) % 120+135);
-        }
-        if(lvl == 2) {
-            // Shades of Blue/Purple
-            color = vec4(0.3f + (dist(rd) % 100) / 255.0f, (dist(rd) % 40) / 255.0f, 0.6f + (dist(rd) % 155) / 255.0f, dist(rd) % 120+135);
-        }
-        if(lvl == 3) {
-            // Shades of Purple
-            color = vec4(dist(rd) % 40 / 255.0f, dist(rd) % 80 / 255.0f + 0.3f, 0.8f + dist(rd) % 120 / 255.0f, dist(rd) % 120+135);
-        }
-        if(lvl == 4) {
-            // Shades of Yellow/White
-            color = vec4(1.0f, 1.0f, (dist(rd) % 256) / 255.0f, dist(rd) % 120+135);
-        }
-        if(lvl == 5) {
-            // Shades of RED
-            color = vec4(1.0f, 0.2f + dist(rd) % 128 / 255.0f, 0.2f + dist(rd) % 128 / 255.0f, dist(rd) % 120+135);
-        }
-        // Add the bubble to bubbles
-        unique_ptr<Circle> bubble = make_unique<Circle>(shapeShader, position, radius, velocity, color);
-        bubble->setVelocity(velocity);
-        bubbles.push_back(std::move(bubble));
-    }
+    playerLocation = createRect(vec2{WIDTH/2,HEIGHT/2}, vec2{20, 20}, samplePLayerColor, Layer::playerPreview);
 
     // Initialize confetti off screen
-    for (int i = 0; i < 150; ++i) {
-        vec4 colorConfetti = {float(rand() % 10 / 10.0), float(rand() % 10 / 10.0), float(rand() % 10 / 10.0), 1.0f};
-        confeti.push_back(make_unique<Circle>(shapeShader, vec2(rand() % WIDTH, HEIGHT + 2 + (rand() % HEIGHT)),
-                                           (rand() % 5 / 5.0) + 1, colorConfetti));
+    for (int i = 0; i < CONFETTI_COUNT; ++i) {
+        spawnConfetti(2 + random.nextInt(HEIGHT));
     }
 
 }
 
-void Engine::processInput() {
-    glfwPollEvents();
+Entity Engine::createRect(vec2 pos, vec2 size, color c, Layer layer) {
+    Entity entity = registry.create();
+    registry.add(entity, Transform{pos, size});
+    registry.add(entity, Renderable{c.vec, Mesh::rect, layer});
+    return entity;
+}
+
+void Engine::spawnConfetti(float y) {
+    float radius = random.nextInt(5) / 5.0f + 1;
+    vec4 colorConfetti = {random.nextInt(10) / 10.0f, random.nextInt(10) / 10.0f, random.nextInt(10) / 10.0f, 1.0f};
+    // Falls its own diameter every 5 frames (at 60 FPS), and is replaced once it is below the screen
+    float speed = radius * 2 / 5.0f * 60;
+    Entity confetti = registry.create();
+    registry.add(confetti, Transform{vec2(random.nextInt(WIDTH), HEIGHT + y), vec2(radius * 2)});
+    registry.add(confetti, Velocity{vec2(0, -speed)});
+    registry.add(confetti, Renderable{colorConfetti, Mesh::circle, Layer::confetti});
+    registry.add(confetti, Lifetime{(HEIGHT + y) / speed});
+}
+
+void Engine::setColor(Entity entity, color c) {
+    registry.get<Renderable>(entity).color = c.vec;
+}
+
+bool Engine::isMouseOver(Entity entity) const {
+    return containsPoint(registry.get<Transform>(entity), vec2(mouseX, mouseY));
+}
 
-    // Set keys to true if pressed, false if released
-    for (int key = 0; key < 1024; ++key) {
-        if (glfwGetKey(window, key) == GLFW_PRESS)
-            keys[key] = true;
-        else if (glfwGetKey(window, key) == GLFW_RELEASE)
-            keys[key] = false;
+void Engine::loadLevel(const LevelSpawns &spawns) {
+    PROFILE_SCOPE("loadLevel");
+    // Put the player back in the middle of the arena
+    registry.get<Transform>(player).position = arenaSize / 2.0f;
+    setColor(player, playerColor);
+
+    // Replace the previous level's bubbles (their indices are reused, so the registry doesn't grow)
+    for (Entity bubble : bubbles) {
+        registry.destroy(bubble);
+    }
+    bubbles.clear();
+    for (int i = 0; i < spawns.count; ++i) {
+        bubbles.push_back(spawnBubble(registry, spawns.bubbles[i]));
+    }
+    world.load(registry);
+    hazards.reset();
+
+    // The spawn data has been copied into the bubbles, so the whole level's memory is freed at once
+    levelArena.reset();
+
+    // Start generating the level after this one while this one is being played
+    prepareNextLevel();
+}
+
+void Engine::prepareNextLevel() {
+    if (lvl < LAST_LEVEL) {
+        nextLevel = std::async(std::launch::async, generateLevel, lvl + 1, arenaSize.x, arenaSize.y, getLevelSeed(lvl + 1),
+                               std::ref(levelArena), arenaScreens);
     }
+}
+
+uint64_t Engine::getLevelSeed(int level) const {
+    return Random::mix(random.getSeed(), level);
+}
+
+vec3 Engine::getFlashColor() const {
+    // Same color for the whole second, then a new one
+    Random flash(Random::mix(random.getSeed(), static_cast<uint64_t>(input.getSeconds())));
+    return {flash.nextInt(10) / 10.0f, flash.nextInt(10) / 10.0f, flash.nextInt(10) / 10.0f};
+}
+
+InputFrame Engine::pollInput() {
+    PROFILE_SCOPE("pollInput");
+    glfwPollEvents();
 
     // Close window if escape key is pressed
     if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS) {
         glfwSetWindowShouldClose(window, true);
     }
 
+    // Debug keys (not part of the game, so not recorded)
+#ifdef DODGEBALL_PROFILER
+    // F3 toggles the profiler overlay
+    bool profilerKey = glfwGetKey(window, GLFW_KEY_F3) == GLFW_PRESS;
+    if (profilerKey && !profilerKeyLastFrame) {
+        showProfiler = !showProfiler;
+    }
+    profilerKeyLastFrame = profilerKey;
+
+    // F4 captures the next few seconds as a Chrome trace
+    bool traceKey = glfwGetKey(window, GLFW_KEY_F4) == GLFW_PRESS;
+    if (traceKey && !traceKeyLastFrame && !Profiler::get().isCapturing()) {
+        Profiler::get().startCapture(TRACE_FRAMES, "trace.json");
+    }
+    traceKeyLastFrame = traceKey;
+#endif
+
+    // F5 prints the frame time percentiles so far
+    bool reportKey = glfwGetKey(window, GLFW_KEY_F5) == GLFW_PRESS;
+    if (reportKey && !reportKeyLastFrame) {
+        reportFrameTimes(cout);
+    }
+    reportKeyLastFrame = reportKey;
+
+    // Everything the game reads this tick
+    static const struct { int key; InputButton button; } BINDINGS[] = {
+        {GLFW_KEY_UP, BUTTON_UP}, {GLFW_KEY_DOWN, BUTTON_DOWN}, {GLFW_KEY_LEFT, BUTTON_LEFT}, {GLFW_KEY_RIGHT, BUTTON_RIGHT},
+        {GLFW_KEY_SPACE, BUTTON_SPACE}, {GLFW_KEY_C, BUTTON_C}, {GLFW_KEY_S, BUTTON_S}, {GLFW_KEY_R, BUTTON_R},
+        {GLFW_KEY_W, BUTTON_W}, {GLFW_KEY_B, BUTTON_B}, {GLFW_KEY_Y, BUTTON_Y}, {GLFW_KEY_G, BUTTON_G},
+        {GLFW_KEY_P, BUTTON_P}, {GLFW_KEY_E, BUTTON_E},
+    };
+    InputFrame frame;
+    frame.time = static_cast<uint64_t>(glfwGetTime() * 1000000.0);
+    for (const auto &binding : BINDINGS) {
+        if (glfwGetKey(window, binding.key) == GLFW_PRESS) {
+            frame.buttons |= binding.button;
+        }
+    }
+    if (glfwGetMouseButton(window, GLFW_MOUSE_BUTTON_LEFT) == GLFW_PRESS) {
+        frame.buttons |= BUTTON_MOUSE;
+    }
+    double cursorX, cursorY;
+    glfwGetCursorPos(window, &cursorX, &cursorY);
+    frame.mouseX = static_cast<int16_t>(cursorX);
+    frame.mouseY = static_cast<int16_t>(HEIGHT - cursorY); // Invert y-axis of mouse position
+    return frame;
+}
+
+void Engine::processInput(const InputFrame &frame) {
+    PROFILE_SCOPE("processInput");
+    input = frame;
+
     // Mouse position saved to check for collisions
-    glfwGetCursorPos(window, &mouseX, &mouseY);
+    mouseX = frame.mouseX;
+    mouseY = frame.mouseY;
 
     // When player presses "C" redirect them to player selection (When at start screen)
     if (screen == start) {
-        if (keys[GLFW_KEY_C]) {
+        if (input.isDown(BUTTON_C)) {
             screen = selection;
         }
     }
 
-    mouseY = HEIGHT - mouseY; // Invert y-axis of mouse position
     // --- Button / Mouse Interaction (Colored Button Options) ---
-    bool whiteButtonOverlapsMouse = whitePlayer->isMouseOverlaping(vec2(mouseX, mouseY));   // WHITE
-    bool redButtonOverlapsMouse = redPlayer->isMouseOverlaping(vec2(mouseX, mouseY));       // RED
-    bool blueButtonOverlapsMouse = bluePlayer->isMouseOverlaping(vec2(mouseX, mouseY));     // BLUE
-    bool yellowButtonOverlapsMouse = yellowPlayer->isMouseOverlaping(vec2(mouseX, mouseY)); // YELLOW
-    bool grayButtonOverlapsMouse = grayPlayer->isMouseOverlaping(vec2(mouseX, mouseY));     // GRAY
-    bool purpleButtonOverlapsMouse = purplePlayer->isMouseOverlaping(vec2(mouseX, mouseY)); // PURPLE
-    bool mousePressed = glfwGetMouseButton(window, GLFW_MOUSE_BUTTON_LEFT) == GLFW_PRESS;
+    bool whiteButtonOverlapsMouse = isMouseOver(whitePlayer);   // WHITE
+    bool redButtonOverlapsMouse = isMouseOver(redPlayer);       // RED
+    bool blueButtonOverlapsMouse = isMouseOver(bluePlayer);     // BLUE
+    bool yellowButtonOverlapsMouse = isMouseOver(yellowPlayer); // YELLOW
+    bool grayButtonOverlapsMouse = isMouseOver(grayPlayer);     // GRAY
+    bool purpleButtonOverlapsMouse = isMouseOver(purplePlayer); // PURPLE
+    bool mousePressed = input.isDown(BUTTON_MOUSE);
 
     // When player selects character, start game after they clicked the color they want to use (When at selection screen)
     if(screen == selection) {
         if (!selected) {
             // --- Button / Mouse Interaction (Mouse hovers over button / No click) ---
             if(redButtonOverlapsMouse) {               // RED
-                redPlayer->setColor(redHoverFill);
-                playerLocation->setColor(RED);
+                setColor(redPlayer, redHoverFill);
+                setColor(playerLocation, RED);
             }
             else {
-                redPlayer->setColor(RED);
+                setColor(redPlayer, RED);
             }
             if(whiteButtonOverlapsMouse) {            // WHITE
-                whitePlayer->setColor(whiteHoverFill);
-                playerLocation->setColor(WHITE);
+                setColor(whitePlayer, whiteHoverFill);
+                setColor(playerLocation, WHITE);
             }
             else {
-                whitePlayer->setColor(WHITE);
+                setColor(whitePlayer, WHITE);
             }
             if(blueButtonOverlapsMouse) {            // BLUE
-                bluePlayer->setColor(blueHoverFill);
-                playerLocation->setColor(BLUE);
+                setColor(bluePlayer, blueHoverFill);
+                setColor(playerLocation, BLUE);
             }
             else {
-                bluePlayer->setColor(BLUE);
+                setColor(bluePlayer, BLUE);
             }
             if(yellowButtonOverlapsMouse) {         // YELLOW
-                yellowPlayer->setColor(yellowHoverFill);
-                playerLocation->setColor(YELLOW);
+                setColor(yellowPlayer, yellowHoverFill);
+                setColor(playerLocation, YELLOW);
             }
             else {
-                yellowPlayer->setColor(YELLOW);
+                setColor(yellowPlayer, YELLOW);
             }
             if(grayButtonOverlapsMouse) {           // GRAY
-                grayPlayer->setColor(grayHoverFill);
-                playerLocation->setColor(GRAY);
+                setColor(grayPlayer, grayHoverFill);
+                setColor(playerLocation, GRAY);
             }
             else {
-                grayPlayer->setColor(GRAY);
+                setColor(grayPlayer, GRAY);
             }
             if(purpleButtonOverlapsMouse) {        // PURPLE
-                purplePlayer->setColor(purpleHoverFill);
-                playerLocation->setColor(PURPLE);
+                setColor(purplePlayer, purpleHoverFill);
+                setColor(playerLocation, PURPLE);
             }
             else {
-                purplePlayer->setColor(PURPLE);
+                setColor(purplePlayer, PURPLE);
             }
         }
 
         // --- Button / Mouse interaction (Mouse Click) ---
-        if((redButtonOverlapsMouse && mousePressedLastFrame == GLFW_PRESS && mousePressed != GLFW_PRESS) || keys[GLFW_KEY_R]) { // RED
-            player->setColor(RED);
-            playerLocation->setColor(RED);
+        if((redButtonOverlapsMouse && mousePressedLastFrame == GLFW_PRESS && mousePressed != GLFW_PRESS) || input.isDown(BUTTON_R)) { // RED
+            setColor(player, RED);
+            setColor(playerLocation, RED);
             playerColor = RED;
             selected = true;
             startGame = true;
-            gameCountDown = glfwGetTime();
+            gameCountDown = input.getSeconds();
         }
-        if((whiteButtonOverlapsMouse && mousePressedLastFrame == GLFW_PRESS && mousePressed != GLFW_PRESS) || keys[GLFW_KEY_W]) { // WHITE
-            player->setColor(WHITE);
-            playerLocation->setColor(WHITE);
+        if((whiteButtonOverlapsMouse && mousePressedLastFrame == GLFW_PRESS && mousePressed != GLFW_PRESS) || input.isDown(BUTTON_W)) { // WHITE
+            setColor(player, WHITE);
+            setColor(playerLocation, WHITE);
             playerColor = WHITE;
             selected = true;
             startGame = true;
-            gameCountDown = glfwGetTime();
+            gameCountDown = input.getSeconds();
         }
-        if((blueButtonOverlapsMouse && mousePressedLastFrame == GLFW_PRESS && mousePressed != GLFW_PRESS) || keys[GLFW_KEY_B]) { // BLUE
-            player->setColor(BLUE);
-            playerLocation->setColor(BLUE);
+        if((blueButtonOverlapsMouse && mousePressedLastFrame == GLFW_PRESS && mousePressed != GLFW_PRESS) || input.isDown(BUTTON_B)) { // BLUE
+            setColor(player, BLUE);
+            setColor(playerLocation, BLUE);
             playerColor = BLUE;
             selected = true;
             startGame = true;
-            gameCountDown = glfwGetTime();
+            gameCountDown = input.getSeconds();
         }
-        if((yellowButtonOverlapsMouse && mousePressedLastFrame == GLFW_PRESS && mousePressed != GLFW_PRESS) || keys[GLFW_KEY_Y]) { // YELLOW
-            player->setColor(YELLOW);
-            playerLocation->setColor(YELLOW);
+        if((yellowButtonOverlapsMouse && mousePressedLastFrame == GLFW_PRESS && mousePressed != GLFW_PRESS) || input.isDown(BUTTON_Y)) { // YELLOW
+            setColor(player, YELLOW);
+            setColor(playerLocation, YELLOW);
             playerColor = YELLOW;
             selected = true;
             startGame = true;
-            gameCountDown = glfwGetTime();
+            gameCountDown = input.getSeconds();
         }
-        if((grayButtonOverlapsMouse && mousePressedLastFrame == GLFW_PRESS && mousePressed != GLFW_PRESS) || keys[GLFW_KEY_G]) { // GRAY
-            player->setColor(GRAY);
-            playerLocation->setColor(GRAY);
+        if((grayButtonOverlapsMouse && mousePressedLastFrame == GLFW_PRESS && mousePressed != GLFW_PRESS) || input.isDown(BUTTON_G)) { // GRAY
+            setColor(player, GRAY);
+            setColor(playerLocation, GRAY);
             playerColor = GRAY;
             selected = true;
             startGame = true;
-            gameCountDown = glfwGetTime();
+            gameCountDown = input.getSeconds();
         }
-        if((purpleButtonOverlapsMouse && mousePressedLastFrame == GLFW_PRESS && mousePressed != GLFW_PRESS) || keys[GLFW_KEY_P]) { // PURPLE
-            player->setColor(PURPLE);
-            playerLocation->setColor(PURPLE);
+        if((purpleButtonOverlapsMouse && mousePressedLastFrame == GLFW_PRESS && mousePressed != GLFW_PRESS) || input.isDown(BUTTON_P)) { // PURPLE
+            setColor(player, PURPLE);
+            setColor(playerLocation, PURPLE);
             playerColor = PURPLE;
             selected = true;
             startGame = true;
-            gameCountDown = glfwGetTime();
+            gameCountDown = input.getSeconds();
         }
         // -- EASTER EGG 1 --
         //Player color is set to rainbow
-        if(keys[GLFW_KEY_E]) {
+        if(input.isDown(BUTTON_E)) {
             EE1 = true;
             startGame = true;
-            gameCountDown = glfwGetTime();
+            gameCountDown = input.getSeconds();
         }
 
         //Save mousePressed for next frame
         mousePressedLastFrame = mousePressed;
 
         //Starting the countdown timer for the level
-        countDownStarts = glfwGetTime();
+        countDownStarts = input.getSeconds();
     }
 
     // Hidden God Mode button which makes player invincible to the bubbles when clicked, can be turned off when clicked again (Button is located by player life count
-    bool godModeButtonOverlapsMouse = godMode->isMouseOverlaping(vec2(mouseX, mouseY)); // PURPLE
+    bool godModeButtonOverlapsMouse = isMouseOver(godMode); // PURPLE
     if(screen == play) {
         //Turning God Mode on/off
         if(godModeButtonOverlapsMouse && mousePressedLastFrame == GLFW_RELEASE && mousePressed == GLFW_PRESS) {
@@ -407,9 +506,9 @@ void Engine::processInput() {
 
     // User starts game with "S" (only if user has not lost the game)
     if(screen != over && screen != selection && screen != start && screen != lost) {
-        if(keys[GLFW_KEY_S]) {
+        if(input.isDown(BUTTON_S)) {
             //User starts level
-            gameCountDown = glfwGetTime();
+            gameCountDown = input.getSeconds();
             startGame = true;
             //screen = play;
         }
@@ -417,10 +516,17 @@ void Engine::processInput() {
 
     // When player loses level and tries again check if they have 3 lives left
     if (screen == lost) {
-        if(keys[GLFW_KEY_S] && life != 0) {
+        if(input.isDown(BUTTON_S) && life != 0) {
+            // Retry the level from the start (same bubbles), keeping the lives that are left
+            if (!checkpoint.empty()) {
+                int livesLeft = life;
+                restoreSnapshot(checkpoint);
+                life = livesLeft;
+                lastFrame = input.getSeconds();
+            }
             screen = play;
             //Starting the countdown timer for the level
-            countDownStarts = glfwGetTime();
+            countDownStarts = input.getSeconds();
         }
         else if(life == 0){
             // Get the losing pixel art from the scene.txt file
@@ -432,87 +538,35 @@ void Engine::processInput() {
 
     //If user is playing the game -> allow for player movement
     if(screen == play) {
-        //Player is moved by the arrow keys
-        if (glfwGetKey(window, GLFW_KEY_UP) == GLFW_PRESS) {
-            if (player->getPosY() + player->getSize().y / 2 < HEIGHT) {
-                player->moveY(1.1f);
-            }
-        }
-        if (glfwGetKey(window, GLFW_KEY_DOWN) == GLFW_PRESS) {
-            if (player->getPosY() - player->getSize().y / 2 > 0) {
-                player->moveY(-1.1f);
-            }
-        }
-        if (glfwGetKey(window, GLFW_KEY_LEFT) == GLFW_PRESS) {
-            if (player->getPosX() - player->getSize().x / 2 > 0) {
-                player->moveX(-1.1f);
-            }
-        }
-        if (glfwGetKey(window, GLFW_KEY_RIGHT) == GLFW_PRESS) {
-            if (player->getPosX() + player->getSize().x / 2 < WIDTH) {
-                player->moveX(1.1f);
-            }
-        }
-
-        //Space bar gives player a boost
-        if (glfwGetKey(window, GLFW_KEY_SPACE) == GLFW_PRESS) {
-            if (glfwGetKey(window, GLFW_KEY_UP) == GLFW_PRESS) {
-                if (player->getPosY() + player->getSize().y / 2 < HEIGHT) {
-                    player->moveY(1.3f);
-                }
-            }
-            if (glfwGetKey(window, GLFW_KEY_DOWN) == GLFW_PRESS) {
-                if (player->getPosY() - player->getSize().y / 2 > 0) {
-                    player->moveY(-1.3f);
-                }
-            }
-            if (glfwGetKey(window, GLFW_KEY_LEFT) == GLFW_PRESS) {
-                if (player->getPosX() - player->getSize().x / 2 > 0) {
-                    player->moveX(-1.3f);
-                }
-            }
-            if (glfwGetKey(window, GLFW_KEY_RIGHT) == GLFW_PRESS) {
-                if (player->getPosX() + player->getSize().x / 2 < WIDTH) {
-                    player->moveX(1.3f);
-                }
-            }
-        }
+        //Player is moved by the arrow keys (space bar gives player a boost)
+        Transform &playerTransform = registry.get<Transform>(player);
+        movePlayer(playerTransform.position, playerTransform.size, input.buttons, arenaSize);
     }
 }
 
 
-void Engine::checkBounds(unique_ptr<Circle> &bubble) const {
-    vec2 position = bubble->getPos();
-    vec2 velocity = bubble->getVelocity();
-    float bubbleRadius = bubble->getRadius();
-
-    position += velocity * deltaTime;
-
-    // If any bubble hits the edges of the screen, bounce it in the other direction
-    if (position.x - bubbleRadius <= 0) {
-        position.x = bubbleRadius;
-        velocity.x = -velocity.x;
-    }
-    if (position.x + bubbleRadius >= WIDTH) {
-        position.x = WIDTH - bubbleRadius;
-        velocity.x = -velocity.x;
-    }
-    if (position.y - bubbleRadius <= 0) {
-        position.y = bubbleRadius;
-        velocity.y = -velocity.y;
-    }
-    if (position.y + bubbleRadius >= HEIGHT) {
-        position.y = HEIGHT - bubbleRadius;
-        velocity.y = -velocity.y;
-    }
-
-    bubble->setPos(position);
-    bubble->setVelocity(velocity);
+namespace {
+uint64_t microsecondsBetween(std::chrono::steady_clock::time_point from, std::chrono::steady_clock::time_point to) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(to - from).count();
+}
 }
 
 void Engine::update() {
+    PROFILE_SCOPE("update");
+    // Frame time = time between the start of two updates
+    auto updateStart = std::chrono::steady_clock::now();
+    ScreenTimes &times = screenTimes[screen];
+    if (lastUpdateStart != std::chrono::steady_clock::time_point()) {
+        uint64_t frameTime = microsecondsBetween(lastUpdateStart, updateStart);
+        times.frame.record(frameTime);
+        if (frameTime > FRAME_BUDGET) {
+            times.framesOverBudget++;
+        }
+    }
+    lastUpdateStart = updateStart;
+
     // Calculate delta time
-    float currentFrame = glfwGetTime();
+    float currentFrame = input.getSeconds();
     deltaTime = currentFrame - lastFrame;
     lastFrame = currentFrame;
 
@@ -524,74 +578,158 @@ void Engine::update() {
     if(screen == play) {
 
         // Countdown timer (for level)
-        timePassed = glfwGetTime() - countDownStarts;
+        timePassed = input.getSeconds() - countDownStarts;
         if(timePassed >= countDownTime) {
             lvl++;
-            if(lvl > 5) {
+            if(lvl > LAST_LEVEL) {
                 // Get the winning pixel art from the scene2.txt file
                 readFromFile(R"(C:\Users\crcar\CLionProjects\Dodge-Ball-Survival\res\art\scene2.txt)");
                 screen = win;
             }
             else {
-                bubbles.clear();
                 startGame = false;
                 startTime = 4;
                 screen = lvlUP;
-                initShapes();
-                countDownTime = 20;
-                countDownStarts = glfwGetTime();
+                // The next level was generated in the background while this one was played
+                loadLevel(nextLevel.get());
+                countDownTime = LEVEL_TIME;
+                countDownStarts = input.getSeconds();
             }
         }
 
+        // The rest of the level must not touch the heap (level changes above are allowed to)
+        ASSERT_NO_ALLOCATIONS("play:update");
+
         // Bubble & Bubble Collision Check
-        // Player & Bubble Collision Check
-        for (unique_ptr<Circle> &bubble: bubbles) {
-            // Prevent bubbles from moving offscreen
-            checkBounds(bubble);
-            // Check for collisions
-            for (unique_ptr<Circle> &other: bubbles) {
-                // Let the player spawn in and have a few seconds before collision check is activated
-                if(timePassed >= 1.5f) {
-                    // Bubble and Player collision = level lost (lose a life)
-                    if(bubble->isOverlapping(*player) && timePassed != 19.5 && playerGodMode != true) {
-                        if(screen == play) {
-                            //subtract users life from that level
-                            life--;
-                            timeSurvived = timePassed;
-                            screen = lost;
-                        }
-                    }
-                }
-                //Bubble collision with other bubbles
-                if (bubble != other && bubble->isOverlapping(*other)) {
-                    bubble->bounce(*other);
-                }
-            }
+        PROFILE_SCOPE("collision");
+        world.step(registry, deltaTime);
+
+        // Player & Bubble Collision Check (only the bubbles near the player are looked at)
+        const Transform &playerTransform = registry.get<Transform>(player);
+        const RectCollider &playerCollider = registry.get<RectCollider>(player);
+        const HazardReport &hazard = hazards.update(world, playerTransform.position - playerCollider.halfSize,
+                                                    playerTransform.position + playerCollider.halfSize);
+        // Let the player spawn in and have a few seconds before collision check is activated
+        // Bubble and Player collision = level lost (lose a life), unless the level just ended above
+        if(timePassed >= SPAWN_GRACE_TIME && hazard.hit.isValid() && playerGodMode != true && screen == play) {
+            //subtract users life from that level
+            life--;
+            timeSurvived = timePassed;
+            screen = lost;
         }
         // --- EASTER EGG 1 ---
         // set users color to rainbow (also used to show when user is in God Mode)
         if(EE1 || playerGodMode == true) {
-            color randomColor = {float(rand() % 10 / 10.0), float(rand() % 10 / 10.0), float(rand() % 10 / 10.0), 1.0f};
-            player->setColor(randomColor);
+            color randomColor = {random.nextInt(10) / 10.0f, random.nextInt(10) / 10.0f, random.nextInt(10) / 10.0f, 1.0f};
+            setColor(player, randomColor);
         }
         //When god mode is turned off turn the player back to selected color
         else {
-            player->setColor(playerColor);
+            setColor(player, playerColor);
         }
     }
     if(screen == win) {
-        for (unique_ptr<Shape> &feti : confeti) {
-            feti->moveY(-feti->getSize().y / 5.0);
-            if (feti->getPosY() < 0) {
-                feti->setPos(vec2(dist(rd) % WIDTH, HEIGHT + feti->getSize().y));
-            }
+        movementSystem(registry, deltaTime);
+        // Confetti that fell off the screen is replaced at the top
+        int fallen = lifetimeSystem(registry, deltaTime, expiredConfetti);
+        for (int i = 0; i < fallen; ++i) {
+            spawnConfetti(2);
+        }
+    }
+
+    // Game Start Countdown is over (after color selection, or before the next level)
+    if ((screen == selection || screen == lvlUP) && startGame && startTime - (input.getSeconds() - gameCountDown) < 0) {
+        if (screen == lvlUP) {
+            //Starting the countdown timer for the level
+            countDownStarts = input.getSeconds();
+        }
+        screen = play;
+        // Losing a life restarts the level from here
+        saveSnapshot(checkpoint);
+    }
+
+    // The camera follows the player around the arena (an arena the size of the screen never scrolls)
+    camera.follow(registry.get<Transform>(player).position, arenaSize);
+
+    times.update.record(microsecondsBetween(updateStart, std::chrono::steady_clock::now()));
+}
+
+void Engine::layoutHud() {
+    PROFILE_SCOPE("layoutHud");
+    hudTextCount = 0;
+    if (screen != play) {
+        return;
+    }
+    // --- EASTER EGG = Process Game Hud with Random Colors ---
+    vec3 textColor = EE1 ? getFlashColor() : vec3{1, 1, 1};
+    char text[32];
+
+    //Get the current level and display it top left corner
+    snprintf(text, sizeof(text), "LVL %d", lvl);
+    addHudText(text, WIDTH/10, HEIGHT/1.1, textColor);
+
+    //Display the countdown timer (Top right corner of the screen)
+    float timeRemaining = countDownTime - (input.getSeconds() - countDownStarts);
+    if (timeRemaining < 0) {
+        timeRemaining = 0;
+    }
+    snprintf(text, sizeof(text), "%ds", static_cast<int>(timeRemaining));
+    addHudText(text, WIDTH/1.06, HEIGHT/1.1, textColor);
+
+    //Get the number of lives the user has left (Bottom right corner of the screen)
+    snprintf(text, sizeof(text), life > 1 ? "%dLIVES" : "%dLIFE", life);
+    addHudText(text, WIDTH/10, HEIGHT/20.1, textColor);
+
+    //Near misses this attempt (Bottom right corner of the screen, red while a bubble is grazing the player)
+    const HazardReport &hazard = hazards.getReport();
+    // Right aligned (glyphs are 24 pixels wide), it's too long to center on the timer above it
+    int length = snprintf(text, sizeof(text), "%d CLOSE CALLS", hazard.nearMisses);
+    addHudText(text, float(WIDTH - WIDTH/20) - 12 * length, HEIGHT/20.1,
+               hazard.nearestGap < NEAR_MISS_GAP && !EE1 ? vec3{1, 0, 0} : textColor);
+}
+
+void Engine::addHudText(const char *text, float centerX, float y, vec3 textColor) {
+    HudText &hud = hudTexts[hudTextCount++];
+    // Assigning reuses the string's memory
+    hud.text = text;
+    hud.x = centerX - 12 * hud.text.length();
+    hud.y = y;
+    hud.color = textColor;
+}
+
+void Engine::prepareDraws() {
+    // Only the bubbles on screen are drawn, the grid finds them without looking at the rest of the arena. A bubble
+    // just off screen can still have its glow (and anti-aliased edge) on it, so the view is grown by the padding.
+    const float padding = renderSystem->getStyle(Layer::bubble).getPadding();
+    const vec2 viewMin = camera.getMin() - vec2(padding);
+    const vec2 viewMax = camera.getMax() + vec2(padding);
+    const vector<Bubble> &worldBubbles = world.getBubbles();
+    const vector<Entity> &worldEntities = world.getBubbleEntities();
+    visibleBubbles.clear();
+    world.forEachIndexInRect(viewMin, viewMax, [&](int index) {
+        const Bubble &bubble = worldBubbles[index];
+        if (camera.isVisible(bubble.position, vec2(bubble.radius + padding))) {
+            visibleBubbles.push_back(worldEntities[index]);
         }
+    });
+    renderSystem->prepare(registry, Layer::bubble, visibleBubbles);
+}
+
+void Engine::setRenderScale(const RenderScaleSettings &settings) {
+    if (window != nullptr) {
+        renderScale = make_unique<RenderScale>(WIDTH, HEIGHT, settings);
     }
 }
 
 void Engine::render() {
+    PROFILE_SCOPE("render");
+    auto renderStart = std::chrono::steady_clock::now();
+    ScreenTimes &times = screenTimes[screen];
+    renderScale->beginFrame();
     glClearColor(BLACK.red, BLACK.green, BLACK.blue, 1.0f);
     glClear(GL_COLOR_BUFFER_BIT);
+    // Text waits until the frame is upscaled, so it's drawn at the window's resolution
+    fontRenderer->setDeferred(renderScale->isScaled() && renderScale->getSettings().nativeText);
 
     shapeShader.use();
 
@@ -599,6 +737,7 @@ void Engine::render() {
     switch(screen) {
         // Welcome Screen
         case start: {
+            PROFILE_SCOPE("render:start");
             //Displaying the goal of the game / controls / how to start
             string title = "* DODGE BALL SURVIVAL *";
             string breaker = "************************";
@@ -623,33 +762,15 @@ void Engine::render() {
         }
         // User gets to pick the color of their player (click on the colored box)
         case selection: {
+            PROFILE_SCOPE("render:selection");
             string description = "PICK YOUR PLAYER COLOR TO START";
             this->fontRenderer->renderText(description, WIDTH/2 - (12 * description.length()), HEIGHT/1.5, projection, 1, vec3{1, 1, 1});
 
             // --- Player Color Selection Buttons ---
-            playerShader.use();
-            // White
-            whitePlayer->setUniforms();
-            whitePlayer->draw();
-            // Red
-            redPlayer->setUniforms();
-            redPlayer->draw();
-            // Blue
-            bluePlayer->setUniforms();
-            bluePlayer->draw();
-            // Yellow
-            yellowPlayer->setUniforms();
-            yellowPlayer->draw();
-            // Gray
-            grayPlayer->setUniforms();
-            grayPlayer->draw();
-            // Purple
-            purplePlayer->setUniforms();
-            purplePlayer->draw();
+            renderSystem->draw(Layer::button);
 
             // Sample Player Model
-            playerLocation->setUniforms();
-            playerLocation->draw();
+            renderSystem->draw(Layer::playerPreview);
 
             // Player Color Selection Button Text
             string white = "W";
@@ -674,13 +795,12 @@ void Engine::render() {
             float timePassed;
             if (startGame) {
                 // Countdown timer
-                timePassed = glfwGetTime() - gameCountDown;
+                timePassed = input.getSeconds() - gameCountDown;
                 //Display the countdown timer (Top right corner of the screen)
-                float timeRemaining = startTime - (glfwGetTime() - gameCountDown);
+                float timeRemaining = startTime - (input.getSeconds() - gameCountDown);
 
                 if (timeRemaining < 0) {
                     timeRemaining = 0;
-                    screen = play;
                 }
                 string gameStart = "GAME STARTS IN: ";
                 this->fontRenderer->renderText(gameStart, WIDTH/2.13 - (12 * gameStart.length()), HEIGHT/1.8, projection, 1, vec3{1, 1, 1});
@@ -691,81 +811,28 @@ void Engine::render() {
         }
         // Game screen
         case play: {
+            PROFILE_SCOPE("render:play");
+            ASSERT_NO_ALLOCATIONS("play:render");
+            // The player and the bubbles are in the arena, seen through the camera
+            renderSystem->setProjection(camera.getProjection());
             //Spawn player
-            playerShader.use();
-            player->setUniforms();
-            player->draw();
+            renderSystem->draw(Layer::player);
 
             //spawn bubbles
-            shapeShader.use();
-            for (unique_ptr<Circle>& bubble : bubbles) {
-                bubble->setUniforms();
-                bubble->draw();
-            }
-
-            // --- EASTER EGG = Process Game Hud with Random Colors ---
-            if(EE1 == true) {
-                // Seed the random number generator
-                srand(static_cast<unsigned int>(time(0)));
-                // Get the random color
-                glm::vec3 randomColor = {float(rand() % 10) / 10.0f, float(rand() % 10) / 10.0f, float(rand() % 10) / 10.0f};
-
-                //Get the current level and display it top left corner
-                string currentLevel = "LVL " + std::to_string(lvl);
-                this->fontRenderer->renderText(currentLevel, WIDTH/10 - (12 * currentLevel.length()), HEIGHT/1.1, projection, 1, randomColor);
-
-                //Display the countdown timer (Top right corner of the screen)
-                float timeRemaining = countDownTime - (glfwGetTime() - countDownStarts);
-                if (timeRemaining < 0) {
-                    timeRemaining = 0;
-                }
-                string timer = std::to_string(static_cast<int>(timeRemaining)) + "s";
-                this->fontRenderer->renderText(timer, WIDTH/1.06 - (12 * timer.length()), HEIGHT/1.1, projection, 1, randomColor);
+            renderSystem->draw(Layer::bubble);
+            renderSystem->setProjection(PROJECTION);
 
-                //Get the number of lives the user has left (Bottom right corner of the screen)
-                string livesLeft;
-                if(life > 1) {
-                    livesLeft = std::to_string(life) + "LIVES";
-                }
-                else {
-                    livesLeft = std::to_string(life) + "LIFE";
-                }
-                this->fontRenderer->renderText(livesLeft, WIDTH/10 - (12 * livesLeft.length()), HEIGHT/20.1, projection, 1, randomColor);
-            }
-            // --- Process Game Hud as Default Settings (WHITE) ---
-            else {
-                //Get the current level and display it top left corner
-                string currentLevel = "LVL " + std::to_string(lvl);
-                this->fontRenderer->renderText(currentLevel, WIDTH/10 - (12 * currentLevel.length()), HEIGHT/1.1, projection, 1, vec3{1, 1, 1});
-
-                //Display the countdown timer (Top right corner of the screen)
-                float timeRemaining = countDownTime - (glfwGetTime() - countDownStarts);
-                if (timeRemaining < 0) {
-                    timeRemaining = 0;
-                }
-                string timer = std::to_string(static_cast<int>(timeRemaining)) + "s";
-                this->fontRenderer->renderText(timer, WIDTH/1.06 - (12 * timer.length()), HEIGHT/1.1, projection, 1, vec3{1, 1, 1});
-
-                //Get the number of lives the user has left (Bottom right corner of the screen)
-                string livesLeft;
-                if(life > 1) {
-                    livesLeft = std::to_string(life) + "LIVES";
-                }
-                else {
-                    livesLeft = std::to_string(life) + "LIFE";
-                }
-                this->fontRenderer->renderText(livesLeft, WIDTH/10 - (12 * livesLeft.length()), HEIGHT/20.1, projection, 1, vec3{1, 1, 1});
-
-                // Hidden God Mode button (user takes no damage)
-                godMode->setOpacity(0);
-                playerShader.use();
-                godMode->setUniforms();
-                godMode->draw();
+            // Game HUD (laid out by layoutHud())
+            for (int i = 0; i < hudTextCount; ++i) {
+                const HudText &hud = hudTexts[i];
+                this->fontRenderer->renderText(hud.text, hud.x, hud.y, projection, 1, hud.color);
             }
+            // Hidden God Mode button (user takes no damage) is under the lives text and never drawn
             break;
         }
         // Level Up Pause Screen
         case lvlUP: {
+            PROFILE_SCOPE("render:lvlUP");
             //Display next level
             string description = "YOU SURVIVED THAT ROUND!";
             string levelReached = "NEXT LEVEL IS " + std::to_string(lvl);
@@ -779,23 +846,20 @@ void Engine::render() {
             this->fontRenderer->renderText(message3, WIDTH/2 - (12 * message3.length()), HEIGHT/6, projection, 1, vec3{1, 1, 1});
 
             //Drawing Player So They Can See Where They Spawn In
-            playerShader.use();
-            player->setUniforms();
-            player->draw();
+            renderSystem->setProjection(camera.getProjection());
+            renderSystem->draw(Layer::player);
+            renderSystem->setProjection(PROJECTION);
 
             // Game Start Countdown (after color selection give a 3second countdown before starting the game so the player can get prepared)
             float timePassed;
             if (startGame) {
                 // Countdown timer
-                timePassed = glfwGetTime() - gameCountDown;
+                timePassed = input.getSeconds() - gameCountDown;
                 //Display the countdown timer (Top right corner of the screen)
-                float timeRemaining = startTime - (glfwGetTime() - gameCountDown);
+                float timeRemaining = startTime - (input.getSeconds() - gameCountDown);
 
                 if (timeRemaining < 0) {
                     timeRemaining = 0;
-                    //Starting the countdown timer for the level
-                    countDownStarts = glfwGetTime();
-                    screen = play;
                 }
                 string gameStart = "NEXT LVL STARTS IN: ";
                 this->fontRenderer->renderText(gameStart, WIDTH/2.13 - (12 * gameStart.length()), HEIGHT/1.8, projection, 1, vec3{1, 1, 1});
@@ -806,6 +870,7 @@ void Engine::render() {
             break;
         }
         case lost:{
+            PROFILE_SCOPE("render:lost");
             //Displaying level Over message (telling the player what level they made it to and how many lives they have left)
             string description = "YOU DIED";
             string levelReached = "YOU REACHED LEVEL " + std::to_string(lvl);
@@ -821,6 +886,7 @@ void Engine::render() {
         }
         // Game Over Screen (Player Loses)
         case over: {
+            PROFILE_SCOPE("render:over");
             //Displaying Game over message (telling the player what level they made it to)
             string description = "GAME OVER YOU LOST";
             string levelReached = "YOU REACHED LEVEL " + std::to_string(lvl);
@@ -830,46 +896,159 @@ void Engine::render() {
             this->fontRenderer->renderText(message, WIDTH/2 - (12 * message.length()), HEIGHT/6, projection, 1, vec3{1, 1, 1});
 
             // Game Over Pixel Art (scene.txt)
-            playerShader.use();
-            for (unique_ptr<Shape> &square : squares) {
-                square->setUniforms();
-                square->draw();
-            }
+            renderSystem->draw(Layer::pixelArt);
 
             break;
         }
         // Winning Screen
         case win: {
-            for (auto &c : confeti) {
-                c->setUniforms();
-                c->draw();
-            }
-            // Seed the random number generator
-            srand(static_cast<unsigned int>(time(0)));
+            PROFILE_SCOPE("render:win");
+            renderSystem->draw(Layer::confetti);
             // Get the random color
-            glm::vec3 randomColor = {float(rand() % 10) / 10.0f, float(rand() % 10) / 10.0f, float(rand() % 10) / 10.0f};
+            glm::vec3 randomColor = getFlashColor();
             string description = "YOU WON";
             string levelReached = "YOU BEAT LEVEL 5";
             this->fontRenderer->renderText(description, WIDTH/2 - (12 * description.length()), HEIGHT/1.25, projection, 1, randomColor);
             this->fontRenderer->renderText(levelReached, WIDTH/2 - (12 * levelReached.length()), HEIGHT/1.4, projection, 1, randomColor);
 
             // Pixel Art
-            playerShader.use();
-            for (unique_ptr<Shape> &square : squares) {
-                square->setUniforms();
-                square->draw();
-            }
+            renderSystem->draw(Layer::pixelArt);
             break;
         }
     }
+
+#ifdef DODGEBALL_PROFILER
+    if (showProfiler) {
+        renderProfiler();
+    }
+#endif
+    renderScale->present();
+    fontRenderer->flush();
+    // Catches errors from text and anything else drawn outside the render system
+    glCheckError();
+    renderScale->endFrame();
+
+    // Render time is the CPU side only (swapping waits for vsync, which shows up in the frame time)
+    times.render.record(microsecondsBetween(renderStart, std::chrono::steady_clock::now()));
+
+    PROFILE_SCOPE("swap");
     glfwSwapBuffers(window);
 }
 
+void Engine::reportFrameTimes(std::ostream &out) const {
+    char line[128];
+    snprintf(line, sizeof(line), "%-17s %8s %7s %7s %7s %7s %7s  %s", "Frame times (ms)", "count", "p50", "p90", "p99",
+             "p99.9", "max", "over 16.6ms");
+    out << line << endl;
+    for (int i = 0; i < SCREEN_COUNT; ++i) {
+        const ScreenTimes &times = screenTimes[i];
+        if (times.frame.getCount() == 0) {
+            continue;
+        }
+        const char *phaseNames[] = {"frame", "update", "render"};
+        const Histogram *phases[] = {&times.frame, &times.update, &times.render};
+        for (int phase = 0; phase < 3; ++phase) {
+            const Histogram &histogram = *phases[phase];
+            snprintf(line, sizeof(line), "%-10s %-6s %8llu %7.2f %7.2f %7.2f %7.2f %7.2f",
+                     phase == 0 ? screenNames[i] : "", phaseNames[phase], static_cast<unsigned long long>(histogram.getCount()),
+                     histogram.getPercentile(50) / 1000.0, histogram.getPercentile(90) / 1000.0,
+                     histogram.getPercentile(99) / 1000.0, histogram.getPercentile(99.9) / 1000.0, histogram.getMax() / 1000.0);
+            out << line;
+            if (phase == 0) {
+                snprintf(line, sizeof(line), "  %llu (%.1f%%)", static_cast<unsigned long long>(times.framesOverBudget),
+                         100.0 * times.framesOverBudget / times.frame.getCount());
+                out << line;
+            }
+            out << endl;
+        }
+    }
+    if (frameGraph != nullptr) {
+        frameGraph->report(out);
+    }
+}
+
+#ifdef DODGEBALL_PROFILER
+void Engine::renderProfiler() {
+    const float scale = 0.6f;
+    const float lineHeight = 18;
+    float y = HEIGHT - 30;
+    char line[96];
+
+    this->fontRenderer->renderText("SCOPE (ms)        AVG    P95    MAX ALLOCS", 10, y, projection, scale, vec3{1, 1, 0});
+    for (const ScopeStats &scope : Profiler::get().getStats()) {
+        y -= lineHeight;
+        snprintf(line, sizeof(line), "%-14.14s %6.2f %6.2f %6.2f %6llu", scope.name, scope.average, scope.p95, scope.max,
+                 static_cast<unsigned long long>(scope.allocations));
+        this->fontRenderer->renderText(line, 10, y, projection, scale, vec3{1, 1, 0});
+    }
+#ifdef DODGEBALL_ALLOCATION_TRACKING
+    AllocationCounts frameAllocations = AllocationTracker::getLastFrame();
+    y -= lineHeight;
+    snprintf(line, sizeof(line), "FRAME ALLOCS: %llu (%llu BYTES)", static_cast<unsigned long long>(frameAllocations.allocations),
+             static_cast<unsigned long long>(frameAllocations.bytes));
+    this->fontRenderer->renderText(line, 10, y, projection, scale, vec3{1, 1, 0});
+    if (frameAllocations.violations > 0) {
+        y -= lineHeight;
+        snprintf(line, sizeof(line), "ALLOCS IN NO-ALLOC SCOPES: %llu", static_cast<unsigned long long>(frameAllocations.violations));
+        this->fontRenderer->renderText(line, 10, y, projection, scale, vec3{1, 0, 0});
+    }
+#endif
+    // Bubbles the camera culling kept (the rest of the arena isn't drawn)
+    y -= lineHeight;
+    snprintf(line, sizeof(line), "BUBBLES DRAWN %zu OF %zu", visibleBubbles.size(), bubbles.size());
+    this->fontRenderer->renderText(line, 10, y, projection, scale, vec3{0, 1, 1});
+    y -= lineHeight;
+    snprintf(line, sizeof(line), "RENDER SCALE %.2f%s GPU %.2f", renderScale->getScale(),
+             renderScale->getSettings().automatic ? " AUTO" : "", renderScale->getGpuTime() / 1000.0);
+    this->fontRenderer->renderText(line, 10, y, projection, scale, vec3{0, 1, 1});
+#ifdef DODGEBALL_GL_STATS
+    // Last frame's numbers (including drawing this overlay)
+    GLFrameStats glFrame = GLStats::getLastFrame();
+    GLResourceStats glResources = GLStats::getResources();
+    y -= lineHeight;
+    snprintf(line, sizeof(line), "DRAWS %u VERTS %llu PROGRAMS %u TEXTURES %u", glFrame.drawCalls,
+             static_cast<unsigned long long>(glFrame.vertices), glFrame.programSwitches, glFrame.textureBinds);
+    this->fontRenderer->renderText(line, 10, y, projection, scale, vec3{0, 1, 1});
+    y -= lineHeight;
+    snprintf(line, sizeof(line), "UPLOADS %u (%llu BYTES)", glFrame.bufferUploads,
+             static_cast<unsigned long long>(glFrame.uploadedBytes));
+    this->fontRenderer->renderText(line, 10, y, projection, scale, vec3{0, 1, 1});
+    y -= lineHeight;
+    snprintf(line, sizeof(line), "LIVE VAOS %u BUFFERS %u (%llu KB) TEXTURES %u (%llu KB)", glResources.vertexArrays,
+             glResources.buffers, static_cast<unsigned long long>(glResources.bufferBytes / 1024), glResources.textures,
+             static_cast<unsigned long long>(glResources.textureBytes / 1024));
+    this->fontRenderer->renderText(line, 10, y, projection, scale, vec3{0, 1, 1});
+#endif
+    if (frameGraph != nullptr) {
+        // Last frame's tasks (* = on the critical path)
+        y -= lineHeight;
+        this->fontRenderer->renderText("TASKS (ms)      START   TIME THREAD", 10, y, projection, scale, vec3{1, 0.5f, 0});
+        for (int task = 0; task < frameGraph->getTaskCount(); ++task) {
+            const TaskGraph::TaskTiming &timing = frameGraph->getTiming(task);
+            y -= lineHeight;
+            snprintf(line, sizeof(line), "%c%-13.13s %6.2f %6.2f %6d", timing.critical ? '*' : ' ',
+                     frameGraph->getName(task), timing.start / 1e6, (timing.end - timing.start) / 1e6, timing.thread);
+            this->fontRenderer->renderText(line, 10, y, projection, scale, vec3{1, 0.5f, 0});
+        }
+        y -= lineHeight;
+        snprintf(line, sizeof(line), "CRITICAL PATH %.2f OF %.2f", frameGraph->getCriticalTime() / 1e6,
+                 frameGraph->getRunTime() / 1e6);
+        this->fontRenderer->renderText(line, 10, y, projection, scale, vec3{1, 0.5f, 0});
+    }
+    if (Profiler::get().getDroppedEvents() > 0) {
+        y -= lineHeight;
+        snprintf(line, sizeof(line), "DROPPED EVENTS: %llu", static_cast<unsigned long long>(Profiler::get().getDroppedEvents()));
+        this->fontRenderer->renderText(line, 10, y, projection, scale, vec3{1, 0, 0});
+    }
+}
+#endif
+
 // Getting the Pixel Art from the file
 void Engine::readFromFile(std::string filepath) {
+    PROFILE_SCOPE("readFromFile");
     ifstream ins(filepath);
     if (!ins) {
-        cout << "Error opening file" << endl;
+        LOG_ERROR("Error opening file {}", filepath);
     }
     ins >> std::noskipws;
     int xCoord = 0, yCoord = HEIGHT-SIDE_LENGTH;
@@ -893,31 +1072,97 @@ void Engine::readFromFile(std::string filepath) {
             yCoord -= SIDE_LENGTH;
         }
         if (draw) {
-            squares.push_back(make_unique<Rect>(playerShader, vec2(xCoord + SIDE_LENGTH/2, yCoord + SIDE_LENGTH/2), vec2(SIDE_LENGTH, SIDE_LENGTH), c));
+            if (pixelCount == MAX_PIXELS) {
+                LOG_WARNING("Pixel art {} is larger than the screen", filepath);
+                break;
+            }
+            createRect(vec2(xCoord + SIDE_LENGTH/2, yCoord + SIDE_LENGTH/2), vec2(SIDE_LENGTH, SIDE_LENGTH), c, Layer::pixelArt);
+            pixelCount++;
             xCoord += SIDE_LENGTH;
         }
     }
     ins.close();
 }
 
+uint64_t Engine::getStateHash() const {
+    StateHash hash;
+    hash.add(screen);
+    hash.add(lvl);
+    hash.add(life);
+    hash.add(selected);
+    hash.add(startGame);
+    hash.add(EE1);
+    hash.add(playerGodMode);
+    hash.add(playerColor.vec);
+    hash.add(countDownStarts);
+    hash.add(gameCountDown);
+    hash.add(timeSurvived);
+    hash.add(random.getState());
+    // Every entity's position and velocity (the player, bubbles and confetti)
+    const ComponentArray<Transform> &transforms = registry.components<Transform>();
+    const ComponentArray<Velocity> &velocities = registry.components<Velocity>();
+    hash.add(registry.getEntityCount());
+    hash.addBytes(transforms.data(), transforms.size() * sizeof(Transform));
+    hash.addBytes(velocities.data(), velocities.size() * sizeof(Velocity));
+    return hash.get();
+}
+
+void Engine::saveSnapshot(vector<unsigned char> &snapshot) const {
+    PROFILE_SCOPE("saveSnapshot");
+    SnapshotWriter writer(snapshot);
+    GameState game = {screen, gameCountDown, startTime, selected, countDownStarts, countDownTime, lvl, life,
+                      playerColor.vec, timeSurvived, playerGodMode, startGame, EE1};
+    writer.write(SNAPSHOT_VERSION);
+    writer.write(game);
+    writer.write(random.getState());
+    writer.write(lastFrame);
+    writer.write(mousePressedLastFrame);
+    writer.write(pixelCount);
+    writer.writeArray(bubbles);
+    registry.save(writer);
+}
+
+bool Engine::restoreSnapshot(const vector<unsigned char> &snapshot) {
+    PROFILE_SCOPE("restoreSnapshot");
+    SnapshotReader reader(snapshot);
+    uint32_t version = 0;
+    GameState game;
+    Random::State randomState;
+    if (!reader.read(version) || version != SNAPSHOT_VERSION || !reader.read(game) || !reader.read(randomState) ||
+        !reader.read(lastFrame) || !reader.read(mousePressedLastFrame) || !reader.read(pixelCount) ||
+        !reader.readArray(bubbles) || !registry.load(reader)) {
+        LOG_ERROR("Invalid snapshot");
+        return false;
+    }
+    int levelBefore = lvl;
+    screen = game.screen;
+    gameCountDown = game.gameCountDown;
+    startTime = game.startTime;
+    selected = game.selected;
+    countDownStarts = game.countDownStarts;
+    countDownTime = game.countDownTime;
+    lvl = game.lvl;
+    life = game.life;
+    playerColor = game.playerColor;
+    timeSurvived = game.timeSurvived;
+    playerGodMode = game.playerGodMode;
+    startGame = game.startGame;
+    EE1 = game.EE1;
+    random.setState(randomState);
+    world.load(registry);
+    hazards.reset();
+
+    // The level being generated in the background is for the wrong level now
+    if (lvl != levelBefore) {
+        if (nextLevel.valid()) {
+            nextLevel.wait();
+        }
+        levelArena.reset();
+        prepareNextLevel();
+    }
+    return true;
+}
+
 bool Engine::shouldClose() {
     return glfwWindowShouldClose(window);
 }
-
-GLenum Engine::glCheckError_(const char *file, int line) {
-    GLenum errorCode;
-    while ((errorCode = glGetError()) != GL_NO_ERROR) {
-        string error;
-        switch (errorCode) {
-            case GL_INVALID_ENUM:                  error = "INVALID_ENUM"; break;
-            case GL_INVALID_VALUE:                 error = "INVALID_VALUE"; break;
-            case GL_INVALID_OPERATION:             error = "INVALID_OPERATION"; break;
-            case GL_STACK_OVERFLOW:                error = "STACK_OVERFLOW"; break;
-            case GL_STACK_UNDERFLOW:               error = "STACK_UNDERFLOW"; break;
-            case GL_OUT_OF_MEMORY:                 error = "OUT_OF_MEMORY"; break;
-            case GL_INVALID_FRAMEBUFFER_OPERATION: error = "INVALID_FRAMEBUFFER_OPERATION"; break;
-        }
-        cout << error << " | " << file << " (" << line << ")" << endl;
-    }
-    return errorCode;
-}
\ No newline at end of file
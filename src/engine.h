@@ -4,13 +4,33 @@
 #include <vector>
 #include <memory>
 #include <iostream>
+#include <future>
+#include <chrono>
 #include "GLFW/glfw3.h"
 
 #include "shader/shaderManager.h"
-#include "shapes/circle.h"
-#include "shapes/rect.h"
-#include "shapes/shape.h"
 #include "font/fontRenderer.h"
+#include "ecs/registry.h"
+#include "ecs/systems.h"
+#include "ecs/renderSystem.h"
+#include "game/level.h"
+#include "game/world.h"
+#include "game/hazards.h"
+#include "game/camera.h"
+#include "game/input.h"
+#include "game/player.h"
+#include "game/replay.h"
+#include "framework/arena.h"
+#include "framework/snapshot.h"
+#include "framework/random.h"
+#include "framework/profiler.h"
+#include "framework/allocationTracker.h"
+#include "framework/glStats.h"
+#include "framework/histogram.h"
+#include "framework/debug.h"
+#include "framework/renderScale.h"
+#include "framework/log.h"
+#include "framework/taskGraph.h"
 
 using std::vector, std::unique_ptr, std::make_unique, glm::ortho, glm::mat4, glm::vec3, glm::vec4;
 
@@ -27,7 +47,20 @@ class Engine {
         const unsigned int WIDTH = 1600, HEIGHT = 1200;
         const glm::mat4 projection = glm::ortho(0.0f, (float)WIDTH, 0.0f, (float)HEIGHT);
 
-        bool keys[1024];
+        /// @brief Resolution frames are rendered at before they're upscaled to the window (created in initWindow())
+        unique_ptr<RenderScale> renderScale;
+
+        /// @brief The arena the levels are played in is this many screens wide and high (--arena)
+        const int arenaScreens;
+        /// @brief Width and height of the arena (the player and the bubbles live in arena coordinates)
+        const vec2 arenaSize;
+        /// @brief The part of the arena on screen (follows the player)
+        Camera camera;
+        /// @brief Bubbles the camera can see, found with the world's grid (only these are drawn)
+        vector<Entity> visibleBubbles;
+
+        /// @brief This tick's input (the game reads input and time only through this, see processInput())
+        InputFrame input;
 
         /// @brief Responsible for loading and storing all the shaders used in the project.
         /// @details Initialized in initShaders()
@@ -35,36 +68,54 @@ class Engine {
 
         unique_ptr<FontRenderer> fontRenderer;
 
-        // --- Shapes ---
+        /// @brief Engine-wide random number generator (seeded once, so a recorded seed replays the game)
+        Random random;
+
+        // --- Memory ---
+        // Per-level arena (the next level's spawn data is generated into it, reset once the level is loaded)
+        Arena levelArena;
+        static const int CONFETTI_COUNT = 150;
+
+        // --- Entities ---
+        // Every game object (player, bubbles, buttons, confetti, pixel art) is an entity in the registry
+        Registry registry;
+        // Draws the Renderable entities one layer at a time (initialized in initShaders())
+        unique_ptr<RenderSystem> renderSystem;
         // The player (square)
-        unique_ptr<Shape> player;
+        Entity player;
         // Bubbles (the objects the user must avoid)
-        vector<unique_ptr<Circle>> bubbles;
+        vector<Entity> bubbles;
+        // Bubble physics (moves and bounces every bubble entity)
+        World world;
+        // Bubbles around the player (collisions and near misses, updated after every world step)
+        HazardQuery hazards;
+        // Spawn data for the next level (generated in the background while the current level is played)
+        std::future<LevelSpawns> nextLevel;
         const int RADIUS = 50;
-        //Confetti (spawns when user wins)
-        vector<unique_ptr<Shape>> confeti;
-        //Pixel Art
-        vector<unique_ptr<Shape>> squares;
+        // Confetti that fell off the screen this frame (reused every frame)
+        vector<Entity> expiredConfetti;
+        // Snapshot taken when the current level went live (losing a life goes back to it)
+        vector<unsigned char> checkpoint;
 
         // --- Player Color Options ---
         //Red
-        unique_ptr<Shape> redPlayer;
+        Entity redPlayer;
         //White
-        unique_ptr<Shape> whitePlayer;
+        Entity whitePlayer;
         //Blue
-        unique_ptr<Shape> bluePlayer;
+        Entity bluePlayer;
         //Yellow
-        unique_ptr<Shape> yellowPlayer;
+        Entity yellowPlayer;
         // Gray
-        unique_ptr<Shape> grayPlayer;
+        Entity grayPlayer;
         // Purple
-        unique_ptr<Shape> purplePlayer;
+        Entity purplePlayer;
 
         //God Mode (used to easily complete levels and check changes made, click lives left to engage)
-        unique_ptr<Shape> godMode;
+        Entity godMode;
 
         //Players Location Placeholder
-        unique_ptr<Shape> playerLocation;
+        Entity playerLocation;
 
         // Shaders
         Shader shapeShader;
@@ -74,18 +125,85 @@ class Engine {
         double mouseX, mouseY;
         bool mousePressedLastFrame = false;
 
-        //Pixel art
-        const int SIDE_LENGTH = 20;
+#ifdef DODGEBALL_PROFILER
+        /// @brief Profiler overlay (toggled with F3)
+        bool showProfiler = false;
+        bool profilerKeyLastFrame = false;
+        /// @brief Trace capture (F4 writes the next TRACE_FRAMES frames to trace.json)
+        bool traceKeyLastFrame = false;
+        static const int TRACE_FRAMES = 300;
 
-        /// @note Call glCheckError() after every OpenGL call to check for errors.
-        GLenum glCheckError_(const char *file, int line);
-        /// @brief Macro for glCheckError_ function. Used for debugging.
-        #define glCheckError() glCheckError_(__FILE__, __LINE__)
+        /// @brief Draws the profiler's per-scope statistics over the current screen.
+        void renderProfiler();
+#endif
+
+        //Pixel art
+        static const int SIDE_LENGTH = 20;
+        // Number of squares that fit on the screen (larger pixel art is cut off)
+        const int MAX_PIXELS = (WIDTH / SIDE_LENGTH) * (HEIGHT / SIDE_LENGTH);
+        int pixelCount = 0;
+
+        /// @brief Creates a rectangle entity (player, buttons and pixel art).
+        Entity createRect(vec2 pos, vec2 size, color c, Layer layer);
+
+        /// @brief Creates a piece of confetti above the top of the screen, with a random size and color.
+        /// @param y How far above the top of the screen it starts
+        void spawnConfetti(float y);
+
+        /// @brief Changes the color an entity is drawn with.
+        void setColor(Entity entity, color c);
+
+        // --- HUD ---
+        /// @brief One line of HUD text (laid out by layoutHud(), drawn by render())
+        struct HudText {
+            string text;
+            float x, y;
+            vec3 color;
+        };
+        static const int MAX_HUD_TEXTS = 4;
+        HudText hudTexts[MAX_HUD_TEXTS];
+        int hudTextCount = 0;
+
+        /// @brief Adds a line of HUD text centered the way the screens center their text.
+        void addHudText(const char *text, float centerX, float y, vec3 textColor);
+
+        /// @brief The tasks main() runs every frame (shown in the profiler overlay), or nullptr
+        const TaskGraph *frameGraph = nullptr;
+
+        /// @brief Checks if the mouse is over the entity's rectangle (buttons).
+        bool isMouseOver(Entity entity) const;
+
+        // --- Frame times ---
+        /// @brief Frame, update and render times (in microseconds) for one screen
+        struct ScreenTimes {
+            Histogram frame;
+            Histogram update;
+            Histogram render;
+            /// @brief Frames that took longer than FRAME_BUDGET
+            uint64_t framesOverBudget = 0;
+        };
+        /// @brief One ScreenTimes per screen (the screen a frame is counted for is the one it started on)
+        static const int SCREEN_COUNT = 7;
+        ScreenTimes screenTimes[SCREEN_COUNT];
+        /// @brief 60 FPS frame budget in microseconds
+        static constexpr uint64_t FRAME_BUDGET = 16667;
+        std::chrono::steady_clock::time_point lastUpdateStart;
+        /// @brief F5 prints the frame time report
+        bool reportKeyLastFrame = false;
+
+        /// @brief Returns the seed used to generate the given level.
+        uint64_t getLevelSeed(int level) const;
+
+        /// @brief Returns a random color that changes once a second (rainbow HUD text).
+        vec3 getFlashColor() const;
 
     public:
         /// @brief Constructor for the Engine class.
         /// @details Initializes window and shaders.
-        Engine();
+        /// @param seed Seed for every random value in the game (the same seed generates the same levels)
+        /// @param headless No window or OpenGL (only processInput() and update() may be called, used to run replays)
+        /// @param arenaScreens Width and height of the arena in screens (the camera scrolls when it's over 1)
+        explicit Engine(uint64_t seed = Random::randomSeed(), bool headless = false, int arenaScreens = 1);
 
         /// @brief Destructor for the Engine class.
         ~Engine();
@@ -95,30 +213,80 @@ class Engine {
         unsigned int initWindow(bool debug = false);
 
         /// @brief Loads shaders from files and stores them in the shaderManager.
-        /// @details Renderers are initialized here.
+        /// @details Renderers are initialized here. The shaders are only submitted to the driver, which compiles
+        /// them while the rest of the game loads (see finishShaders()).
         void initShaders();
 
+        /// @brief Waits for the shaders submitted by initShaders(), logs any errors and sets their uniforms.
+        void finishShaders();
+
         //Counts down the time left in the level
         bool countDown();
 
-        /// @brief Initializes the shapes to be rendered.
+        /// @brief Creates the entities that live for the whole game (player, buttons, confetti).
         void initShapes();
 
-        /// @brief Populates squares vector with input from file.
+        /// @brief Replaces the bubble entities with a new level's.
+        /// @details Resets levelArena once the spawn data has been copied into the bubbles.
+        /// @param spawns The spawn data for the level (see generateLevel())
+        void loadLevel(const LevelSpawns &spawns);
+
+        /// @brief Starts generating the next level's spawn data on a worker thread.
+        void prepareNextLevel();
+
+        /// @brief Creates the pixel art entities from a file.
         void readFromFile(string filepath);
 
+        /// @brief Reads this tick's input and time from the window.
+        /// @details Also handles the keys that aren't part of the game (escape and the debug keys).
+        InputFrame pollInput();
+
         /// @brief Processes input from the user.
-        /// @details (e.g. keyboard input, mouse input, etc.)
-        void processInput();
+        /// @details (e.g. keyboard input, mouse input, etc.) Live input comes from pollInput(), replays from a file.
+        void processInput(const InputFrame &frame);
 
         /// @brief Updates the game state.
         /// @details (e.g. collision detection, delta time, etc.)
         void update();
 
+        /// @brief Lays out the play screen's HUD text (level, time left and lives).
+        /// @details No OpenGL calls, so it can run on any thread (after update(), before render()).
+        void layoutHud();
+
+        /// @brief Copies the entities to draw into the render system's draw lists.
+        /// @details No OpenGL calls, so it can run on any thread (after update(), before render()).
+        void prepareDraws();
+
         /// @brief Renders the game state.
-        /// @details Displays/renders objects on the screen.
+        /// @details Displays/renders objects on the screen, from what layoutHud() and prepareDraws() prepared.
         void render();
 
+        /// @brief Changes the resolution frames are rendered at (--render-scale, ignored by headless engines).
+        void setRenderScale(const RenderScaleSettings &settings);
+
+        /// @brief Sets the task graph main() runs every frame (its timings and critical path go in the profiler
+        /// overlay and the frame time report).
+        void setFrameGraph(const TaskGraph *graph) { frameGraph = graph; }
+
+        /// @brief Prints p50/p90/p99/p99.9/max frame, update and render times for every screen that was shown, and
+        /// the frame graph's task times.
+        /// @details Called when the game closes and when F5 is pressed.
+        void reportFrameTimes(std::ostream &out) const;
+
+        /// @brief Saves the whole game state (bubbles, player, timers, level, lives, random state) into snapshot.
+        /// @details The snapshot is plain bytes; saving into the same vector again reuses its memory.
+        void saveSnapshot(vector<unsigned char> &snapshot) const;
+
+        /// @brief Puts the game back in the state saved by saveSnapshot() (from this Engine or one with the same seed).
+        /// @details Times in the snapshot are kept as they were, so restoring to continue live play should restart
+        /// the timers (see the retry in processInput()).
+        /// @return false if the snapshot is invalid (the game state is then undefined)
+        bool restoreSnapshot(const vector<unsigned char> &snapshot);
+
+        /// @brief Hash of the game state (screen, level, lives, timers, random state and every entity's movement).
+        /// @details Written at the end of a recording; a replay of it must end with the same hash.
+        uint64_t getStateHash() const;
+
         /* deltaTime variables */
         float deltaTime = 0.0f; // Time between current frame and last frame
         float lastFrame = 0.0f; // Time of last frame (used to calculate deltaTime)
@@ -133,8 +301,8 @@ class Engine {
         /// @return false if the window should not close
         bool shouldClose();
 
-        /// Projection matrix used for 2D rendering (orthographic projection).
-        /// We don't have to change this matrix since the screen size never changes.
+        /// Projection matrix used for 2D rendering (orthographic projection) of everything outside the arena.
+        /// We don't have to change this matrix since the screen size never changes (the camera draws the arena).
         /// OpenGL uses the projection matrix to map the 3D scene to a 2D viewport.
         /// The projection matrix transforms coordinates in the camera space into normalized device coordinates (view space to clip space).
         /// @note The projection matrix is used in the vertex shader.
@@ -143,12 +311,6 @@ class Engine {
         // 4th quadrant
         // mat4 PROJECTION = ortho(0.0f, static_cast<float>(WIDTH), static_cast<float>(HEIGHT), 0.0f, -1.0f, 1.0f);
 
-        /// @brief Checks for collisions between all bubbles
-        void checkCollisions();
-
-        /// @brief Prevents bubbles from going off screen
-        void checkBounds(unique_ptr<Circle> &bubble) const;
-
 };
 
 #endif //GRAPHICS_ENGINE_H
\ No newline at end of file
@@ -1,20 +1,22 @@
 #include "font.h"
 #include <glad/glad.h>
+#include "../framework/log.h"
+#include "../framework/profiler.h"
 
-#include <iostream>
 
 Font::Font(std::string fontPath, unsigned int fontSize) {
+    PROFILE_SCOPE("loadFont");
     FT_Library ft;
 
     // Initialize FreeType library
     if (FT_Init_FreeType(&ft)) {
-        std::cout << "ERROR::FREETYPE: Could not init FreeType Library" << std::endl;
+        LOG_ERROR("Could not init the FreeType library");
     }
 
     // Load font as face
     FT_Face face;
     if (FT_New_Face(ft, fontPath.c_str(), 0, &face)) {
-        std::cout << "ERROR::FREETYPE: Failed to load font" << std::endl;
+        LOG_ERROR("Failed to load font {}", fontPath);
     }
 
     // Set size to load glyphs as
@@ -22,7 +24,7 @@ Font::Font(std::string fontPath, unsigned int fontSize) {
 
     // Attempt to load character glyph
     if (FT_Load_Char(face, 'X', FT_LOAD_RENDER)) {
-        std::cout << "ERROR::FREETYTPE: Failed to load Glyph" << std::endl;
+        LOG_ERROR("Failed to load glyph X from {}", fontPath);
     }
 
     glPixelStorei(GL_UNPACK_ALIGNMENT, 1); // disable byte-alignment restriction
@@ -31,7 +33,7 @@ Font::Font(std::string fontPath, unsigned int fontSize) {
     for (unsigned char c = 0; c < 128; c++) {
         // load character glyph 
         if (FT_Load_Char(face, c, FT_LOAD_RENDER)) {
-            std::cout << "ERROR::FREETYTPE: Failed to load Glyph" << std::endl;
+            LOG_ERROR("Failed to load glyph {} from {}", static_cast<int>(c), fontPath);
             continue;
         }
 
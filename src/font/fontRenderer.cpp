@@ -13,6 +13,10 @@ FontRenderer::FontRenderer(Shader& shader, std::string fontPath, int fontSize) {
 FontRenderer::~FontRenderer() {
     glDeleteVertexArrays(1, &this->VAO);
     glDeleteBuffers(1, &this->VBO);
+    // The glyph textures were handed over by the Font, so they are deleted here
+    for (const auto &glyph : this->font) {
+        glDeleteTextures(1, &glyph.second.TextureID);
+    }
 }
 
 void FontRenderer::initRenderData() {
@@ -27,12 +31,40 @@ void FontRenderer::initRenderData() {
     glBindVertexArray(0);
 }
 
-void FontRenderer::renderText(std::string text, float x, float y, const glm::mat4 projection, float scale, glm::vec3 color) {
+void FontRenderer::renderText(const std::string &text, float x, float y, const glm::mat4 projection, float scale, glm::vec3 color) {
+    if (!deferred) {
+        drawText(text, x, y, projection, scale, color);
+        return;
+    }
+    if (deferredCount == deferredTexts.size()) {
+        deferredTexts.emplace_back();
+    }
+    DeferredText &held = deferredTexts[deferredCount++];
+    // Assigning reuses the string's memory
+    held.text = text;
+    held.x = x;
+    held.y = y;
+    held.projection = projection;
+    held.scale = scale;
+    held.color = color;
+}
+
+void FontRenderer::flush() {
+    deferred = false;
+    for (size_t i = 0; i < deferredCount; ++i) {
+        const DeferredText &held = deferredTexts[i];
+        drawText(held.text, held.x, held.y, held.projection, held.scale, held.color);
+    }
+    deferredCount = 0;
+}
+
+void FontRenderer::drawText(const std::string &text, float x, float y, const glm::mat4 &projection, float scale,
+                            glm::vec3 color) {
     // activate corresponding render state
 
     this->shader.use();
     glUniformMatrix4fv(glGetUniformLocation(this->shader.ID, "projection"), 1, false, glm::value_ptr(projection));
-    glUniform3f(glGetUniformLocation(this->shader.ID, "textColor"), color.x, color.y, color.z);
+    glUniform4f(glGetUniformLocation(this->shader.ID, "shapeColor"), color.x, color.y, color.z, 1.0f);
 
     glActiveTexture(GL_TEXTURE0);
     glBindVertexArray(this->VAO);
@@ -40,7 +72,12 @@ void FontRenderer::renderText(std::string text, float x, float y, const glm::mat
     // iterate through all characters
     std::string::const_iterator c;
     for (c = text.begin(); c != text.end(); c++) {
-        Character ch = font[*c];
+        // find() rather than operator[], which would insert (and allocate) an empty glyph for unknown characters
+        auto glyph = font.find(*c);
+        if (glyph == font.end()) {
+            continue;
+        }
+        const Character &ch = glyph->second;
 
         float xpos = x + ch.Bearing.x * scale;
         float ypos = y - (ch.Size.y - ch.Bearing.y) * scale;
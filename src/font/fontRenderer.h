@@ -4,6 +4,8 @@
 #include "../shader/shaderManager.h"
 #include "../shader/shader.h"
 #include "font.h"
+#include <string>
+#include <vector>
 
 /**
  * @brief A font renderer
@@ -37,7 +39,18 @@ class FontRenderer {
          * @param scale The scale of the text
          * @param color The color of the text
          */
-        void renderText(std::string text, float x, float y, const glm::mat4 projection, float scale, glm::vec3 color);
+        void renderText(const std::string &text, float x, float y, const glm::mat4 projection, float scale, glm::vec3 color);
+
+        /**
+         * @brief Holds on to the text passed to renderText() until flush() (instead of drawing it right away)
+         * @details Used to draw text after the rest of the frame, e.g. at full resolution on top of an upscaled frame
+         */
+        void setDeferred(bool deferred) { this->deferred = deferred; }
+
+        /**
+         * @brief Draws the text held since setDeferred(true), in the order it was added, and stops deferring
+         */
+        void flush();
 
     private:
         /**
@@ -56,6 +69,27 @@ class FontRenderer {
          */
         std::map<char, Character> font;
 
+        /**
+         * @brief A renderText() call waiting for flush()
+         * @details The slots are reused every frame, so once they have grown deferring text doesn't allocate
+         */
+        struct DeferredText {
+            std::string text;
+            float x, y;
+            glm::mat4 projection;
+            float scale;
+            glm::vec3 color;
+        };
+        bool deferred = false;
+        std::vector<DeferredText> deferredTexts;
+        size_t deferredCount = 0;
+
+        /**
+         * @brief Draws a line of text right away
+         */
+        void drawText(const std::string &text, float x, float y, const glm::mat4 &projection, float scale,
+                      glm::vec3 color);
+
         /**
          * @brief Initializes and configures the buffer and vertex attributes
          */
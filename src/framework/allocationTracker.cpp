@@ -0,0 +1,202 @@
+#include "allocationTracker.h"
+
+#ifdef DODGEBALL_ALLOCATION_TRACKING
+
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+// Plain thread_locals (no constructors), so using them never allocates
+namespace {
+thread_local uint64_t threadAllocations = 0;
+thread_local uint64_t threadBytes = 0;
+// Nesting depth and name of the innermost ASSERT_NO_ALLOCATIONS block on this thread
+thread_local int noAllocationDepth = 0;
+thread_local const char *noAllocationName = nullptr;
+// Set while a violation is being reported, so printing it can't report itself
+thread_local bool reporting = false;
+}
+
+#ifdef NDEBUG
+std::atomic<int> AllocationTracker::check{static_cast<int>(AllocationCheck::off)};
+#else
+std::atomic<int> AllocationTracker::check{static_cast<int>(AllocationCheck::warn)};
+#endif
+std::atomic<uint64_t> AllocationTracker::totalAllocations{0}, AllocationTracker::totalFrees{0},
+    AllocationTracker::totalBytes{0}, AllocationTracker::totalViolations{0};
+std::atomic<uint64_t> AllocationTracker::frameAllocations{0}, AllocationTracker::frameFrees{0},
+    AllocationTracker::frameBytes{0}, AllocationTracker::frameViolations{0};
+AllocationCounts AllocationTracker::lastFrame;
+
+void AllocationTracker::recordAllocation(size_t bytes) {
+    threadAllocations++;
+    threadBytes += bytes;
+    totalAllocations.fetch_add(1, std::memory_order_relaxed);
+    totalBytes.fetch_add(bytes, std::memory_order_relaxed);
+    frameAllocations.fetch_add(1, std::memory_order_relaxed);
+    frameBytes.fetch_add(bytes, std::memory_order_relaxed);
+
+    if (noAllocationDepth == 0 || reporting) {
+        return;
+    }
+    totalViolations.fetch_add(1, std::memory_order_relaxed);
+    bool firstThisFrame = frameViolations.fetch_add(1, std::memory_order_relaxed) == 0;
+
+    AllocationCheck current = getCheck();
+    if (current == AllocationCheck::abort || (current == AllocationCheck::warn && firstThisFrame)) {
+        reporting = true;
+        // stdio rather than cout, which can allocate
+        std::fprintf(stderr, "Allocation of %zu bytes in no-allocation scope %s\n", bytes, noAllocationName);
+        std::fflush(stderr);
+        reporting = false;
+        if (current == AllocationCheck::abort) {
+            std::abort();
+        }
+    }
+}
+
+void AllocationTracker::recordFree() {
+    totalFrees.fetch_add(1, std::memory_order_relaxed);
+    frameFrees.fetch_add(1, std::memory_order_relaxed);
+}
+
+void AllocationTracker::endFrame() {
+    lastFrame.allocations = frameAllocations.exchange(0, std::memory_order_relaxed);
+    lastFrame.frees = frameFrees.exchange(0, std::memory_order_relaxed);
+    lastFrame.bytes = frameBytes.exchange(0, std::memory_order_relaxed);
+    lastFrame.violations = frameViolations.exchange(0, std::memory_order_relaxed);
+}
+
+AllocationCounts AllocationTracker::getLastFrame() { return lastFrame; }
+
+AllocationCounts AllocationTracker::getTotal() {
+    AllocationCounts counts;
+    counts.allocations = totalAllocations.load(std::memory_order_relaxed);
+    counts.frees = totalFrees.load(std::memory_order_relaxed);
+    counts.bytes = totalBytes.load(std::memory_order_relaxed);
+    counts.violations = totalViolations.load(std::memory_order_relaxed);
+    return counts;
+}
+
+uint64_t AllocationTracker::getThreadAllocations() { return threadAllocations; }
+uint64_t AllocationTracker::getThreadBytes()       { return threadBytes; }
+
+void AllocationTracker::setCheck(AllocationCheck check) {
+    AllocationTracker::check.store(static_cast<int>(check), std::memory_order_relaxed);
+}
+
+AllocationCheck AllocationTracker::getCheck() {
+    return static_cast<AllocationCheck>(check.load(std::memory_order_relaxed));
+}
+
+void AllocationTracker::beginNoAllocation(const char *name) {
+    if (noAllocationDepth++ == 0) {
+        noAllocationName = name;
+    }
+}
+
+void AllocationTracker::endNoAllocation() {
+    noAllocationDepth--;
+}
+
+// --------------------------------------------------------
+// Replaced global operator new/delete
+// --------------------------------------------------------
+
+namespace {
+
+void *allocate(size_t size) {
+    AllocationTracker::recordAllocation(size);
+    if (size == 0) {
+        size = 1;
+    }
+    while (true) {
+        void *pointer = std::malloc(size);
+        if (pointer != nullptr) {
+            return pointer;
+        }
+        std::new_handler handler = std::get_new_handler();
+        if (handler == nullptr) {
+            throw std::bad_alloc();
+        }
+        handler();
+    }
+}
+
+void *allocateAligned(size_t size, std::align_val_t alignment) {
+    AllocationTracker::recordAllocation(size);
+    size_t align = static_cast<size_t>(alignment);
+    // aligned_alloc needs the size to be a multiple of the alignment
+    size = (size + align - 1) / align * align;
+    if (size == 0) {
+        size = align;
+    }
+    while (true) {
+#ifdef _WIN32
+        void *pointer = _aligned_malloc(size, align);
+#else
+        void *pointer = std::aligned_alloc(align, size);
+#endif
+        if (pointer != nullptr) {
+            return pointer;
+        }
+        std::new_handler handler = std::get_new_handler();
+        if (handler == nullptr) {
+            throw std::bad_alloc();
+        }
+        handler();
+    }
+}
+
+void release(void *pointer) {
+    if (pointer != nullptr) {
+        AllocationTracker::recordFree();
+        std::free(pointer);
+    }
+}
+
+void releaseAligned(void *pointer) {
+    if (pointer != nullptr) {
+        AllocationTracker::recordFree();
+#ifdef _WIN32
+        _aligned_free(pointer);
+#else
+        std::free(pointer);
+#endif
+    }
+}
+
+}
+
+void *operator new(size_t size)                                      { return allocate(size); }
+void *operator new[](size_t size)                                    { return allocate(size); }
+void *operator new(size_t size, std::align_val_t alignment)          { return allocateAligned(size, alignment); }
+void *operator new[](size_t size, std::align_val_t alignment)        { return allocateAligned(size, alignment); }
+
+void *operator new(size_t size, const std::nothrow_t &) noexcept {
+    try { return allocate(size); } catch (...) { return nullptr; }
+}
+void *operator new[](size_t size, const std::nothrow_t &) noexcept {
+    try { return allocate(size); } catch (...) { return nullptr; }
+}
+void *operator new(size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept {
+    try { return allocateAligned(size, alignment); } catch (...) { return nullptr; }
+}
+void *operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept {
+    try { return allocateAligned(size, alignment); } catch (...) { return nullptr; }
+}
+
+void operator delete(void *pointer) noexcept                                              { release(pointer); }
+void operator delete[](void *pointer) noexcept                                            { release(pointer); }
+void operator delete(void *pointer, size_t) noexcept                                      { release(pointer); }
+void operator delete[](void *pointer, size_t) noexcept                                    { release(pointer); }
+void operator delete(void *pointer, const std::nothrow_t &) noexcept                      { release(pointer); }
+void operator delete[](void *pointer, const std::nothrow_t &) noexcept                    { release(pointer); }
+void operator delete(void *pointer, std::align_val_t) noexcept                            { releaseAligned(pointer); }
+void operator delete[](void *pointer, std::align_val_t) noexcept                          { releaseAligned(pointer); }
+void operator delete(void *pointer, size_t, std::align_val_t) noexcept                    { releaseAligned(pointer); }
+void operator delete[](void *pointer, size_t, std::align_val_t) noexcept                  { releaseAligned(pointer); }
+void operator delete(void *pointer, std::align_val_t, const std::nothrow_t &) noexcept    { releaseAligned(pointer); }
+void operator delete[](void *pointer, std::align_val_t, const std::nothrow_t &) noexcept  { releaseAligned(pointer); }
+
+#endif //DODGEBALL_ALLOCATION_TRACKING
@@ -0,0 +1,94 @@
+#ifndef GRAPHICS_ALLOCATIONTRACKER_H
+#define GRAPHICS_ALLOCATIONTRACKER_H
+
+/// @brief Heap allocation tracking.
+/// @details When DODGEBALL_ALLOCATION_TRACKING is defined the global operator new/delete are replaced so every
+/// allocation is counted (per frame, per thread and per profiler scope). Put ASSERT_NO_ALLOCATIONS("name") at the top
+/// of a block that must not allocate; what happens when it does is chosen with AllocationTracker::setCheck().
+/// When DODGEBALL_ALLOCATION_TRACKING is not defined the macro compiles to nothing.
+#ifdef DODGEBALL_ALLOCATION_TRACKING
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#define ALLOCATION_CONCAT_(a, b) a##b
+#define ALLOCATION_CONCAT(a, b) ALLOCATION_CONCAT_(a, b)
+#define ASSERT_NO_ALLOCATIONS(name) NoAllocationScope ALLOCATION_CONCAT(noAllocationScope, __LINE__)(name)
+
+/// @brief What to do when something allocates inside an ASSERT_NO_ALLOCATIONS block.
+enum class AllocationCheck {
+    /// @brief Only count it
+    off,
+    /// @brief Count it and print the first one of every frame
+    warn,
+    /// @brief Print it and abort (run under a debugger to get the call stack)
+    abort
+};
+
+/// @brief Allocation counts (all threads).
+struct AllocationCounts {
+    uint64_t allocations = 0;
+    uint64_t frees = 0;
+    uint64_t bytes = 0;
+    /// @brief Allocations made inside ASSERT_NO_ALLOCATIONS blocks
+    uint64_t violations = 0;
+};
+
+/**
+ * @brief Counts heap allocations made through operator new.
+ * @details Everything is static so it works before main() and during static destruction.
+ * Nothing in here allocates.
+ */
+class AllocationTracker {
+    public:
+        /// @brief Called by the replaced operator new/delete.
+        static void recordAllocation(size_t bytes);
+        static void recordFree();
+
+        /// @brief Stores this frame's counts (see getLastFrame()) and starts counting the next frame.
+        /// @details Call once per frame, from the main thread.
+        static void endFrame();
+
+        /// @brief Counts for the last finished frame.
+        static AllocationCounts getLastFrame();
+
+        /// @brief Counts since the program started.
+        static AllocationCounts getTotal();
+
+        /// @brief Number of allocations and bytes allocated by the calling thread since it started.
+        /// @details Used by the profiler to count the allocations inside a scope.
+        static uint64_t getThreadAllocations();
+        static uint64_t getThreadBytes();
+
+        static void setCheck(AllocationCheck check);
+        static AllocationCheck getCheck();
+
+        /// @brief Starts and ends a block on this thread that must not allocate (use ASSERT_NO_ALLOCATIONS instead).
+        static void beginNoAllocation(const char *name);
+        static void endNoAllocation();
+
+    private:
+        static std::atomic<uint64_t> totalAllocations, totalFrees, totalBytes, totalViolations;
+        static std::atomic<uint64_t> frameAllocations, frameFrees, frameBytes, frameViolations;
+        static std::atomic<int> check;
+        static AllocationCounts lastFrame;
+};
+
+/// @brief Flags every allocation made in the enclosing block (use ASSERT_NO_ALLOCATIONS instead of using this directly).
+class NoAllocationScope {
+    public:
+        explicit NoAllocationScope(const char *name) { AllocationTracker::beginNoAllocation(name); }
+        ~NoAllocationScope()                         { AllocationTracker::endNoAllocation(); }
+
+        NoAllocationScope(const NoAllocationScope &) = delete;
+        NoAllocationScope &operator=(const NoAllocationScope &) = delete;
+};
+
+#else
+
+#define ASSERT_NO_ALLOCATIONS(name)
+
+#endif //DODGEBALL_ALLOCATION_TRACKING
+
+#endif //GRAPHICS_ALLOCATIONTRACKER_H
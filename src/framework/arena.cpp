@@ -0,0 +1,17 @@
+#include "arena.h"
+
+Arena::Arena(size_t capacity) : block(new std::byte[capacity]), capacity(capacity) {}
+
+void *Arena::allocate(size_t bytes, size_t alignment) {
+    // Round the offset up to the requested alignment
+    size_t start = (used + alignment - 1) & ~(alignment - 1);
+    if (start + bytes > capacity) {
+        return nullptr;
+    }
+    used = start + bytes;
+    return block.get() + start;
+}
+
+void Arena::reset()              { used = 0; }
+size_t Arena::getUsed() const     { return used; }
+size_t Arena::getCapacity() const { return capacity; }
@@ -0,0 +1,55 @@
+#ifndef GRAPHICS_ARENA_H
+#define GRAPHICS_ARENA_H
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+
+/**
+ * @brief A bump allocator over one fixed block of memory.
+ * @details Allocations just move a pointer forward, and everything is freed at once with reset().
+ * Destructors are never run, so only use it for trivially destructible data (e.g. spawn data for a level).
+ */
+class Arena {
+    public:
+        /// @brief Allocates the arena's block up front.
+        /// @param capacity The size of the block in bytes
+        explicit Arena(size_t capacity);
+
+        Arena(const Arena &) = delete;
+        Arena &operator=(const Arena &) = delete;
+
+        /// @brief Returns a block of memory from the arena.
+        /// @return nullptr if the arena is full
+        void *allocate(size_t bytes, size_t alignment = alignof(std::max_align_t));
+
+        /// @brief Allocates an array of count default constructed T.
+        /// @return nullptr if the arena is full
+        template <typename T>
+        T *allocateArray(size_t count) {
+            void *memory = allocate(sizeof(T) * count, alignof(T));
+            if (memory == nullptr) {
+                return nullptr;
+            }
+            return new (memory) T[count];
+        }
+
+        /// @brief Frees everything allocated from the arena.
+        void reset();
+
+        /// @brief Number of bytes currently allocated.
+        size_t getUsed() const;
+
+        /// @brief Size of the arena's block in bytes.
+        size_t getCapacity() const;
+
+    private:
+        /// @brief The memory handed out by allocate()
+        std::unique_ptr<std::byte[]> block;
+        size_t capacity;
+        /// @brief Offset of the next free byte in block
+        size_t used = 0;
+};
+
+#endif //GRAPHICS_ARENA_H
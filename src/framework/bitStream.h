@@ -0,0 +1,92 @@
+#ifndef GRAPHICS_BITSTREAM_H
+#define GRAPHICS_BITSTREAM_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+using std::vector;
+
+/**
+ * @brief Packs values into a byte buffer using only as many bits as each one needs (network packets).
+ * @details Bits are written least significant first. Call flush() after the last write.
+ */
+class BitWriter {
+    public:
+        /// @brief Clears the buffer (its capacity is kept).
+        explicit BitWriter(vector<unsigned char> &bytes) : bytes(bytes) { bytes.clear(); }
+
+        /// @brief Writes the low bitCount bits of value (at most 32).
+        void write(uint32_t value, int bitCount) {
+            buffer |= uint64_t(value & mask(bitCount)) << pending;
+            pending += bitCount;
+            while (pending >= 8) {
+                bytes.push_back(static_cast<unsigned char>(buffer));
+                buffer >>= 8;
+                pending -= 8;
+            }
+        }
+
+        /// @brief Writes a signed value in two's complement (it must fit in bitCount bits).
+        void writeSigned(int32_t value, int bitCount) { write(static_cast<uint32_t>(value), bitCount); }
+
+        /// @brief Writes the last partial byte.
+        void flush() {
+            if (pending > 0) {
+                bytes.push_back(static_cast<unsigned char>(buffer));
+                buffer = 0;
+                pending = 0;
+            }
+        }
+
+        static uint32_t mask(int bitCount) { return bitCount >= 32 ? 0xFFFFFFFFu : (1u << bitCount) - 1; }
+
+    private:
+        vector<unsigned char> &bytes;
+        uint64_t buffer = 0;
+        int pending = 0;
+};
+
+/**
+ * @brief Reads back what a BitWriter wrote, in the same order and with the same bit counts.
+ * @details Every read returns false if the data is too short (packets come from the network, so they may be cut
+ * short or made up).
+ */
+class BitReader {
+    public:
+        BitReader(const unsigned char *data, size_t size) : data(data), size(size) {}
+
+        bool read(uint32_t &value, int bitCount) {
+            while (pending < bitCount) {
+                if (offset == size) {
+                    return false;
+                }
+                buffer |= uint64_t(data[offset++]) << pending;
+                pending += 8;
+            }
+            value = static_cast<uint32_t>(buffer) & BitWriter::mask(bitCount);
+            buffer >>= bitCount;
+            pending -= bitCount;
+            return true;
+        }
+
+        bool readSigned(int32_t &value, int bitCount) {
+            uint32_t bits;
+            if (!read(bits, bitCount)) {
+                return false;
+            }
+            // Sign extend
+            int shift = 32 - bitCount;
+            value = static_cast<int32_t>(bits << shift) >> shift;
+            return true;
+        }
+
+    private:
+        const unsigned char *data;
+        size_t size;
+        size_t offset = 0;
+        uint64_t buffer = 0;
+        int pending = 0;
+};
+
+#endif //GRAPHICS_BITSTREAM_H
@@ -4,10 +4,12 @@
 
 #include "debug.h"
 
-GLenum glCheckError_(const char *file, int line) {
+GLenum glCheckError_(LogSite &site) {
     GLenum errorCode;
+    GLenum lastError = GL_NO_ERROR;
     while ((errorCode = glGetError()) != GL_NO_ERROR) {
-        std::string error;
+        lastError = errorCode;
+        const char *error = "UNKNOWN";
         switch (errorCode) {
             case GL_INVALID_ENUM:
                 error = "INVALID_ENUM";
@@ -31,7 +33,9 @@ GLenum glCheckError_(const char *file, int line) {
                 error = "INVALID_FRAMEBUFFER_OPERATION";
                 break;
         }
-        std::cout << error << " | " << file << " (" << line << ")" << std::endl;
+        if (Log::get().isEnabled(site.level)) {
+            Log::get().write(site, "OpenGL error {} ({})", error, static_cast<unsigned>(errorCode));
+        }
     }
-    return errorCode;
-}
\ No newline at end of file
+    return lastError;
+}
@@ -6,11 +6,18 @@
 #define GRAPHICS_DEBUG_H
 
 #include <glad/glad.h>
-#include <iostream>
+#include "log.h"
 
-GLenum glCheckError_(const char *file, int line);
+/// @brief Logs every pending OpenGL error (at error level, rate limited per call site).
+/// @return The last error (GL_NO_ERROR if there were none)
+GLenum glCheckError_(LogSite &site);
 
-#define glCheckError() glCheckError_(__FILE__, __LINE__)
-#define glFunction(func, ...) func(__VA_ARGS__); CHECK_GL_ERROR()
+/// @brief Checks for OpenGL errors. Cheap enough to call after every draw (errors are logged asynchronously).
+#define glCheckError()                                                                                                 \
+    glCheckError_([]() -> LogSite & {                                                                                  \
+        static LogSite site{__FILE__, __LINE__, LogLevel::error};                                                      \
+        return site;                                                                                                   \
+    }())
+#define glFunction(func, ...) func(__VA_ARGS__); glCheckError()
 
 #endif //GRAPHICS_DEBUG_H
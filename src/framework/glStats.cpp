@@ -0,0 +1,253 @@
+#include "glStats.h"
+
+#ifdef DODGEBALL_GL_STATS
+
+#include <unordered_map>
+#include <glad/glad.h>
+
+namespace {
+
+GLFrameStats frame;
+GLFrameStats lastFrame;
+GLResourceStats resources;
+
+// Sizes of the live objects, so deleting them can give back their memory
+std::unordered_map<GLuint, uint64_t> bufferSizes;
+std::unordered_map<GLuint, uint64_t> textureSizes;
+// Live VAOs and their element array buffer (that binding is part of the VAO's state)
+std::unordered_map<GLuint, GLuint> vertexArrayElementBuffers;
+
+// Currently bound objects
+GLuint currentProgram = 0;
+GLuint currentArrayBuffer = 0;
+GLuint currentElementBuffer = 0;
+GLuint currentVertexArray = 0;
+const int TEXTURE_UNITS = 32;
+GLuint currentTextures[TEXTURE_UNITS] = {};
+int currentTextureUnit = 0;
+
+// The functions glad loaded
+PFNGLDRAWARRAYSPROC realDrawArrays;
+PFNGLDRAWELEMENTSPROC realDrawElements;
+PFNGLUSEPROGRAMPROC realUseProgram;
+PFNGLACTIVETEXTUREPROC realActiveTexture;
+PFNGLBINDTEXTUREPROC realBindTexture;
+PFNGLBINDBUFFERPROC realBindBuffer;
+PFNGLBINDVERTEXARRAYPROC realBindVertexArray;
+PFNGLBUFFERDATAPROC realBufferData;
+PFNGLBUFFERSUBDATAPROC realBufferSubData;
+PFNGLTEXIMAGE2DPROC realTexImage2D;
+PFNGLGENBUFFERSPROC realGenBuffers;
+PFNGLDELETEBUFFERSPROC realDeleteBuffers;
+PFNGLGENTEXTURESPROC realGenTextures;
+PFNGLDELETETEXTURESPROC realDeleteTextures;
+PFNGLGENVERTEXARRAYSPROC realGenVertexArrays;
+PFNGLDELETEVERTEXARRAYSPROC realDeleteVertexArrays;
+
+/// @brief Returns the buffer bound to a target (only the two targets the game uses are tracked).
+GLuint getBoundBuffer(GLenum target) {
+    if (target == GL_ARRAY_BUFFER) {
+        return currentArrayBuffer;
+    }
+    if (target == GL_ELEMENT_ARRAY_BUFFER) {
+        return currentElementBuffer;
+    }
+    return 0;
+}
+
+/// @brief Bytes per pixel of a glTexImage2D format/type pair.
+uint64_t getPixelSize(GLenum format, GLenum type) {
+    uint64_t components = 4;
+    switch (format) {
+        case GL_RED: components = 1; break;
+        case GL_RG: components = 2; break;
+        case GL_RGB: components = 3; break;
+        default: break;
+    }
+    uint64_t componentSize = 1;
+    switch (type) {
+        case GL_UNSIGNED_SHORT: case GL_SHORT: case GL_HALF_FLOAT: componentSize = 2; break;
+        case GL_UNSIGNED_INT: case GL_INT: case GL_FLOAT: componentSize = 4; break;
+        default: break;
+    }
+    return components * componentSize;
+}
+
+// --------------------------------------------------------
+// Wrappers
+// --------------------------------------------------------
+
+void APIENTRY drawArrays(GLenum mode, GLint first, GLsizei count) {
+    frame.drawCalls++;
+    frame.vertices += count;
+    realDrawArrays(mode, first, count);
+}
+
+void APIENTRY drawElements(GLenum mode, GLsizei count, GLenum type, const void *indices) {
+    frame.drawCalls++;
+    frame.vertices += count;
+    realDrawElements(mode, count, type, indices);
+}
+
+void APIENTRY useProgram(GLuint program) {
+    if (program != currentProgram) {
+        frame.programSwitches++;
+        currentProgram = program;
+    }
+    realUseProgram(program);
+}
+
+void APIENTRY activeTexture(GLenum texture) {
+    currentTextureUnit = static_cast<int>(texture - GL_TEXTURE0) % TEXTURE_UNITS;
+    realActiveTexture(texture);
+}
+
+void APIENTRY bindTexture(GLenum target, GLuint texture) {
+    frame.textureBinds++;
+    currentTextures[currentTextureUnit] = texture;
+    realBindTexture(target, texture);
+}
+
+void APIENTRY bindBuffer(GLenum target, GLuint buffer) {
+    if (target == GL_ARRAY_BUFFER) {
+        currentArrayBuffer = buffer;
+    }
+    else if (target == GL_ELEMENT_ARRAY_BUFFER) {
+        currentElementBuffer = buffer;
+        auto vertexArray = vertexArrayElementBuffers.find(currentVertexArray);
+        if (vertexArray != vertexArrayElementBuffers.end()) {
+            vertexArray->second = buffer;
+        }
+    }
+    realBindBuffer(target, buffer);
+}
+
+void APIENTRY bindVertexArray(GLuint array) {
+    currentVertexArray = array;
+    auto elementBuffer = vertexArrayElementBuffers.find(array);
+    currentElementBuffer = elementBuffer != vertexArrayElementBuffers.end() ? elementBuffer->second : 0;
+    realBindVertexArray(array);
+}
+
+void APIENTRY bufferData(GLenum target, GLsizeiptr size, const void *data, GLenum usage) {
+    frame.bufferUploads++;
+    frame.uploadedBytes += size;
+    auto buffer = bufferSizes.find(getBoundBuffer(target));
+    if (buffer != bufferSizes.end()) {
+        resources.bufferBytes += size - buffer->second;
+        buffer->second = size;
+    }
+    realBufferData(target, size, data, usage);
+}
+
+void APIENTRY bufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void *data) {
+    frame.bufferUploads++;
+    frame.uploadedBytes += size;
+    realBufferSubData(target, offset, size, data);
+}
+
+void APIENTRY texImage2D(GLenum target, GLint level, GLint internalFormat, GLsizei width, GLsizei height,
+                         GLint border, GLenum format, GLenum type, const void *pixels) {
+    uint64_t bytes = static_cast<uint64_t>(width) * height * getPixelSize(format, type);
+    frame.uploadedBytes += pixels != nullptr ? bytes : 0;
+    auto texture = textureSizes.find(currentTextures[currentTextureUnit]);
+    if (texture != textureSizes.end()) {
+        // Level 0 replaces the texture, mipmap levels add to it
+        uint64_t size = level == 0 ? bytes : texture->second + bytes;
+        resources.textureBytes += size - texture->second;
+        texture->second = size;
+    }
+    realTexImage2D(target, level, internalFormat, width, height, border, format, type, pixels);
+}
+
+void APIENTRY genBuffers(GLsizei n, GLuint *buffers) {
+    realGenBuffers(n, buffers);
+    for (GLsizei i = 0; i < n; ++i) {
+        bufferSizes[buffers[i]] = 0;
+    }
+    resources.buffers += n;
+}
+
+void APIENTRY deleteBuffers(GLsizei n, const GLuint *buffers) {
+    for (GLsizei i = 0; i < n; ++i) {
+        auto buffer = bufferSizes.find(buffers[i]);
+        if (buffer != bufferSizes.end()) {
+            resources.bufferBytes -= buffer->second;
+            resources.buffers--;
+            bufferSizes.erase(buffer);
+        }
+    }
+    realDeleteBuffers(n, buffers);
+}
+
+void APIENTRY genTextures(GLsizei n, GLuint *textures) {
+    realGenTextures(n, textures);
+    for (GLsizei i = 0; i < n; ++i) {
+        textureSizes[textures[i]] = 0;
+    }
+    resources.textures += n;
+}
+
+void APIENTRY deleteTextures(GLsizei n, const GLuint *textures) {
+    for (GLsizei i = 0; i < n; ++i) {
+        auto texture = textureSizes.find(textures[i]);
+        if (texture != textureSizes.end()) {
+            resources.textureBytes -= texture->second;
+            resources.textures--;
+            textureSizes.erase(texture);
+        }
+    }
+    realDeleteTextures(n, textures);
+}
+
+void APIENTRY genVertexArrays(GLsizei n, GLuint *arrays) {
+    realGenVertexArrays(n, arrays);
+    for (GLsizei i = 0; i < n; ++i) {
+        vertexArrayElementBuffers[arrays[i]] = 0;
+    }
+    resources.vertexArrays += n;
+}
+
+void APIENTRY deleteVertexArrays(GLsizei n, const GLuint *arrays) {
+    for (GLsizei i = 0; i < n; ++i) {
+        if (vertexArrayElementBuffers.erase(arrays[i]) > 0) {
+            resources.vertexArrays--;
+        }
+    }
+    realDeleteVertexArrays(n, arrays);
+}
+
+}
+
+void GLStats::install() {
+    // Installing twice would wrap the wrappers
+    if (realDrawArrays != nullptr) {
+        return;
+    }
+    realDrawArrays = glad_glDrawArrays;                 glad_glDrawArrays = drawArrays;
+    realDrawElements = glad_glDrawElements;             glad_glDrawElements = drawElements;
+    realUseProgram = glad_glUseProgram;                 glad_glUseProgram = useProgram;
+    realActiveTexture = glad_glActiveTexture;           glad_glActiveTexture = activeTexture;
+    realBindTexture = glad_glBindTexture;               glad_glBindTexture = bindTexture;
+    realBindBuffer = glad_glBindBuffer;                 glad_glBindBuffer = bindBuffer;
+    realBindVertexArray = glad_glBindVertexArray;       glad_glBindVertexArray = bindVertexArray;
+    realBufferData = glad_glBufferData;                 glad_glBufferData = bufferData;
+    realBufferSubData = glad_glBufferSubData;           glad_glBufferSubData = bufferSubData;
+    realTexImage2D = glad_glTexImage2D;                 glad_glTexImage2D = texImage2D;
+    realGenBuffers = glad_glGenBuffers;                 glad_glGenBuffers = genBuffers;
+    realDeleteBuffers = glad_glDeleteBuffers;           glad_glDeleteBuffers = deleteBuffers;
+    realGenTextures = glad_glGenTextures;               glad_glGenTextures = genTextures;
+    realDeleteTextures = glad_glDeleteTextures;         glad_glDeleteTextures = deleteTextures;
+    realGenVertexArrays = glad_glGenVertexArrays;       glad_glGenVertexArrays = genVertexArrays;
+    realDeleteVertexArrays = glad_glDeleteVertexArrays; glad_glDeleteVertexArrays = deleteVertexArrays;
+}
+
+void GLStats::endFrame() {
+    lastFrame = frame;
+    frame = GLFrameStats();
+}
+
+GLFrameStats GLStats::getLastFrame()    { return lastFrame; }
+GLResourceStats GLStats::getResources() { return resources; }
+
+#endif //DODGEBALL_GL_STATS
@@ -0,0 +1,56 @@
+#ifndef GRAPHICS_GLSTATS_H
+#define GRAPHICS_GLSTATS_H
+
+/// @brief OpenGL call and resource statistics.
+/// @details When DODGEBALL_GL_STATS is defined, GLStats::install() wraps the GL functions loaded by glad so that
+/// draw calls, state changes, uploads and live objects are counted. Nothing is wrapped until install() is called.
+#ifdef DODGEBALL_GL_STATS
+
+#include <cstdint>
+
+/// @brief GL work submitted during one frame.
+struct GLFrameStats {
+    uint32_t drawCalls = 0;
+    /// @brief Vertices (or indices, for glDrawElements) submitted by the draw calls
+    uint64_t vertices = 0;
+    /// @brief glUseProgram calls that changed the current program
+    uint32_t programSwitches = 0;
+    uint32_t textureBinds = 0;
+    /// @brief glBufferData / glBufferSubData calls and the bytes they uploaded
+    uint32_t bufferUploads = 0;
+    uint64_t uploadedBytes = 0;
+};
+
+/// @brief GL objects that are currently alive and the memory they use.
+struct GLResourceStats {
+    uint32_t buffers = 0;
+    uint32_t textures = 0;
+    uint32_t vertexArrays = 0;
+    uint64_t bufferBytes = 0;
+    /// @brief Estimated from the size and format passed to glTexImage2D
+    uint64_t textureBytes = 0;
+};
+
+/**
+ * @brief Counts what the game asks OpenGL to do.
+ * @details Only call from the thread that owns the GL context.
+ */
+class GLStats {
+    public:
+        /// @brief Replaces glad's function pointers with counting wrappers.
+        /// @details Call right after gladLoadGLLoader(). Objects created before this aren't counted.
+        static void install();
+
+        /// @brief Stores this frame's counts (see getLastFrame()) and starts counting the next frame.
+        static void endFrame();
+
+        /// @brief Counts for the last finished frame.
+        static GLFrameStats getLastFrame();
+
+        /// @brief Objects alive right now.
+        static GLResourceStats getResources();
+};
+
+#endif //DODGEBALL_GL_STATS
+
+#endif //GRAPHICS_GLSTATS_H
@@ -0,0 +1,73 @@
+#include "histogram.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+// Values below EXACT_VALUES get a bucket each, then each power of two gets SUB_BUCKETS buckets
+const int SUB_BUCKET_BITS = 6;
+const int SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+const int EXACT_VALUES = SUB_BUCKETS * 2;
+
+int log2Floor(uint64_t value) {
+    int bits = 0;
+    while (value >>= 1) {
+        bits++;
+    }
+    return bits;
+}
+}
+
+Histogram::Histogram() : buckets(getBucket(MAX_VALUE) + 1, 0) {}
+
+int Histogram::getBucket(uint64_t value) {
+    if (value < EXACT_VALUES) {
+        return static_cast<int>(value);
+    }
+    // shift puts the value's top SUB_BUCKET_BITS + 1 bits in [SUB_BUCKETS, 2 * SUB_BUCKETS)
+    int shift = log2Floor(value) - SUB_BUCKET_BITS;
+    return EXACT_VALUES + (shift - 1) * SUB_BUCKETS + static_cast<int>((value >> shift) - SUB_BUCKETS);
+}
+
+uint64_t Histogram::getBucketMax(int bucket) {
+    if (bucket < EXACT_VALUES) {
+        return bucket;
+    }
+    int shift = (bucket - EXACT_VALUES) / SUB_BUCKETS + 1;
+    uint64_t subBucket = (bucket - EXACT_VALUES) % SUB_BUCKETS + SUB_BUCKETS;
+    return ((subBucket + 1) << shift) - 1;
+}
+
+void Histogram::record(uint64_t value) {
+    value = std::min(value, MAX_VALUE);
+    buckets[getBucket(value)]++;
+    count++;
+    sum += value;
+    max = std::max(max, value);
+}
+
+void Histogram::reset() {
+    std::fill(buckets.begin(), buckets.end(), 0);
+    count = 0;
+    max = 0;
+    sum = 0;
+}
+
+double Histogram::getMean() const {
+    return count == 0 ? 0 : double(sum) / count;
+}
+
+uint64_t Histogram::getPercentile(double percentile) const {
+    if (count == 0) {
+        return 0;
+    }
+    uint64_t target = static_cast<uint64_t>(std::ceil(percentile / 100.0 * count));
+    target = std::clamp<uint64_t>(target, 1, count);
+    uint64_t seen = 0;
+    for (size_t bucket = 0; bucket < buckets.size(); ++bucket) {
+        seen += buckets[bucket];
+        if (seen >= target) {
+            return std::min(getBucketMax(static_cast<int>(bucket)), max);
+        }
+    }
+    return max;
+}
@@ -0,0 +1,43 @@
+#ifndef GRAPHICS_HISTOGRAM_H
+#define GRAPHICS_HISTOGRAM_H
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Log-linear (HDR style) histogram of positive integers, e.g. frame times in microseconds.
+ * @details Values below 128 are counted exactly; above that every power of two is split into 64 buckets, so any
+ * percentile is within 1.6% of the real value. Recording never allocates and is O(1).
+ * Values above MAX_VALUE (about 67 seconds in microseconds) are counted as MAX_VALUE.
+ */
+class Histogram {
+    public:
+        static constexpr uint64_t MAX_VALUE = (uint64_t(1) << 26) - 1;
+
+        Histogram();
+
+        void record(uint64_t value);
+
+        /// @brief Removes every recorded value.
+        void reset();
+
+        uint64_t getCount() const { return count; }
+        uint64_t getMax() const   { return max; }
+        double getMean() const;
+
+        /// @brief Returns the value below which the given percent of the recorded values fall (0 if empty).
+        /// @param percentile 0 to 100 (e.g. 99.9)
+        uint64_t getPercentile(double percentile) const;
+
+    private:
+        static int getBucket(uint64_t value);
+        /// @brief The largest value that falls in the given bucket
+        static uint64_t getBucketMax(int bucket);
+
+        std::vector<uint64_t> buckets;
+        uint64_t count = 0;
+        uint64_t max = 0;
+        uint64_t sum = 0;
+};
+
+#endif //GRAPHICS_HISTOGRAM_H
@@ -0,0 +1,135 @@
+#include "jobSystem.h"
+#include <algorithm>
+
+namespace {
+thread_local int threadIndex = 0;
+}
+
+bool JobSystem::Queue::push(Job job) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (count == QUEUE_CAPACITY) {
+        return false;
+    }
+    jobs[(first + count) % QUEUE_CAPACITY] = job;
+    count++;
+    return true;
+}
+
+bool JobSystem::Queue::popNewest(Job &job) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (count == 0) {
+        return false;
+    }
+    count--;
+    job = jobs[(first + count) % QUEUE_CAPACITY];
+    return true;
+}
+
+bool JobSystem::Queue::popOldest(Job &job) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (count == 0) {
+        return false;
+    }
+    job = jobs[first];
+    first = (first + 1) % QUEUE_CAPACITY;
+    count--;
+    return true;
+}
+
+JobSystem::JobSystem(int workerCount) {
+    workerCount = std::max(0, workerCount);
+    for (int i = 0; i <= workerCount; ++i) {
+        queues.push_back(std::make_unique<Queue>());
+    }
+    workers.reserve(workerCount);
+    for (int i = 1; i <= workerCount; ++i) {
+        workers.emplace_back(&JobSystem::work, this, i);
+    }
+}
+
+JobSystem::~JobSystem() {
+    // Jobs still queued run on the main thread
+    runUntil([this] { return queued == 0 && queuedMain == 0; });
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        stopping = true;
+    }
+    awake.notify_all();
+    for (std::thread &worker : workers) {
+        worker.join();
+    }
+}
+
+void JobSystem::submit(Job job) {
+    Queue &queue = *queues[std::min<size_t>(threadIndex, queues.size() - 1)];
+    if (!queue.push(job)) {
+        job.function(job.data);
+        return;
+    }
+    queued++;
+    wake();
+}
+
+void JobSystem::submitMain(Job job) {
+    if (!mainQueue.push(job)) {
+        // Can't run it here unless this is the main thread, so wait for room
+        while (!mainQueue.push(job)) {
+            std::this_thread::yield();
+        }
+    }
+    queuedMain++;
+    wake();
+}
+
+void JobSystem::wake() {
+    // Taking the lock makes sure a thread that just found nothing to do is already waiting (and gets notified)
+    { std::lock_guard<std::mutex> lock(sleepMutex); }
+    awake.notify_all();
+}
+
+bool JobSystem::runMainOrAny() {
+    Job job;
+    if (mainQueue.popOldest(job)) {
+        queuedMain--;
+        job.function(job.data);
+        return true;
+    }
+    return runOne(0);
+}
+
+bool JobSystem::runOne(int index) {
+    Job job;
+    bool found = queues[index]->popNewest(job);
+    // Steal from the others, starting with the next thread so thieves spread out
+    for (size_t i = 1; !found && i < queues.size(); ++i) {
+        found = queues[(index + i) % queues.size()]->popOldest(job);
+    }
+    if (!found) {
+        return false;
+    }
+    queued--;
+    job.function(job.data);
+    return true;
+}
+
+void JobSystem::work(int index) {
+    threadIndex = index;
+    while (true) {
+        if (runOne(index)) {
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        awake.wait(lock, [this] { return stopping || queued > 0; });
+        if (stopping && queued == 0) {
+            return;
+        }
+    }
+}
+
+int JobSystem::getThreadIndex() {
+    return threadIndex;
+}
+
+int JobSystem::getDefaultWorkerCount() {
+    return std::max(1, static_cast<int>(std::thread::hardware_concurrency()) - 1);
+}
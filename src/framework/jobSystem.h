@@ -0,0 +1,106 @@
+#ifndef GRAPHICS_JOBSYSTEM_H
+#define GRAPHICS_JOBSYSTEM_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using std::vector;
+
+/// @brief A function and its argument (plain data, so queueing a job never allocates).
+struct Job {
+    void (*function)(void *data) = nullptr;
+    void *data = nullptr;
+};
+
+/**
+ * @brief Work stealing scheduler for small, short jobs (the tasks of one frame).
+ * @details Every thread has its own queue: it runs its newest job first and, when its queue is empty, steals the
+ * oldest job from another thread's queue. The main thread (the one that created the system) takes part while it
+ * waits in runUntil(), and is the only one that runs jobs submitted with submitMain() (e.g. OpenGL calls).
+ * Use ThreadPool instead for long independent tasks.
+ */
+class JobSystem {
+    public:
+        /// @brief Jobs each queue holds (a job submitted to a full queue runs right away instead)
+        static constexpr size_t QUEUE_CAPACITY = 256;
+
+        /// @param workerCount Threads besides the main thread (0 runs everything on the main thread)
+        explicit JobSystem(int workerCount = getDefaultWorkerCount());
+
+        /// @brief Finishes every queued job, then stops the workers.
+        ~JobSystem();
+
+        JobSystem(const JobSystem &) = delete;
+        JobSystem &operator=(const JobSystem &) = delete;
+
+        /// @brief Queues a job that can run on any thread (on the calling thread's queue).
+        void submit(Job job);
+
+        /// @brief Queues a job that only the main thread runs.
+        void submitMain(Job job);
+
+        /// @brief Runs jobs on the main thread until done() returns true.
+        /// @details Sleeps when there's nothing to run, so whatever makes done() true must call wake() afterwards.
+        template <typename DoneFunction>
+        void runUntil(DoneFunction done) {
+            while (!done()) {
+                if (runMainOrAny()) {
+                    continue;
+                }
+                std::unique_lock<std::mutex> lock(sleepMutex);
+                awake.wait(lock, [&] { return queuedMain > 0 || queued > 0 || done(); });
+            }
+        }
+
+        /// @brief Wakes threads sleeping in runUntil() so they check their condition again.
+        void wake();
+
+        int getWorkerCount() const { return static_cast<int>(workers.size()); }
+
+        /// @brief The calling thread's index (0 for the main thread or any other thread, 1.. for the workers).
+        static int getThreadIndex();
+
+        /// @brief One worker per hardware thread, besides the main thread.
+        static int getDefaultWorkerCount();
+
+    private:
+        /// @brief One thread's jobs (a ring buffer behind a mutex).
+        struct Queue {
+            std::mutex mutex;
+            Job jobs[QUEUE_CAPACITY];
+            size_t first = 0;
+            size_t count = 0;
+
+            bool push(Job job);
+            /// @brief Takes the newest job (the owner)
+            bool popNewest(Job &job);
+            /// @brief Takes the oldest job (other threads)
+            bool popOldest(Job &job);
+        };
+
+        void work(int index);
+        /// @brief Runs one job from the thread's queue or stolen from another one.
+        /// @return false if every queue was empty
+        bool runOne(int index);
+        /// @brief Runs one main thread only job, or else any job (main thread).
+        bool runMainOrAny();
+
+        /// @brief Queue of every thread (0 is the main thread's), and the main thread only jobs
+        vector<std::unique_ptr<Queue>> queues;
+        Queue mainQueue;
+        vector<std::thread> workers;
+
+        /// @brief Jobs in queues (not counting mainQueue), and in mainQueue
+        std::atomic<int> queued{0};
+        std::atomic<int> queuedMain{0};
+        std::mutex sleepMutex;
+        std::condition_variable awake;
+        bool stopping = false;
+};
+
+#endif //GRAPHICS_JOBSYSTEM_H
@@ -0,0 +1,322 @@
+#include "log.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <iostream>
+
+namespace {
+const char *LEVEL_NAMES[] = {"DEBUG", "INFO", "WARNING", "ERROR"};
+
+/// @brief File name without its directories (__FILE__ is a full path with some compilers)
+const char *getFileName(const char *path) {
+    const char *name = path;
+    for (const char *c = path; *c != '\0'; ++c) {
+        if (*c == '/' || *c == '\\') {
+            name = c + 1;
+        }
+    }
+    return name;
+}
+}
+
+// --------------------------------------------------------
+// LogBuffer
+// --------------------------------------------------------
+
+LogRecord *LogBuffer::reserve() {
+    size_t currentHead = head.load(std::memory_order_relaxed);
+    if (currentHead - tail.load(std::memory_order_acquire) == CAPACITY) {
+        return nullptr;
+    }
+    return &records[currentHead % CAPACITY];
+}
+
+void LogBuffer::commit() {
+    head.store(head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+bool LogBuffer::pop(LogRecord &record) {
+    size_t currentTail = tail.load(std::memory_order_relaxed);
+    if (currentTail == head.load(std::memory_order_acquire)) {
+        return false;
+    }
+    const LogRecord &source = records[currentTail % CAPACITY];
+    // Only the used part of the payload is copied
+    memcpy(&record, &source, offsetof(LogRecord, payload) + source.size);
+    tail.store(currentTail + 1, std::memory_order_release);
+    return true;
+}
+
+// --------------------------------------------------------
+// Log
+// --------------------------------------------------------
+
+Log::Log() : epoch(std::chrono::steady_clock::now()) {
+    pending.reserve(LogBuffer::CAPACITY);
+    writer = std::thread(&Log::run, this);
+}
+
+Log::~Log() {
+    {
+        std::lock_guard<std::mutex> lock(writerMutex);
+        stopping = true;
+    }
+    wakeWriter.notify_one();
+    writer.join();
+}
+
+Log &Log::get() {
+    static Log log;
+    return log;
+}
+
+int64_t Log::now() const {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count();
+}
+
+LogBuffer *Log::getThreadBuffer() {
+    // Hands the buffer back when the thread exits so short-lived worker threads don't leak buffers
+    struct ThreadBuffer {
+        LogBuffer *buffer = nullptr;
+        ~ThreadBuffer() {
+            if (buffer != nullptr) {
+                buffer->inUse.store(false, std::memory_order_release);
+            }
+        }
+    };
+    thread_local ThreadBuffer threadBuffer;
+
+    if (threadBuffer.buffer == nullptr) {
+        std::lock_guard<std::mutex> lock(buffersMutex);
+        for (std::unique_ptr<LogBuffer> &buffer : buffers) {
+            if (!buffer->inUse.load(std::memory_order_acquire)) {
+                threadBuffer.buffer = buffer.get();
+                break;
+            }
+        }
+        if (threadBuffer.buffer == nullptr) {
+            buffers.push_back(std::make_unique<LogBuffer>());
+            buffers.back()->threadId = static_cast<uint32_t>(buffers.size() - 1);
+            threadBuffer.buffer = buffers.back().get();
+        }
+        threadBuffer.buffer->inUse.store(true, std::memory_order_release);
+    }
+    return threadBuffer.buffer;
+}
+
+LogRecord *Log::begin(LogSite &site, const char *format) {
+    int64_t time = now();
+
+    // The first message after the window ends starts a new one (only one thread wins the exchange)
+    int64_t windowStart = site.windowStart.load(std::memory_order_relaxed);
+    if (time - windowStart >= RATE_WINDOW &&
+        site.windowStart.compare_exchange_strong(windowStart, time, std::memory_order_relaxed)) {
+        site.count.store(0, std::memory_order_relaxed);
+    }
+    if (site.count.fetch_add(1, std::memory_order_relaxed) >= RATE_LIMIT) {
+        site.suppressed.fetch_add(1, std::memory_order_relaxed);
+        // Sites are only listed once they have something to report
+        bool registered = false;
+        if (site.registered.compare_exchange_strong(registered, true, std::memory_order_relaxed)) {
+            LogSite *head = sites.load(std::memory_order_relaxed);
+            do {
+                site.next = head;
+            } while (!sites.compare_exchange_weak(head, &site, std::memory_order_release, std::memory_order_relaxed));
+        }
+        return nullptr;
+    }
+
+    LogBuffer *buffer = getThreadBuffer();
+    LogRecord *record = buffer->reserve();
+    if (record == nullptr) {
+        droppedMessages.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+    record->time = time;
+    record->site = &site;
+    record->format = format;
+    record->threadId = buffer->threadId;
+    record->size = 0;
+    return record;
+}
+
+void Log::end(LogSite &site) {
+    getThreadBuffer()->commit();
+    // Errors are printed right away, everything else waits for the writer's next round
+    if (site.level >= LogLevel::error) {
+        {
+            // Set under the lock, or the writer could check it just before and miss the wake up
+            std::lock_guard<std::mutex> lock(writerMutex);
+            writeNow = true;
+        }
+        wakeWriter.notify_one();
+    }
+}
+
+void Log::addBytes(LogRecord &record, ArgumentType type, const void *data, size_t size) {
+    // Arguments that don't fit are left out (the format shows "{}" for them)
+    if (record.size + 1 + size > LogRecord::PAYLOAD_SIZE) {
+        return;
+    }
+    record.payload[record.size] = type;
+    memcpy(record.payload + record.size + 1, data, size);
+    record.size += static_cast<uint16_t>(1 + size);
+}
+
+void Log::addString(LogRecord &record, std::string_view text) {
+    size_t header = 1 + sizeof(uint16_t);
+    if (record.size + header > LogRecord::PAYLOAD_SIZE) {
+        return;
+    }
+    uint16_t length = static_cast<uint16_t>(std::min(text.size(), LogRecord::PAYLOAD_SIZE - record.size - header));
+    record.payload[record.size] = ARGUMENT_STRING;
+    memcpy(record.payload + record.size + 1, &length, sizeof(length));
+    memcpy(record.payload + record.size + header, text.data(), length);
+    record.size += static_cast<uint16_t>(header + length);
+}
+
+void Log::flush() {
+    std::unique_lock<std::mutex> lock(writerMutex);
+    // The drain after the one that may already be running started after everything queued so far
+    uint64_t target = drainsStarted + 1;
+    writeNow = true;
+    wakeWriter.notify_one();
+    drained.wait(lock, [this, target] { return drainsFinished >= target || stopping; });
+}
+
+void Log::run() {
+    std::unique_lock<std::mutex> lock(writerMutex);
+    while (true) {
+        wakeWriter.wait_for(lock, std::chrono::milliseconds(WRITE_INTERVAL_MS), [this] { return stopping || writeNow; });
+        bool finalDrain = stopping;
+        writeNow = false;
+        drainsStarted++;
+        lock.unlock();
+        drain(finalDrain);
+        lock.lock();
+        drainsFinished++;
+        drained.notify_all();
+        if (finalDrain) {
+            return;
+        }
+    }
+}
+
+void Log::drain(bool finalDrain) {
+    pending.clear();
+    {
+        std::lock_guard<std::mutex> lock(buffersMutex);
+        for (std::unique_ptr<LogBuffer> &buffer : buffers) {
+            pending.emplace_back();
+            while (buffer->pop(pending.back())) {
+                pending.emplace_back();
+            }
+            pending.pop_back();
+        }
+    }
+
+    // Each buffer is in order, but the threads' messages are interleaved by time
+    order.clear();
+    for (const LogRecord &record : pending) {
+        order.push_back(&record);
+    }
+    std::stable_sort(order.begin(), order.end(),
+                     [](const LogRecord *a, const LogRecord *b) { return a->time < b->time; });
+
+    text.clear();
+    for (const LogRecord *record : order) {
+        format(*record, text);
+    }
+
+    int64_t time = now();
+    char line[160];
+    for (LogSite *site = sites.load(std::memory_order_acquire); site != nullptr; site = site->next) {
+        if (!finalDrain && time - site->windowStart.load(std::memory_order_relaxed) < RATE_WINDOW) {
+            continue;
+        }
+        uint32_t suppressed = site->suppressed.exchange(0, std::memory_order_relaxed);
+        if (suppressed > 0) {
+            snprintf(line, sizeof(line), "[%10.3f] %s %s:%d | %u more messages like this were suppressed\n",
+                     time / 1e9, LEVEL_NAMES[static_cast<int>(site->level)], getFileName(site->file), site->line,
+                     suppressed);
+            text += line;
+        }
+    }
+    uint64_t dropped = droppedMessages.load(std::memory_order_relaxed);
+    if (dropped != reportedDropped) {
+        snprintf(line, sizeof(line), "[%10.3f] WARNING log | %llu messages dropped (log buffer full)\n", time / 1e9,
+                 static_cast<unsigned long long>(dropped - reportedDropped));
+        text += line;
+        reportedDropped = dropped;
+    }
+
+    if (!text.empty()) {
+        std::cout.write(text.data(), static_cast<std::streamsize>(text.size()));
+        std::cout.flush();
+    }
+}
+
+void Log::format(const LogRecord &record, std::string &out) const {
+    char number[64];
+    snprintf(number, sizeof(number), "[%10.3f] %s %s:%d | ", record.time / 1e9,
+             LEVEL_NAMES[static_cast<int>(record.site->level)], getFileName(record.site->file), record.site->line);
+    out += number;
+
+    size_t offset = 0;
+    for (const char *c = record.format; *c != '\0'; ++c) {
+        if (c[0] != '{' || c[1] != '}' || offset >= record.size) {
+            out += *c;
+            continue;
+        }
+        c++;
+        unsigned char type = record.payload[offset++];
+        const unsigned char *value = record.payload + offset;
+        switch (type) {
+            case ARGUMENT_INT: {
+                int64_t integer;
+                memcpy(&integer, value, sizeof(integer));
+                snprintf(number, sizeof(number), "%lld", static_cast<long long>(integer));
+                out += number;
+                offset += sizeof(integer);
+                break;
+            }
+            case ARGUMENT_UINT: {
+                uint64_t integer;
+                memcpy(&integer, value, sizeof(integer));
+                snprintf(number, sizeof(number), "%llu", static_cast<unsigned long long>(integer));
+                out += number;
+                offset += sizeof(integer);
+                break;
+            }
+            case ARGUMENT_DOUBLE: {
+                double real;
+                memcpy(&real, value, sizeof(real));
+                snprintf(number, sizeof(number), "%g", real);
+                out += number;
+                offset += sizeof(real);
+                break;
+            }
+            case ARGUMENT_BOOL:
+                out += *value ? "true" : "false";
+                offset += sizeof(bool);
+                break;
+            case ARGUMENT_CHAR:
+                out += static_cast<char>(*value);
+                offset += sizeof(char);
+                break;
+            case ARGUMENT_STRING: {
+                uint16_t length;
+                memcpy(&length, value, sizeof(length));
+                out.append(reinterpret_cast<const char *>(value + sizeof(length)), length);
+                offset += sizeof(length) + length;
+                break;
+            }
+        }
+    }
+
+    // Messages like shader info logs end with their own newline
+    while (!out.empty() && (out.back() == '\n' || out.back() == '\r')) {
+        out.pop_back();
+    }
+    out += '\n';
+}
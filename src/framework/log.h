@@ -0,0 +1,222 @@
+#ifndef GRAPHICS_LOG_H
+#define GRAPHICS_LOG_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+/// @brief Asynchronous logging.
+/// @details LOG_ERROR("Could not open {} ({})", path, code) copies the format and its arguments into the calling
+/// thread's ring buffer and returns; a background thread formats and prints them (to stdout) a few milliseconds
+/// later. "{}" is replaced by the next argument (integers, floats, bools, chars, C strings and std::string; strings
+/// longer than LogRecord::PAYLOAD_SIZE are cut short). Each LOG_ line prints at most Log::RATE_LIMIT messages per
+/// second; the rest are counted and reported as one line. Logging doesn't allocate (except the first time a thread
+/// logs), so it's safe in hot paths and ASSERT_NO_ALLOCATIONS blocks.
+#define LOG_AT(level, ...)                                                                                             \
+    do {                                                                                                               \
+        static LogSite logSite_{__FILE__, __LINE__, level};                                                            \
+        if (Log::get().isEnabled(level)) {                                                                             \
+            Log::get().write(logSite_, __VA_ARGS__);                                                                   \
+        }                                                                                                              \
+    } while (0)
+#define LOG_DEBUG(...) LOG_AT(LogLevel::debug, __VA_ARGS__)
+#define LOG_INFO(...) LOG_AT(LogLevel::info, __VA_ARGS__)
+#define LOG_WARNING(...) LOG_AT(LogLevel::warning, __VA_ARGS__)
+#define LOG_ERROR(...) LOG_AT(LogLevel::error, __VA_ARGS__)
+
+enum class LogLevel : uint8_t {
+    debug,
+    info,
+    warning,
+    error,
+};
+
+/// @brief One LOG_ line in the code (a static in the macro).
+struct LogSite {
+    const char *file;
+    int line;
+    LogLevel level;
+
+    /// @brief Start of the current rate limiting window (nanoseconds, Log::now())
+    std::atomic<int64_t> windowStart{0};
+    /// @brief Messages in the current window, and messages dropped because there were too many
+    std::atomic<uint32_t> count{0};
+    std::atomic<uint32_t> suppressed{0};
+    /// @brief Sites are kept in a list (the writer reports their suppressed messages)
+    std::atomic<bool> registered{false};
+    LogSite *next = nullptr;
+
+    LogSite(const char *file, int line, LogLevel level) : file(file), line(line), level(level) {}
+};
+
+/// @brief A message waiting to be formatted: the format and its arguments, each one a type byte and its value.
+struct LogRecord {
+    /// @brief Fills the record out to 1 KiB (room for a shader info log)
+    static constexpr size_t PAYLOAD_SIZE = 992;
+
+    int64_t time;
+    LogSite *site;
+    const char *format;
+    uint32_t threadId;
+    uint16_t size;
+    unsigned char payload[PAYLOAD_SIZE];
+};
+
+/**
+ * @brief Lock-free single producer / single consumer ring buffer of records (one per thread that logs).
+ */
+class LogBuffer {
+    public:
+        static const size_t CAPACITY = 256;
+
+        /// @brief Returns the next free record to fill in, or nullptr if the buffer is full (owning thread only).
+        LogRecord *reserve();
+        /// @brief Hands the reserved record to the writer.
+        void commit();
+
+        /// @brief Removes the oldest record (writer only).
+        /// @return false if the buffer is empty
+        bool pop(LogRecord &record);
+
+        uint32_t threadId = 0;
+        /// @brief false once the owning thread has exited (the buffer is then handed to the next new thread)
+        std::atomic<bool> inUse{false};
+
+    private:
+        LogRecord records[CAPACITY];
+        std::atomic<size_t> head{0};
+        std::atomic<size_t> tail{0};
+};
+
+/**
+ * @brief The logger shared by the whole program: per-thread buffers and the thread that prints them.
+ */
+class Log {
+    public:
+        /// @brief Messages each LOG_ line may print per second
+        static constexpr uint32_t RATE_LIMIT = 10;
+        static constexpr int64_t RATE_WINDOW = 1000000000;
+        /// @brief How often the writer wakes up to print (errors wake it right away)
+        static constexpr int WRITE_INTERVAL_MS = 10;
+
+        static Log &get();
+
+        /// @brief Prints everything still buffered, then stops the writer.
+        ~Log();
+
+        /// @brief Messages below this level are skipped (info by default).
+        void setLevel(LogLevel level) { minimumLevel.store(level, std::memory_order_relaxed); }
+        bool isEnabled(LogLevel level) const { return level >= minimumLevel.load(std::memory_order_relaxed); }
+
+        /// @brief Queues a message (use the LOG_ macros).
+        template <typename... Args>
+        void write(LogSite &site, const char *format, const Args &...args) {
+            LogRecord *record = begin(site, format);
+            if (record == nullptr) {
+                return;
+            }
+            (add(*record, args), ...);
+            end(site);
+        }
+
+        /// @brief Blocks until every message queued so far has been printed.
+        void flush();
+
+        /// @brief Messages dropped because a thread's buffer was full.
+        uint64_t getDroppedMessages() const { return droppedMessages.load(std::memory_order_relaxed); }
+
+        /// @brief Nanoseconds since the logger started (steady clock).
+        int64_t now() const;
+
+    private:
+        Log();
+
+        enum ArgumentType : unsigned char {
+            ARGUMENT_INT,
+            ARGUMENT_UINT,
+            ARGUMENT_DOUBLE,
+            ARGUMENT_BOOL,
+            ARGUMENT_CHAR,
+            ARGUMENT_STRING,
+        };
+
+        /// @brief Rate limits the site and reserves a record.
+        /// @return nullptr if the message is dropped
+        LogRecord *begin(LogSite &site, const char *format);
+        void end(LogSite &site);
+
+        template <typename T>
+        static void add(LogRecord &record, const T &value) {
+            if constexpr (std::is_same_v<T, bool>) {
+                addBytes(record, ARGUMENT_BOOL, &value, sizeof(value));
+            }
+            else if constexpr (std::is_same_v<T, char>) {
+                addBytes(record, ARGUMENT_CHAR, &value, sizeof(value));
+            }
+            else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>) {
+                int64_t wide = value;
+                addBytes(record, ARGUMENT_INT, &wide, sizeof(wide));
+            }
+            else if constexpr (std::is_integral_v<T>) {
+                uint64_t wide = value;
+                addBytes(record, ARGUMENT_UINT, &wide, sizeof(wide));
+            }
+            else if constexpr (std::is_enum_v<T>) {
+                int64_t wide = static_cast<int64_t>(value);
+                addBytes(record, ARGUMENT_INT, &wide, sizeof(wide));
+            }
+            else if constexpr (std::is_floating_point_v<T>) {
+                double wide = value;
+                addBytes(record, ARGUMENT_DOUBLE, &wide, sizeof(wide));
+            }
+            else {
+                addString(record, std::string_view(value));
+            }
+        }
+        static void addBytes(LogRecord &record, ArgumentType type, const void *data, size_t size);
+        static void addString(LogRecord &record, std::string_view text);
+
+        LogBuffer *getThreadBuffer();
+        /// @brief Writer thread
+        void run();
+        /// @brief Prints every buffered record, and the suppressed counts of sites whose window is over.
+        void drain(bool finalDrain);
+        void format(const LogRecord &record, std::string &out) const;
+
+        const std::chrono::steady_clock::time_point epoch;
+        std::atomic<LogLevel> minimumLevel{LogLevel::info};
+        std::atomic<uint64_t> droppedMessages{0};
+        uint64_t reportedDropped = 0;
+
+        /// @brief Guards buffers (only locked when a thread claims a buffer or the writer drains)
+        std::mutex buffersMutex;
+        std::vector<std::unique_ptr<LogBuffer>> buffers;
+        std::atomic<LogSite *> sites{nullptr};
+
+        std::thread writer;
+        std::mutex writerMutex;
+        std::condition_variable wakeWriter;
+        std::condition_variable drained;
+        bool stopping = false;
+        bool writeNow = false;
+        /// @brief Drains the writer has started and finished (flush() waits for one that starts after it's called)
+        uint64_t drainsStarted = 0;
+        uint64_t drainsFinished = 0;
+
+        /// @brief Writer scratch space (reused, so printing doesn't allocate once it has grown)
+        std::vector<LogRecord> pending;
+        std::vector<const LogRecord *> order;
+        std::string text;
+};
+
+#endif //GRAPHICS_LOG_H
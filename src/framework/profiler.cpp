@@ -0,0 +1,256 @@
+#include "profiler.h"
+
+#ifdef DODGEBALL_PROFILER
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+// --------------------------------------------------------
+// ProfileBuffer
+// --------------------------------------------------------
+
+bool ProfileBuffer::push(const ProfileEvent &event) {
+    size_t currentHead = head.load(std::memory_order_relaxed);
+    if (currentHead - tail.load(std::memory_order_acquire) == CAPACITY) {
+        return false;
+    }
+    events[currentHead % CAPACITY] = event;
+    head.store(currentHead + 1, std::memory_order_release);
+    return true;
+}
+
+bool ProfileBuffer::pop(ProfileEvent &event) {
+    size_t currentTail = tail.load(std::memory_order_relaxed);
+    if (currentTail == head.load(std::memory_order_acquire)) {
+        return false;
+    }
+    event = events[currentTail % CAPACITY];
+    tail.store(currentTail + 1, std::memory_order_release);
+    return true;
+}
+
+// --------------------------------------------------------
+// Profiler
+// --------------------------------------------------------
+
+Profiler::Profiler() : epoch(std::chrono::steady_clock::now()) {
+    // Reserved so a reference from getStats() stays valid while new scopes are added
+    stats.reserve(MAX_SCOPES);
+}
+
+Profiler &Profiler::get() {
+    static Profiler profiler;
+    return profiler;
+}
+
+int64_t Profiler::now() const {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count();
+}
+
+ProfileBuffer &Profiler::getThreadBuffer() {
+    // Hands the buffer back when the thread exits so short-lived worker threads don't leak buffers
+    struct ThreadBuffer {
+        ProfileBuffer *buffer = nullptr;
+        ~ThreadBuffer() {
+            if (buffer != nullptr) {
+                buffer->inUse.store(false, std::memory_order_release);
+            }
+        }
+    };
+    thread_local ThreadBuffer threadBuffer;
+
+    if (threadBuffer.buffer == nullptr) {
+        std::lock_guard<std::mutex> lock(buffersMutex);
+        for (std::unique_ptr<ProfileBuffer> &buffer : buffers) {
+            if (!buffer->inUse.load(std::memory_order_acquire)) {
+                threadBuffer.buffer = buffer.get();
+                break;
+            }
+        }
+        if (threadBuffer.buffer == nullptr) {
+            buffers.push_back(std::make_unique<ProfileBuffer>());
+            buffers.back()->threadId = static_cast<uint32_t>(buffers.size() - 1);
+            threadBuffer.buffer = buffers.back().get();
+        }
+        threadBuffer.buffer->depth = 0;
+        threadBuffer.buffer->inUse.store(true, std::memory_order_release);
+    }
+    return *threadBuffer.buffer;
+}
+
+void Profiler::endFrame() {
+    {
+        std::lock_guard<std::mutex> lock(buffersMutex);
+        ProfileEvent event;
+        for (std::unique_ptr<ProfileBuffer> &buffer : buffers) {
+            while (buffer->pop(event)) {
+                ScopeStats &scope = findStats(event.name);
+                scope.frameTotal += (event.end - event.start) / 1e6f;
+                scope.frameAllocations += event.allocations;
+                scope.frameAllocatedBytes += event.allocatedBytes;
+                scope.ranThisFrame = true;
+                if (captureFramesLeft > 0) {
+                    captured.push_back({event, frame});
+                }
+            }
+        }
+    }
+    frame++;
+
+    if (captureFramesLeft > 0 && --captureFramesLeft == 0) {
+        writeCapture();
+    }
+
+    // Scopes that didn't run this frame (e.g. a different screen) keep their old statistics
+    for (ScopeStats &scope : stats) {
+        if (scope.ranThisFrame) {
+            updateStats(scope);
+        }
+        scope.frameTotal = 0;
+        scope.frameAllocations = 0;
+        scope.frameAllocatedBytes = 0;
+        scope.ranThisFrame = false;
+    }
+}
+
+ScopeStats &Profiler::findStats(const char *name) {
+    for (ScopeStats &scope : stats) {
+        // Names are literals, but the same literal can have a different address in another translation unit
+        if (scope.name == name || std::strcmp(scope.name, name) == 0) {
+            return scope;
+        }
+    }
+    if (stats.size() == MAX_SCOPES) {
+        return stats.back();
+    }
+    stats.emplace_back();
+    // The last one left counts every scope that doesn't get its own (instead of mixing them into a real scope)
+    stats.back().name = stats.size() == MAX_SCOPES ? OVERFLOW_SCOPE : name;
+    return stats.back();
+}
+
+void Profiler::updateStats(ScopeStats &scope) {
+    scope.samples[scope.nextSample] = scope.frameTotal;
+    scope.nextSample = (scope.nextSample + 1) % ScopeStats::WINDOW;
+    scope.allocations = scope.frameAllocations;
+    scope.allocatedBytes = scope.frameAllocatedBytes;
+    scope.sampleCount = std::min(scope.sampleCount + 1, ScopeStats::WINDOW);
+
+    float sorted[ScopeStats::WINDOW];
+    float sum = 0;
+    for (int i = 0; i < scope.sampleCount; ++i) {
+        sorted[i] = scope.samples[i];
+        sum += scope.samples[i];
+    }
+    int p95Index = (scope.sampleCount * 95) / 100;
+    if (p95Index >= scope.sampleCount) {
+        p95Index = scope.sampleCount - 1;
+    }
+    std::nth_element(sorted, sorted + p95Index, sorted + scope.sampleCount);
+
+    scope.average = sum / scope.sampleCount;
+    scope.p95 = sorted[p95Index];
+    scope.max = *std::max_element(sorted, sorted + scope.sampleCount);
+}
+
+void Profiler::startCapture(int frames, const std::string &path) {
+    captured.clear();
+    // Enough room for a few dozen scopes a frame, so recording doesn't reallocate mid-capture
+    captured.reserve(static_cast<size_t>(frames) * 64);
+    captureFramesLeft = frames;
+    capturePath = path;
+    std::cout << "Capturing " << frames << " frames to " << path << std::endl;
+}
+
+void Profiler::stopCapture() {
+    if (captureFramesLeft > 0) {
+        captureFramesLeft = 0;
+        writeCapture();
+    }
+}
+
+bool Profiler::isCapturing() const { return captureFramesLeft > 0; }
+
+void Profiler::writeCapture() {
+    std::ofstream out(capturePath);
+    if (!out) {
+        std::cout << "Error opening trace file " << capturePath << std::endl;
+        return;
+    }
+
+    // Complete ("X") events with microsecond timestamps, one row per thread
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    out << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"Dodge Ball Survival\"}}";
+    char line[256];
+    for (const CapturedEvent &captureEvent : captured) {
+        const ProfileEvent &event = captureEvent.event;
+        snprintf(line, sizeof(line),
+                 ",\n{\"name\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%u,"
+                 "\"args\":{\"frame\":%llu,\"allocations\":%u,\"allocatedBytes\":%llu}}",
+                 event.name, event.start / 1000.0, (event.end - event.start) / 1000.0, event.threadId,
+                 static_cast<unsigned long long>(captureEvent.frame), event.allocations,
+                 static_cast<unsigned long long>(event.allocatedBytes));
+        out << line;
+    }
+    out << "\n]}\n";
+
+    std::cout << "Wrote " << captured.size() << " trace events to " << capturePath << std::endl;
+    captured.clear();
+    captured.shrink_to_fit();
+}
+
+void Profiler::addEvent(const std::string &name, std::chrono::steady_clock::time_point start,
+                        std::chrono::steady_clock::time_point end, uint32_t track) {
+    const char *storedName = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(namesMutex);
+        for (const std::string &stored : names) {
+            if (stored == name) {
+                storedName = stored.c_str();
+                break;
+            }
+        }
+        if (storedName == nullptr) {
+            storedName = names.emplace_back(name).c_str();
+        }
+    }
+    ProfileEvent event = {storedName, std::chrono::duration_cast<std::chrono::nanoseconds>(start - epoch).count(),
+                          std::chrono::duration_cast<std::chrono::nanoseconds>(end - epoch).count(), track, 0, 0, 0};
+    if (!getThreadBuffer().push(event)) {
+        countDroppedEvent();
+    }
+}
+
+const std::vector<ScopeStats> &Profiler::getStats() const { return stats; }
+uint64_t Profiler::getDroppedEvents() const                { return droppedEvents.load(std::memory_order_relaxed); }
+void Profiler::countDroppedEvent()                         { droppedEvents.fetch_add(1, std::memory_order_relaxed); }
+
+// --------------------------------------------------------
+// ProfileScope
+// --------------------------------------------------------
+
+ProfileScope::ProfileScope(const char *name) :
+    name(name), buffer(Profiler::get().getThreadBuffer()), start(Profiler::get().now()) {
+    buffer.depth++;
+#ifdef DODGEBALL_ALLOCATION_TRACKING
+    startAllocations = AllocationTracker::getThreadAllocations();
+    startBytes = AllocationTracker::getThreadBytes();
+#endif
+}
+
+ProfileScope::~ProfileScope() {
+    buffer.depth--;
+    ProfileEvent event = {name, start, Profiler::get().now(), buffer.threadId, buffer.depth, 0, 0};
+#ifdef DODGEBALL_ALLOCATION_TRACKING
+    event.allocations = static_cast<uint32_t>(AllocationTracker::getThreadAllocations() - startAllocations);
+    event.allocatedBytes = AllocationTracker::getThreadBytes() - startBytes;
+#endif
+    if (!buffer.push(event)) {
+        Profiler::get().countDroppedEvent();
+    }
+}
+
+#endif //DODGEBALL_PROFILER
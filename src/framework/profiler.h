@@ -0,0 +1,203 @@
+#ifndef GRAPHICS_PROFILER_H
+#define GRAPHICS_PROFILER_H
+
+/// @brief Frame profiler.
+/// @details Put PROFILE_SCOPE("name") at the top of a block to time it, and call PROFILE_FRAME() once per frame.
+/// When DODGEBALL_PROFILER is not defined both macros compile to nothing.
+#ifdef DODGEBALL_PROFILER
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "allocationTracker.h"
+
+#define PROFILE_CONCAT_(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_(a, b)
+#define PROFILE_SCOPE(name) ProfileScope PROFILE_CONCAT(profileScope, __LINE__)(name)
+#define PROFILE_FRAME() Profiler::get().endFrame()
+#define PROFILE_EVENT(name, start, end, track) Profiler::get().addEvent(name, start, end, track)
+
+/// @brief One timed scope.
+struct ProfileEvent {
+    /// @brief Name of the scope (must be a string literal)
+    const char *name;
+    /// @brief Start and end time in nanoseconds since the profiler started
+    int64_t start;
+    int64_t end;
+    /// @brief The thread the scope ran on (0 is the first thread that used the profiler)
+    uint32_t threadId;
+    /// @brief How many scopes this one is nested in
+    uint32_t depth;
+    /// @brief Heap allocations made on this thread while the scope ran (including nested scopes)
+    /// @details Always 0 without DODGEBALL_ALLOCATION_TRACKING
+    uint32_t allocations;
+    uint64_t allocatedBytes;
+};
+
+/**
+ * @brief Lock-free single producer / single consumer ring buffer of events.
+ * @details Each thread writes to its own buffer; the profiler drains every buffer at the end of the frame.
+ */
+class ProfileBuffer {
+    public:
+        static const size_t CAPACITY = 1 << 13;
+
+        /// @brief Adds an event (owning thread only).
+        /// @return false if the buffer is full and the event was dropped
+        bool push(const ProfileEvent &event);
+
+        /// @brief Removes the oldest event (profiler only).
+        /// @return false if the buffer is empty
+        bool pop(ProfileEvent &event);
+
+        uint32_t threadId = 0;
+        /// @brief Current nesting depth of the owning thread
+        uint32_t depth = 0;
+        /// @brief false once the owning thread has exited (the buffer is then handed to the next new thread)
+        std::atomic<bool> inUse{false};
+
+    private:
+        ProfileEvent events[CAPACITY];
+        std::atomic<size_t> head{0};
+        std::atomic<size_t> tail{0};
+};
+
+/// @brief Rolling statistics for one scope (per-frame totals over the last WINDOW frames).
+struct ScopeStats {
+    static constexpr int WINDOW = 120;
+
+    const char *name = nullptr;
+    /// @brief Average, 95th percentile and max time per frame in milliseconds
+    float average = 0, p95 = 0, max = 0;
+
+    float samples[WINDOW] = {};
+    int sampleCount = 0;
+    int nextSample = 0;
+    /// @brief Heap allocations and bytes in the scope during the last frame it ran
+    uint64_t allocations = 0, allocatedBytes = 0;
+
+    /// @brief Time spent in the scope so far this frame
+    float frameTotal = 0;
+    uint64_t frameAllocations = 0, frameAllocatedBytes = 0;
+    bool ranThisFrame = false;
+};
+
+/**
+ * @brief Collects the events from every thread and keeps rolling per-scope statistics.
+ */
+class Profiler {
+    public:
+        /// @brief Scopes with their own statistics; events of any scope past the first MAX_SCOPES - 1 are added
+        /// together under OVERFLOW_SCOPE (the last entry)
+        static const int MAX_SCOPES = 64;
+        static constexpr const char *OVERFLOW_SCOPE = "(other scopes)";
+
+        /// @brief Returns the profiler shared by the whole program.
+        static Profiler &get();
+
+        /// @brief Nanoseconds since the profiler started (steady clock).
+        int64_t now() const;
+
+        /// @brief Returns this thread's event buffer (claimed on first use).
+        ProfileBuffer &getThreadBuffer();
+
+        /// @brief Drains every thread's events and updates the statistics.
+        /// @details Call once per frame, from the main thread, after the frame's scopes have closed.
+        void endFrame();
+
+        /// @brief Statistics for every scope seen so far (in the order they were first seen).
+        const std::vector<ScopeStats> &getStats() const;
+
+        /// @brief Records work that wasn't timed by a scope (e.g. shaders the driver compiled in the background).
+        /// @param name Copied once per distinct name, so it doesn't have to be a literal
+        /// @param track Row the event is shown on in traces (above the thread ids, so it doesn't overlap their scopes)
+        void addEvent(const std::string &name, std::chrono::steady_clock::time_point start,
+                      std::chrono::steady_clock::time_point end, uint32_t track);
+
+        /// @brief Number of events dropped because a thread's buffer was full.
+        uint64_t getDroppedEvents() const;
+        void countDroppedEvent();
+
+        // --------------------------------------------------------
+        // Chrome trace capture
+        // --------------------------------------------------------
+
+        /// @brief Records every event for the next frames and writes them as Chrome trace-event JSON.
+        /// @details Open the file in Perfetto (ui.perfetto.dev) or chrome://tracing.
+        /// Events recorded before the first endFrame() (e.g. asset loading at startup) are part of frame 0.
+        /// @param frames Number of frames to capture
+        /// @param path The file to write when the capture finishes
+        void startCapture(int frames, const std::string &path);
+
+        /// @brief Ends the capture early and writes what was recorded so far.
+        void stopCapture();
+
+        /// @brief Returns true while a capture is running.
+        bool isCapturing() const;
+
+    private:
+        /// @brief Writes captured to capturePath.
+        void writeCapture();
+        Profiler();
+
+        ScopeStats &findStats(const char *name);
+        void updateStats(ScopeStats &stats);
+
+        const std::chrono::steady_clock::time_point epoch;
+
+        /// @brief Guards buffers (only locked when a thread claims a buffer or a frame ends)
+        std::mutex buffersMutex;
+        std::vector<std::unique_ptr<ProfileBuffer>> buffers;
+
+        std::vector<ScopeStats> stats;
+        std::atomic<uint64_t> droppedEvents{0};
+        /// @brief Names given to addEvent() (a deque never moves its strings, so events can point at them)
+        std::mutex namesMutex;
+        std::deque<std::string> names;
+
+        /// @brief Frame number endFrame() is collecting events for
+        uint64_t frame = 0;
+
+        /// @brief Events (and the frame they were drained in) recorded during a capture
+        struct CapturedEvent {
+            ProfileEvent event;
+            uint64_t frame;
+        };
+        std::vector<CapturedEvent> captured;
+        int captureFramesLeft = 0;
+        std::string capturePath;
+};
+
+/// @brief Times the enclosing block (use PROFILE_SCOPE instead of using this directly).
+class ProfileScope {
+    public:
+        explicit ProfileScope(const char *name);
+        ~ProfileScope();
+
+        ProfileScope(const ProfileScope &) = delete;
+        ProfileScope &operator=(const ProfileScope &) = delete;
+
+    private:
+        const char *name;
+        ProfileBuffer &buffer;
+        int64_t start;
+#ifdef DODGEBALL_ALLOCATION_TRACKING
+        uint64_t startAllocations;
+        uint64_t startBytes;
+#endif
+};
+
+#else
+
+#define PROFILE_SCOPE(name)
+#define PROFILE_FRAME()
+#define PROFILE_EVENT(name, start, end, track)
+
+#endif //DODGEBALL_PROFILER
+
+#endif //GRAPHICS_PROFILER_H
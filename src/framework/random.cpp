@@ -0,0 +1,77 @@
+#include "random.h"
+#include <random>
+
+// splitmix64, used to expand a seed into the generator's state
+static uint64_t splitMix(uint64_t &x) {
+    uint64_t z = (x += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+static inline uint64_t rotl(uint64_t x, int k) {
+    return (x << k) | (x >> (64 - k));
+}
+
+Random::Random(uint64_t seed) {
+    this->seed(seed);
+}
+
+void Random::seed(uint64_t seed) {
+    initialSeed = seed;
+    uint64_t x = seed;
+    for (uint64_t &s : state.s) {
+        s = splitMix(x);
+    }
+}
+
+uint64_t Random::getSeed() const { return initialSeed; }
+
+uint64_t Random::next() {
+    uint64_t *s = state.s;
+    const uint64_t result = rotl(s[1] * 5, 7) * 9;
+    const uint64_t t = s[1] << 17;
+
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rotl(s[3], 45);
+
+    return result;
+}
+
+int Random::nextInt(int max) {
+    // Multiply-shift maps the top 32 bits onto [0, max) without a division
+    return static_cast<int>(((next() >> 32) * static_cast<uint64_t>(max)) >> 32);
+}
+
+float Random::nextFloat() {
+    // The top 24 bits fill a float's mantissa exactly
+    return static_cast<float>(next() >> 40) * (1.0f / 16777216.0f);
+}
+
+float Random::nextFloat(float min, float max) {
+    return min + (max - min) * nextFloat();
+}
+
+void Random::fillUniform(float *out, size_t count, float min, float max) {
+    const float range = max - min;
+    for (size_t i = 0; i < count; ++i) {
+        out[i] = min + range * nextFloat();
+    }
+}
+
+Random::State Random::getState() const     { return state; }
+void Random::setState(const State &state)  { this->state = state; }
+
+uint64_t Random::randomSeed() {
+    std::random_device rd;
+    return (static_cast<uint64_t>(rd()) << 32) ^ rd();
+}
+
+uint64_t Random::mix(uint64_t a, uint64_t b) {
+    uint64_t x = a ^ (b * 0x9E3779B97F4A7C15ull);
+    return splitMix(x);
+}
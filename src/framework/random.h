@@ -0,0 +1,58 @@
+#ifndef GRAPHICS_RANDOM_H
+#define GRAPHICS_RANDOM_H
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Fast seedable random number generator (xoshiro256**).
+ * @details The same seed always produces the same sequence, so a recorded seed reproduces a level.
+ * Not thread safe: give each thread its own generator (e.g. seeded with Random::mix()).
+ */
+class Random {
+    public:
+        /// @brief The generator's internal state (can be saved and restored to rewind the sequence).
+        struct State {
+            uint64_t s[4];
+        };
+
+        /// @brief Construct a generator from a seed.
+        explicit Random(uint64_t seed = 0);
+
+        /// @brief Restarts the sequence from a new seed.
+        void seed(uint64_t seed);
+
+        /// @brief Returns the seed the generator was last seeded with.
+        uint64_t getSeed() const;
+
+        /// @brief Returns the next 64 random bits.
+        uint64_t next();
+
+        /// @brief Returns a random integer in [0, max).
+        int nextInt(int max);
+
+        /// @brief Returns a random float in [0, 1).
+        float nextFloat();
+
+        /// @brief Returns a random float in [min, max).
+        float nextFloat(float min, float max);
+
+        /// @brief Fills an array with random floats in [min, max).
+        /// @details Used to generate spawn data one field at a time.
+        void fillUniform(float *out, size_t count, float min, float max);
+
+        State getState() const;
+        void setState(const State &state);
+
+        /// @brief Returns a seed from the operating system (only use this to pick the game's seed).
+        static uint64_t randomSeed();
+
+        /// @brief Mixes two values into a new seed (e.g. the game seed and a level number).
+        static uint64_t mix(uint64_t a, uint64_t b);
+
+    private:
+        State state;
+        uint64_t initialSeed;
+};
+
+#endif //GRAPHICS_RANDOM_H
@@ -0,0 +1,131 @@
+#include "renderScale.h"
+#include <algorithm>
+#include <cmath>
+#include "debug.h"
+#include "log.h"
+
+namespace {
+/// @brief Smallest change of scale (the scale goes back up one step at a time)
+const float SCALE_STEP = 0.05f;
+/// @brief The scale only goes back up when frames take less than this fraction of the target
+const float HEADROOM = 0.75f;
+}
+
+RenderScale::RenderScale(int width, int height, const RenderScaleSettings &settings) :
+    width(width), height(height), settings(settings), scale(std::clamp(settings.scale, MIN_SCALE, 1.0f)) {
+    // Nothing to allocate if frames always go straight to the window
+    if (scale >= 1 && !settings.automatic) {
+        return;
+    }
+    const GLint filter = settings.filter == ScaleFilter::nearest ? GL_NEAREST : GL_LINEAR;
+    glGenTextures(1, &colorTexture);
+    glBindTexture(GL_TEXTURE_2D, colorTexture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, filter);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, filter);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    glGenFramebuffers(1, &framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, colorTexture, 0);
+    const bool complete = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    if (!complete) {
+        LOG_ERROR("Render scale framebuffer is incomplete, rendering at full resolution");
+        glDeleteFramebuffers(1, &framebuffer);
+        glDeleteTextures(1, &colorTexture);
+        framebuffer = 0;
+        colorTexture = 0;
+        scale = 1;
+        return;
+    }
+
+    if (settings.automatic) {
+        glGenQueries(QUERY_COUNT, queries);
+    }
+    glCheckError();
+}
+
+RenderScale::~RenderScale() {
+    if (queries[0] != 0) {
+        glDeleteQueries(QUERY_COUNT, queries);
+    }
+    glDeleteFramebuffers(1, &framebuffer);
+    glDeleteTextures(1, &colorTexture);
+}
+
+void RenderScale::beginFrame() {
+    // Skip timing (rather than wait) if every query is still in flight
+    timing = settings.automatic && queries[0] != 0 && pendingQueries < QUERY_COUNT;
+    if (timing) {
+        glBeginQuery(GL_TIME_ELAPSED, queries[nextQuery]);
+    }
+    scaled = framebuffer != 0 && scale < 1;
+    if (scaled) {
+        glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+        glViewport(0, 0, std::max(1, int(width * scale)), std::max(1, int(height * scale)));
+    }
+}
+
+void RenderScale::present() {
+    if (!scaled) {
+        return;
+    }
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, framebuffer);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+    glBlitFramebuffer(0, 0, std::max(1, int(width * scale)), std::max(1, int(height * scale)), 0, 0, width, height,
+                      GL_COLOR_BUFFER_BIT, settings.filter == ScaleFilter::nearest ? GL_NEAREST : GL_LINEAR);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glViewport(0, 0, width, height);
+    scaled = false;
+}
+
+void RenderScale::endFrame() {
+    if (timing) {
+        glEndQuery(GL_TIME_ELAPSED);
+        nextQuery = (nextQuery + 1) % QUERY_COUNT;
+        pendingQueries++;
+        timing = false;
+    }
+    // Read every finished query, oldest first (the GPU finishes frames in order)
+    while (pendingQueries > 0) {
+        GLuint query = queries[(nextQuery - pendingQueries + QUERY_COUNT) % QUERY_COUNT];
+        GLint available = 0;
+        glGetQueryObjectiv(query, GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) {
+            break;
+        }
+        GLuint64 nanoseconds = 0;
+        glGetQueryObjectui64v(query, GL_QUERY_RESULT, &nanoseconds);
+        pendingQueries--;
+        adjust(nanoseconds / 1000);
+    }
+}
+
+void RenderScale::adjust(uint64_t frameTime) {
+    gpuTime = frameTime;
+    windowTime += frameTime;
+    if (++windowFrames < ADJUST_FRAMES) {
+        return;
+    }
+    const double average = double(windowTime) / windowFrames;
+    const double target = double(settings.targetFrameTime);
+    windowTime = 0;
+    windowFrames = 0;
+
+    float next = scale;
+    if (average > target) {
+        // Fill cost goes with the number of pixels (the square of the scale)
+        next = std::min(scale - SCALE_STEP, scale * float(std::sqrt(target / average)));
+    }
+    else if (average < target * HEADROOM) {
+        next = scale + SCALE_STEP;
+    }
+    next = std::clamp(next, MIN_SCALE, 1.0f);
+    if (next != scale) {
+        LOG_DEBUG("Render scale {} -> {} (GPU frame {} us, target {} us)", scale, next, average, target);
+        scale = next;
+    }
+}
@@ -0,0 +1,94 @@
+#ifndef GRAPHICS_RENDERSCALE_H
+#define GRAPHICS_RENDERSCALE_H
+
+#include <cstdint>
+#include <glad/glad.h>
+
+/// @brief How a frame rendered below the window's resolution is stretched to fill it.
+enum class ScaleFilter {
+    /// @brief Sharp, blocky pixels
+    nearest,
+    /// @brief Smooth (bilinear), slightly blurry
+    linear,
+};
+
+/// @brief Resolution the game is rendered at (--render-scale and friends).
+struct RenderScaleSettings {
+    /// @brief Fraction of the window's width and height the frame is rendered at (the starting scale if automatic)
+    float scale = 1;
+    /// @brief Changes the scale every few frames to keep the GPU time of a frame near targetFrameTime
+    bool automatic = false;
+    /// @brief GPU time per frame (microseconds) the automatic scale aims for
+    uint64_t targetFrameTime = 12000;
+    ScaleFilter filter = ScaleFilter::linear;
+    /// @brief Draws text at the window's resolution after the frame is upscaled (so it stays sharp)
+    bool nativeText = false;
+};
+
+/**
+ * @brief Renders frames into a smaller offscreen framebuffer and upscales them to the window.
+ * @details Cuts the number of pixels shaded, which is what limits software rasterizers (llvmpipe) at 1600x1200.
+ * The color texture is allocated once at the window's size and a frame only uses its bottom left corner, so
+ * changing the scale never reallocates. At a scale of 1 frames go straight to the window (no copy). In automatic
+ * mode every frame is timed with a GL_TIME_ELAPSED query, read back a few frames later so the CPU never waits.
+ * Only use from the thread that owns the GL context.
+ */
+class RenderScale {
+    public:
+        /// @brief Smallest scale the automatic mode goes down to
+        static constexpr float MIN_SCALE = 0.25f;
+
+        /// @param width Window width in pixels
+        /// @param height Window height in pixels
+        RenderScale(int width, int height, const RenderScaleSettings &settings);
+        ~RenderScale();
+
+        RenderScale(const RenderScale &) = delete;
+        RenderScale &operator=(const RenderScale &) = delete;
+
+        /// @brief Starts timing the frame and binds the framebuffer it's drawn into (call before clearing).
+        void beginFrame();
+
+        /// @brief Upscales the frame to the window (does nothing at a scale of 1).
+        /// @details Anything drawn afterwards goes straight to the window, at its full resolution.
+        void present();
+
+        /// @brief Stops timing the frame and, in automatic mode, picks the scale for the coming frames.
+        void endFrame();
+
+        /// @brief Scale the current frame is rendered at.
+        float getScale() const { return scale; }
+        /// @brief True if frames are rendered below the window's resolution (and text should wait for present()).
+        bool isScaled() const { return scaled; }
+        const RenderScaleSettings &getSettings() const { return settings; }
+        /// @brief GPU time of the last timed frame in microseconds (0 until the first result, automatic mode only).
+        uint64_t getGpuTime() const { return gpuTime; }
+
+    private:
+        const int width, height;
+        const RenderScaleSettings settings;
+        float scale;
+        /// @brief Whether the frame being drawn uses the framebuffer (the scale is only changed between frames)
+        bool scaled = false;
+
+        GLuint framebuffer = 0;
+        GLuint colorTexture = 0;
+
+        /// @brief Ring of timer queries (results are read the first time they are available, oldest first)
+        static const int QUERY_COUNT = 4;
+        GLuint queries[QUERY_COUNT] = {};
+        int nextQuery = 0;
+        int pendingQueries = 0;
+        bool timing = false;
+
+        /// @brief GPU time of the frames since the last change of scale
+        static const int ADJUST_FRAMES = 30;
+        uint64_t windowTime = 0;
+        int windowFrames = 0;
+        uint64_t gpuTime = 0;
+
+        /// @brief Adds one frame's GPU time and changes the scale once ADJUST_FRAMES frames have been timed.
+        void adjust(uint64_t frameTime);
+};
+
+#endif //GRAPHICS_RENDERSCALE_H
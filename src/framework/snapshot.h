@@ -0,0 +1,91 @@
+#ifndef GRAPHICS_SNAPSHOT_H
+#define GRAPHICS_SNAPSHOT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+using std::vector;
+
+/**
+ * @brief Appends plain data to a byte buffer (a snapshot).
+ * @details Values are copied with memcpy, so only trivially copyable types can be written. Arrays are written as
+ * their count followed by their bytes. Snapshots are meant to be read back by the same build on the same machine.
+ */
+class SnapshotWriter {
+    public:
+        /// @brief Clears the buffer (its capacity is kept, so writing a snapshot of the same size doesn't allocate).
+        explicit SnapshotWriter(vector<unsigned char> &bytes) : bytes(bytes) { bytes.clear(); }
+
+        template <typename T>
+        void write(const T &value) {
+            static_assert(std::is_trivially_copyable_v<T>, "Snapshots only hold plain data");
+            writeBytes(&value, sizeof(T));
+        }
+
+        template <typename T>
+        void writeArray(const vector<T> &values) {
+            static_assert(std::is_trivially_copyable_v<T>, "Snapshots only hold plain data");
+            write<uint64_t>(values.size());
+            writeBytes(values.data(), values.size() * sizeof(T));
+        }
+
+        void writeBytes(const void *data, size_t size) {
+            size_t offset = bytes.size();
+            bytes.resize(offset + size);
+            if (size > 0) {
+                memcpy(bytes.data() + offset, data, size);
+            }
+        }
+
+    private:
+        vector<unsigned char> &bytes;
+};
+
+/**
+ * @brief Reads back what a SnapshotWriter wrote, in the same order.
+ * @details Every read returns false (and leaves the value alone) if the snapshot is too short.
+ */
+class SnapshotReader {
+    public:
+        explicit SnapshotReader(const vector<unsigned char> &bytes) : bytes(bytes) {}
+
+        template <typename T>
+        bool read(T &value) {
+            static_assert(std::is_trivially_copyable_v<T>, "Snapshots only hold plain data");
+            return readBytes(&value, sizeof(T));
+        }
+
+        /// @brief Reads an array into values (reusing its capacity).
+        template <typename T>
+        bool readArray(vector<T> &values) {
+            static_assert(std::is_trivially_copyable_v<T>, "Snapshots only hold plain data");
+            uint64_t count;
+            if (!read(count) || count > getRemaining() / sizeof(T)) {
+                return false;
+            }
+            values.resize(count);
+            return readBytes(values.data(), count * sizeof(T));
+        }
+
+        bool readBytes(void *data, size_t size) {
+            if (size > getRemaining()) {
+                return false;
+            }
+            if (size > 0) {
+                memcpy(data, bytes.data() + offset, size);
+            }
+            offset += size;
+            return true;
+        }
+
+        size_t getRemaining() const { return bytes.size() - offset; }
+
+    private:
+        const vector<unsigned char> &bytes;
+        size_t offset = 0;
+};
+
+#endif //GRAPHICS_SNAPSHOT_H
@@ -0,0 +1,128 @@
+#include "taskGraph.h"
+#include <chrono>
+#include <cstdio>
+#include "profiler.h"
+
+namespace {
+int64_t nowNanoseconds() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+}
+
+int TaskGraph::add(const char *name, std::function<void()> work, Affinity affinity) {
+    auto task = std::make_unique<Task>();
+    task->name = name;
+    task->work = std::move(work);
+    task->affinity = affinity;
+    task->graph = this;
+    task->id = getTaskCount();
+    tasks.push_back(std::move(task));
+    timings.emplace_back();
+    return getTaskCount() - 1;
+}
+
+void TaskGraph::addDependency(int task, int dependency) {
+    tasks[task]->dependencies.push_back(dependency);
+    tasks[dependency]->dependents.push_back(task);
+}
+
+void TaskGraph::run(JobSystem &jobs) {
+    PROFILE_SCOPE("TaskGraph::run");
+    this->jobs = &jobs;
+    for (std::unique_ptr<Task> &task : tasks) {
+        task->waiting = static_cast<int>(task->dependencies.size());
+    }
+    unfinished = getTaskCount();
+    runStart = nowNanoseconds();
+    for (std::unique_ptr<Task> &task : tasks) {
+        if (task->dependencies.empty()) {
+            schedule(*task);
+        }
+    }
+    jobs.runUntil([this] { return unfinished == 0; });
+    finishRun();
+}
+
+void TaskGraph::schedule(Task &task) {
+    Job job{&TaskGraph::runTask, &task};
+    if (task.affinity == Affinity::main) {
+        jobs->submitMain(job);
+    }
+    else {
+        jobs->submit(job);
+    }
+}
+
+void TaskGraph::runTask(void *data) {
+    Task &task = *static_cast<Task *>(data);
+    TaskGraph &graph = *task.graph;
+    task.timing.thread = JobSystem::getThreadIndex();
+    task.timing.start = nowNanoseconds() - graph.runStart;
+    {
+        PROFILE_SCOPE(task.name);
+        task.work();
+    }
+    task.timing.end = nowNanoseconds() - graph.runStart;
+
+    for (int dependent : task.dependents) {
+        Task &next = *graph.tasks[dependent];
+        if (--next.waiting == 0) {
+            graph.schedule(next);
+        }
+    }
+    if (--graph.unfinished == 0) {
+        graph.jobs->wake();
+    }
+}
+
+void TaskGraph::finishRun() {
+    runTime = 0;
+    int last = -1;
+    for (int i = 0; i < getTaskCount(); ++i) {
+        Task &task = *tasks[i];
+        timings[i] = task.timing;
+        timings[i].critical = false;
+        task.totalTime += task.timing.end - task.timing.start;
+        if (task.timing.end >= runTime) {
+            runTime = task.timing.end;
+            last = i;
+        }
+    }
+    // Walk back from the task that finished last, through the dependency that finished last
+    criticalTime = 0;
+    for (int task = last; task != -1;) {
+        timings[task].critical = true;
+        tasks[task]->criticalRuns++;
+        criticalTime += timings[task].end - timings[task].start;
+        int latest = -1;
+        for (int dependency : tasks[task]->dependencies) {
+            if (latest == -1 || timings[dependency].end > timings[latest].end) {
+                latest = dependency;
+            }
+        }
+        task = latest;
+    }
+    runs++;
+    totalRunTime += runTime;
+}
+
+void TaskGraph::report(std::ostream &out) const {
+    if (runs == 0) {
+        return;
+    }
+    char line[128];
+    snprintf(line, sizeof(line), "%-17s %8s %9s  %s", "Frame tasks (ms)", "avg", "critical", "waits for");
+    out << line << std::endl;
+    for (const std::unique_ptr<Task> &task : tasks) {
+        std::string dependencies;
+        for (int dependency : task->dependencies) {
+            dependencies += (dependencies.empty() ? "" : ", ") + std::string(tasks[dependency]->name);
+        }
+        snprintf(line, sizeof(line), "%-17s %8.3f %8.1f%%  %s", task->name, task->totalTime / 1e6 / runs,
+                 100.0 * task->criticalRuns / runs, dependencies.c_str());
+        out << line << std::endl;
+    }
+    snprintf(line, sizeof(line), "%-17s %8.3f", "whole graph", totalRunTime / 1e6 / runs);
+    out << line << std::endl;
+}
@@ -0,0 +1,97 @@
+#ifndef GRAPHICS_TASKGRAPH_H
+#define GRAPHICS_TASKGRAPH_H
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <ostream>
+#include <vector>
+#include "jobSystem.h"
+
+using std::vector;
+
+/**
+ * @brief The work of one frame, as tasks and the tasks each one waits for.
+ * @details Built once, then run() every frame: a task is handed to the JobSystem as soon as everything it depends on
+ * has finished, so independent tasks run at the same time. Each run is timed, and the chain of tasks that decided
+ * when the run finished (the critical path) is kept for the profiler.
+ */
+class TaskGraph {
+    public:
+        /// @brief Where a task may run (OpenGL and GLFW calls must stay on the main thread)
+        enum class Affinity {
+            any,
+            main,
+        };
+
+        /// @brief Timing of a task in the last run.
+        struct TaskTiming {
+            /// @brief Nanoseconds since the run started
+            int64_t start = 0;
+            int64_t end = 0;
+            /// @brief JobSystem::getThreadIndex() of the thread that ran it
+            int thread = 0;
+            /// @brief On the critical path
+            bool critical = false;
+        };
+
+        /// @brief Adds a task (not while running).
+        /// @param name Must be a string literal (it's also the task's profiler scope)
+        /// @return The task's id
+        int add(const char *name, std::function<void()> work, Affinity affinity = Affinity::any);
+
+        /// @brief Makes task wait for dependency to finish (dependency must have been added first).
+        void addDependency(int task, int dependency);
+
+        /// @brief Runs every task once and returns when they've all finished.
+        /// @details Call from the JobSystem's main thread. Doesn't allocate.
+        void run(JobSystem &jobs);
+
+        int getTaskCount() const                    { return static_cast<int>(tasks.size()); }
+        const char *getName(int task) const         { return tasks[task]->name; }
+        const vector<int> &getDependencies(int task) const { return tasks[task]->dependencies; }
+        const TaskTiming &getTiming(int task) const { return timings[task]; }
+        /// @brief Nanoseconds from the start of the last run to its last task's end
+        int64_t getRunTime() const                  { return runTime; }
+        /// @brief Nanoseconds the last run's critical path spent running (the rest is time waiting to be scheduled)
+        int64_t getCriticalTime() const             { return criticalTime; }
+
+        /// @brief Writes every task's average time and how often it was on the critical path.
+        void report(std::ostream &out) const;
+
+    private:
+        struct Task {
+            const char *name;
+            std::function<void()> work;
+            Affinity affinity;
+            vector<int> dependencies;
+            vector<int> dependents;
+            /// @brief Dependencies that haven't finished yet this run
+            std::atomic<int> waiting{0};
+            TaskGraph *graph;
+            int id;
+            /// @brief This run's timing (copied to timings once the run is over)
+            TaskTiming timing;
+            /// @brief Totals over every run
+            int64_t totalTime = 0;
+            uint64_t criticalRuns = 0;
+        };
+
+        static void runTask(void *data);
+        void schedule(Task &task);
+        /// @brief Copies the run's timings and finds its critical path.
+        void finishRun();
+
+        vector<std::unique_ptr<Task>> tasks;
+        vector<TaskTiming> timings;
+        JobSystem *jobs = nullptr;
+        std::atomic<int> unfinished{0};
+        int64_t runStart = 0;
+        int64_t runTime = 0;
+        int64_t criticalTime = 0;
+        uint64_t runs = 0;
+        int64_t totalRunTime = 0;
+};
+
+#endif //GRAPHICS_TASKGRAPH_H
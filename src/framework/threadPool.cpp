@@ -0,0 +1,63 @@
+#include "threadPool.h"
+#include <algorithm>
+
+ThreadPool::ThreadPool(int threadCount) {
+    threadCount = std::max(1, threadCount);
+    workers.reserve(threadCount);
+    for (int i = 0; i < threadCount; ++i) {
+        workers.emplace_back(&ThreadPool::work, this);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    taskAdded.notify_all();
+    for (std::thread &worker : workers) {
+        worker.join();
+    }
+}
+
+void ThreadPool::submit(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        tasks.push_back(std::move(task));
+        unfinished++;
+    }
+    taskAdded.notify_one();
+}
+
+void ThreadPool::wait() {
+    std::unique_lock<std::mutex> lock(mutex);
+    tasksFinished.wait(lock, [this] { return unfinished == 0; });
+}
+
+bool ThreadPool::waitFor(std::chrono::milliseconds timeout) {
+    std::unique_lock<std::mutex> lock(mutex);
+    return tasksFinished.wait_for(lock, timeout, [this] { return unfinished == 0; });
+}
+
+int ThreadPool::getDefaultThreadCount() {
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+void ThreadPool::work() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        taskAdded.wait(lock, [this] { return stopping || !tasks.empty(); });
+        // Queued tasks still run when stopping
+        if (tasks.empty()) {
+            return;
+        }
+        std::function<void()> task = std::move(tasks.front());
+        tasks.pop_front();
+        lock.unlock();
+        task();
+        lock.lock();
+        if (--unfinished == 0) {
+            tasksFinished.notify_all();
+        }
+    }
+}
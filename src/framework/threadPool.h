@@ -0,0 +1,57 @@
+#ifndef GRAPHICS_THREADPOOL_H
+#define GRAPHICS_THREADPOOL_H
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using std::vector;
+
+/**
+ * @brief A fixed set of worker threads that run submitted tasks in the order they were submitted.
+ * @details Tasks should be coarse (a whole simulated session, not a single bubble): every submit and every task
+ * taken by a worker locks one mutex.
+ */
+class ThreadPool {
+    public:
+        /// @param threadCount Number of workers (at least 1)
+        explicit ThreadPool(int threadCount = getDefaultThreadCount());
+
+        /// @brief Finishes every submitted task, then stops the workers.
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool &) = delete;
+        ThreadPool &operator=(const ThreadPool &) = delete;
+
+        void submit(std::function<void()> task);
+
+        /// @brief Blocks until every submitted task has finished.
+        void wait();
+
+        /// @brief Blocks until every submitted task has finished or the timeout runs out.
+        /// @return true if every task has finished
+        bool waitFor(std::chrono::milliseconds timeout);
+
+        int getThreadCount() const { return static_cast<int>(workers.size()); }
+
+        /// @brief Number of hardware threads (at least 1).
+        static int getDefaultThreadCount();
+
+    private:
+        void work();
+
+        vector<std::thread> workers;
+        std::deque<std::function<void()>> tasks;
+        std::mutex mutex;
+        std::condition_variable taskAdded;
+        std::condition_variable tasksFinished;
+        /// @brief Tasks submitted but not finished yet (queued or running)
+        size_t unfinished = 0;
+        bool stopping = false;
+};
+
+#endif //GRAPHICS_THREADPOOL_H
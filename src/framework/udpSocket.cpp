@@ -0,0 +1,137 @@
+#include "udpSocket.h"
+#include <iostream>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+typedef int socklen_t;
+#else
+#include <arpa/inet.h>
+#include <cerrno>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+using std::cout, std::endl;
+
+namespace {
+#ifdef _WIN32
+bool startNetworking() {
+    // WSAStartup is reference counted, and the sockets live until exit, so it's never cleaned up
+    static const bool started = [] {
+        WSADATA data;
+        return WSAStartup(MAKEWORD(2, 2), &data) == 0;
+    }();
+    return started;
+}
+
+bool wouldBlock() { return WSAGetLastError() == WSAEWOULDBLOCK || WSAGetLastError() == WSAECONNRESET; }
+#else
+bool startNetworking() { return true; }
+
+bool wouldBlock() { return errno == EAGAIN || errno == EWOULDBLOCK || errno == ECONNREFUSED; }
+#endif
+
+sockaddr_in toSockaddr(const NetAddress &address) {
+    sockaddr_in result = {};
+    result.sin_family = AF_INET;
+    result.sin_addr.s_addr = htonl(address.host);
+    result.sin_port = htons(address.port);
+    return result;
+}
+}
+
+bool NetAddress::parse(const std::string &text, uint16_t port, NetAddress &address) {
+    in_addr parsed;
+    if (inet_pton(AF_INET, text.c_str(), &parsed) != 1) {
+        return false;
+    }
+    address.host = ntohl(parsed.s_addr);
+    address.port = port;
+    return true;
+}
+
+std::string NetAddress::toString() const {
+    return std::to_string(host >> 24) + '.' + std::to_string((host >> 16) & 0xFF) + '.' +
+           std::to_string((host >> 8) & 0xFF) + '.' + std::to_string(host & 0xFF) + ':' + std::to_string(port);
+}
+
+UdpSocket::~UdpSocket() {
+    close();
+}
+
+bool UdpSocket::open(uint16_t port) {
+    close();
+    if (!startNetworking()) {
+        cout << "Could not start networking" << endl;
+        return false;
+    }
+    handle = static_cast<intptr_t>(socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP));
+    if (handle == INVALID) {
+        cout << "Could not create a UDP socket" << endl;
+        return false;
+    }
+    sockaddr_in address = toSockaddr(NetAddress{INADDR_ANY, port});
+    if (bind(handle, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) != 0) {
+        cout << "Could not bind a UDP socket to port " << port << endl;
+        close();
+        return false;
+    }
+#ifdef _WIN32
+    u_long nonBlocking = 1;
+    bool blocking = ioctlsocket(handle, FIONBIO, &nonBlocking) != 0;
+#else
+    bool blocking = fcntl(handle, F_SETFL, O_NONBLOCK) != 0;
+#endif
+    if (blocking) {
+        cout << "Could not make a UDP socket non-blocking" << endl;
+        close();
+        return false;
+    }
+    socklen_t length = sizeof(address);
+    getsockname(handle, reinterpret_cast<sockaddr *>(&address), &length);
+    this->port = ntohs(address.sin_port);
+    return true;
+}
+
+void UdpSocket::close() {
+    if (handle == INVALID) {
+        return;
+    }
+#ifdef _WIN32
+    closesocket(handle);
+#else
+    ::close(handle);
+#endif
+    handle = INVALID;
+    port = 0;
+}
+
+bool UdpSocket::send(const NetAddress &to, const void *data, size_t size) {
+    if (handle == INVALID || size > MAX_DATAGRAM) {
+        return false;
+    }
+    sockaddr_in address = toSockaddr(to);
+    auto sent = sendto(handle, static_cast<const char *>(data), static_cast<int>(size), 0,
+                       reinterpret_cast<const sockaddr *>(&address), sizeof(address));
+    return sent == static_cast<decltype(sent)>(size);
+}
+
+int UdpSocket::receive(void *data, size_t capacity, NetAddress &from) {
+    if (handle == INVALID) {
+        return -1;
+    }
+    sockaddr_in address = {};
+    socklen_t length = sizeof(address);
+    auto received = recvfrom(handle, static_cast<char *>(data), static_cast<int>(capacity), 0,
+                             reinterpret_cast<sockaddr *>(&address), &length);
+    if (received < 0) {
+        // Nothing waiting (or the other end isn't listening yet, which UDP reports on the next receive)
+        return wouldBlock() ? 0 : -1;
+    }
+    from.host = ntohl(address.sin_addr.s_addr);
+    from.port = ntohs(address.sin_port);
+    return static_cast<int>(received);
+}
@@ -0,0 +1,61 @@
+#ifndef GRAPHICS_UDPSOCKET_H
+#define GRAPHICS_UDPSOCKET_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/// @brief An IPv4 address and port (both in host byte order).
+struct NetAddress {
+    uint32_t host = 0;
+    uint16_t port = 0;
+
+    /// @brief Parses a dotted address ("127.0.0.1").
+    /// @return false if text isn't an IPv4 address
+    static bool parse(const std::string &text, uint16_t port, NetAddress &address);
+
+    std::string toString() const;
+
+    bool operator==(const NetAddress &other) const { return host == other.host && port == other.port; }
+    bool operator!=(const NetAddress &other) const { return !(*this == other); }
+};
+
+/**
+ * @brief Non-blocking IPv4 UDP socket.
+ * @details Errors are printed and returned as false/-1, like the rest of the framework.
+ */
+class UdpSocket {
+    public:
+        UdpSocket() = default;
+        ~UdpSocket();
+
+        UdpSocket(const UdpSocket &) = delete;
+        UdpSocket &operator=(const UdpSocket &) = delete;
+
+        /// @brief Opens the socket and binds it to a port on every interface.
+        /// @param port The port to listen on (0 picks a free one)
+        bool open(uint16_t port = 0);
+        void close();
+        bool isOpen() const { return handle != INVALID; }
+
+        /// @brief Sends one datagram.
+        bool send(const NetAddress &to, const void *data, size_t size);
+
+        /// @brief Receives one datagram without waiting.
+        /// @return Bytes received, 0 if nothing was waiting, -1 on error
+        int receive(void *data, size_t capacity, NetAddress &from);
+
+        /// @brief The port the socket is bound to.
+        uint16_t getPort() const { return port; }
+
+        /// @brief Largest datagram that can be sent over IPv4.
+        static constexpr size_t MAX_DATAGRAM = 65507;
+
+    private:
+        // A SOCKET on Windows, a file descriptor elsewhere
+        static constexpr intptr_t INVALID = -1;
+        intptr_t handle = INVALID;
+        uint16_t port = 0;
+};
+
+#endif //GRAPHICS_UDPSOCKET_H
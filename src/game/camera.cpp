@@ -0,0 +1,10 @@
+#include "camera.h"
+#include <algorithm>
+
+void Camera::follow(vec2 target, vec2 arenaSize) {
+    vec2 corner = target - viewSize / 2.0f;
+    corner.x = std::clamp(corner.x, 0.0f, std::max(arenaSize.x - viewSize.x, 0.0f));
+    corner.y = std::clamp(corner.y, 0.0f, std::max(arenaSize.y - viewSize.y, 0.0f));
+    min = corner;
+    max = corner + viewSize;
+}
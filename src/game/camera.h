@@ -0,0 +1,41 @@
+#ifndef GRAPHICS_CAMERA_H
+#define GRAPHICS_CAMERA_H
+
+#include "glm/glm.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+
+using glm::vec2, glm::mat4;
+
+/**
+ * @brief The part of the arena shown on screen (the arena can be larger than the screen).
+ * @details Plain data and no OpenGL: the game moves it, the renderer turns it into a projection and culls with it.
+ */
+class Camera {
+    public:
+        /// @param viewSize Width and height of what the camera shows (the window's size)
+        explicit Camera(vec2 viewSize) : viewSize(viewSize), min(0), max(viewSize) {}
+
+        /// @brief Centers the view on target, but never shows anything past the edges of the arena.
+        /// @param arenaSize Width and height of the arena (an arena smaller than the view is shown from its corner)
+        void follow(vec2 target, vec2 arenaSize);
+
+        /// @brief Bottom left and top right corners of the view (in arena coordinates)
+        vec2 getMin() const { return min; }
+        vec2 getMax() const { return max; }
+
+        /// @brief Orthographic projection from arena coordinates to the screen.
+        mat4 getProjection() const { return glm::ortho(min.x, max.x, min.y, max.y, -1.0f, 1.0f); }
+
+        /// @brief Checks if any part of a box centered on center is on screen.
+        bool isVisible(vec2 center, vec2 halfSize) const {
+            return center.x + halfSize.x >= min.x && center.x - halfSize.x <= max.x &&
+                   center.y + halfSize.y >= min.y && center.y - halfSize.y <= max.y;
+        }
+
+    private:
+        vec2 viewSize;
+        vec2 min;
+        vec2 max;
+};
+
+#endif //GRAPHICS_CAMERA_H
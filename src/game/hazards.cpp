@@ -0,0 +1,55 @@
+#include "hazards.h"
+#include <algorithm>
+#include "physics.h"
+
+const HazardReport &HazardQuery::update(const World &world, vec2 rectMin, vec2 rectMax) {
+    const vector<Bubble> &bubbles = world.getBubbles();
+    const vector<Entity> &entities = world.getBubbleEntities();
+    vec2 center = (rectMin + rectMax) / 2.0f;
+    vec2 halfSize = (rectMax - rectMin) / 2.0f;
+
+    int nearMisses = report.nearMisses;
+    report = HazardReport();
+    report.nearMisses = nearMisses;
+    world.forEachIndexNear(center, HAZARD_RANGE + std::max(halfSize.x, halfSize.y), [&](int index) {
+        const Bubble &bubble = bubbles[index];
+        // Same test as the collision system, so a hit here is a hit there
+        if (circleRectOverlap(bubble.position, bubble.radius, rectMin, rectMax)) {
+            if (!report.hit.isValid()) {
+                report.hit = entities[index];
+                report.nearest = bubble;
+            }
+            report.nearestGap = 0;
+            report.threats++;
+            return;
+        }
+        vec2 outside = glm::max(glm::abs(bubble.position - center) - halfSize, vec2(0));
+        float gap = std::max(glm::length(outside) - bubble.radius, 0.0f);
+        if (gap >= HAZARD_RANGE) {
+            return;
+        }
+        report.threats++;
+        if (gap < report.nearestGap) {
+            report.nearestGap = gap;
+            report.nearest = bubble;
+        }
+    });
+
+    // Counted once the bubble is well clear, so one bubble grazing past doesn't count several times
+    if (report.hit.isValid()) {
+        closeCall = false;
+    }
+    else if (report.nearestGap < NEAR_MISS_GAP) {
+        closeCall = true;
+    }
+    else if (closeCall && report.nearestGap > 2 * NEAR_MISS_GAP) {
+        closeCall = false;
+        report.nearMisses++;
+    }
+    return report;
+}
+
+void HazardQuery::reset() {
+    report = HazardReport();
+    closeCall = false;
+}
@@ -0,0 +1,48 @@
+#ifndef GRAPHICS_HAZARDS_H
+#define GRAPHICS_HAZARDS_H
+
+#include "world.h"
+#include "../ecs/registry.h"
+
+/// @brief Bubbles closer than this to the player are reported by HazardQuery (gap between their edges, in pixels)
+const float HAZARD_RANGE = 150;
+/// @brief A bubble that gets this close and leaves without touching the player is a near miss
+const float NEAR_MISS_GAP = 10;
+
+/// @brief The bubbles around the player after a step.
+struct HazardReport {
+    /// @brief A bubble overlapping the player (invalid if none)
+    Entity hit;
+    /// @brief Gap between the player and the closest bubble (0 if one is overlapping, HAZARD_RANGE if none is in range)
+    float nearestGap = HAZARD_RANGE;
+    /// @brief The closest bubble (only set if nearestGap < HAZARD_RANGE)
+    Bubble nearest = {};
+    /// @brief Bubbles within HAZARD_RANGE of the player
+    int threats = 0;
+    /// @brief Near misses since the last reset()
+    int nearMisses = 0;
+};
+
+/**
+ * @brief Finds the bubbles around the player with the World's grid (only the cells near the player are visited).
+ * @details Call update() once per step, after World::step(). The game, the simulated sessions and the bots all read
+ * the same report, so nobody scans every bubble to check on the player.
+ */
+class HazardQuery {
+    public:
+        /// @brief Looks for bubbles around the player's rectangle [rectMin, rectMax].
+        const HazardReport &update(const World &world, vec2 rectMin, vec2 rectMax);
+
+        /// @brief The report from the last update()
+        const HazardReport &getReport() const { return report; }
+
+        /// @brief Clears the report and the near miss count (new level or attempt).
+        void reset();
+
+    private:
+        HazardReport report;
+        /// @brief A bubble came within NEAR_MISS_GAP and hasn't left yet
+        bool closeCall = false;
+};
+
+#endif //GRAPHICS_HAZARDS_H
@@ -0,0 +1,45 @@
+#ifndef GRAPHICS_INPUT_H
+#define GRAPHICS_INPUT_H
+
+#include <cstdint>
+
+/// @brief The buttons the game reads (one bit each in InputFrame::buttons).
+enum InputButton : uint16_t {
+    BUTTON_UP       = 1 << 0,
+    BUTTON_DOWN     = 1 << 1,
+    BUTTON_LEFT     = 1 << 2,
+    BUTTON_RIGHT    = 1 << 3,
+    BUTTON_SPACE    = 1 << 4,
+    BUTTON_MOUSE    = 1 << 5,
+    // Key shortcuts
+    BUTTON_C        = 1 << 6,
+    BUTTON_S        = 1 << 7,
+    BUTTON_R        = 1 << 8,
+    BUTTON_W        = 1 << 9,
+    BUTTON_B        = 1 << 10,
+    BUTTON_Y        = 1 << 11,
+    BUTTON_G        = 1 << 12,
+    BUTTON_P        = 1 << 13,
+    BUTTON_E        = 1 << 14,
+};
+
+/**
+ * @brief Everything the game reads from the outside world in one tick.
+ * @details The game only reads input and time through this, so a recorded list of frames replays a game exactly.
+ * Time and mouse position are whole numbers so a replay sees the exact values the game saw.
+ */
+struct InputFrame {
+    /// @brief Time of the tick in microseconds (since the game started)
+    uint64_t time = 0;
+    /// @brief InputButton bits held down this tick
+    uint16_t buttons = 0;
+    /// @brief Mouse position in pixels (origin in the bottom left corner)
+    int16_t mouseX = 0;
+    int16_t mouseY = 0;
+
+    bool isDown(InputButton button) const { return (buttons & button) != 0; }
+    /// @brief Time in seconds
+    double getSeconds() const { return time / 1000000.0; }
+};
+
+#endif //GRAPHICS_INPUT_H
@@ -0,0 +1,98 @@
+#include "level.h"
+#include "../framework/random.h"
+#include "../framework/profiler.h"
+
+namespace {
+LevelConfig getScreenLevelConfig(int lvl) {
+    // Each Level Has A Unique Color Pallet (alpha is 135-255 and gets clamped to 1 by OpenGL)
+    // (LVL 1) Small bubbles, slow speed, fewer spawn in
+    if (lvl <= 1) {
+        // Shades of Green/White
+        return {75, 5, 15, 35,
+                vec4(0.7f, 0.9f, 0.6f, 135), vec4(0.7f + 55 / 255.0f, 0.9f + 35 / 255.0f, 0.6f + 45 / 255.0f, 255)};
+    }
+    // (LVL 2) Bubble size increases, Speed increases, Spawn count increases
+    if (lvl == 2) {
+        // Shades of Blue/Purple
+        return {80, 5, 18, 40,
+                vec4(0.3f, 0.0f, 0.6f, 135), vec4(0.3f + 100 / 255.0f, 40 / 255.0f, 0.6f + 155 / 255.0f, 255)};
+    }
+    // (LVL 3) Bubble size increases, Speed increases, Spawn count increases
+    if (lvl == 3) {
+        // Shades of Purple
+        return {85, 5, 20, 45,
+                vec4(0.0f, 0.3f, 0.8f, 135), vec4(40 / 255.0f, 0.3f + 80 / 255.0f, 0.8f + 120 / 255.0f, 255)};
+    }
+    // (LVL 4) Bubble size increases, Speed increases
+    if (lvl == 4) {
+        // Shades of Yellow/White
+        return {90, 5, 23, 50,
+                vec4(1.0f, 1.0f, 0.0f, 135), vec4(1.0f, 1.0f, 1.0f, 255)};
+    }
+    // (LVL 5) Bubble size increases, Speed increases, Spawn count increases
+    // Shades of RED
+    return {95, 5, 25, 55,
+            vec4(1.0f, 0.2f, 0.2f, 135), vec4(1.0f, 0.2f + 128 / 255.0f, 0.2f + 128 / 255.0f, 255)};
+}
+}
+
+LevelConfig getLevelConfig(int lvl, int arenaScreens) {
+    LevelConfig config = getScreenLevelConfig(lvl);
+    config.numberOfBubbles *= arenaScreens * arenaScreens;
+    return config;
+}
+
+size_t getSpawnArenaSize(int count) {
+    // Spawn data plus one scratch array of random values
+    return sizeof(BubbleSpawn) * count + alignof(BubbleSpawn) + sizeof(float) * count + alignof(float);
+}
+
+size_t getLevelArenaSize(int lvl, int arenaScreens) {
+    return getSpawnArenaSize(getLevelConfig(lvl, arenaScreens).numberOfBubbles);
+}
+
+LevelSpawns generateLevel(int lvl, unsigned int width, unsigned int height, uint64_t seed, Arena &arena,
+                          int arenaScreens) {
+    PROFILE_SCOPE("generateLevel");
+    return generateBubbles(getLevelConfig(lvl, arenaScreens), width, height, seed, arena);
+}
+
+LevelSpawns generateBubbles(const LevelConfig &config, unsigned int width, unsigned int height, uint64_t seed, Arena &arena) {
+    // Each call owns its generator so levels can be generated on a worker thread
+    Random random(seed);
+
+    LevelSpawns spawns;
+    spawns.bubbles = arena.allocateArray<BubbleSpawn>(config.numberOfBubbles);
+    float *values = arena.allocateArray<float>(config.numberOfBubbles);
+    if (spawns.bubbles == nullptr || values == nullptr) {
+        return spawns;
+    }
+    spawns.count = config.numberOfBubbles;
+    const int count = spawns.count;
+
+    // Generate the random values one field at a time, in batches
+    random.fillUniform(values, count, 0, width);
+    for (int i = 0; i < count; ++i) spawns.bubbles[i].position.x = values[i];
+    random.fillUniform(values, count, 0, height);
+    for (int i = 0; i < count; ++i) spawns.bubbles[i].position.y = values[i];
+    random.fillUniform(values, count, config.minRadius, config.maxRadius);
+    for (int i = 0; i < count; ++i) spawns.bubbles[i].radius = values[i];
+    random.fillUniform(values, count, 0, config.maxSpeed);
+    for (int i = 0; i < count; ++i) spawns.bubbles[i].velocity.x = values[i];
+    random.fillUniform(values, count, 0, config.maxSpeed);
+    for (int i = 0; i < count; ++i) spawns.bubbles[i].velocity.y = values[i];
+    for (int channel = 0; channel < 4; ++channel) {
+        random.fillUniform(values, count, config.minColor[channel], config.maxColor[channel]);
+        for (int i = 0; i < count; ++i) spawns.bubbles[i].color[channel] = values[i];
+    }
+    return spawns;
+}
+
+Entity spawnBubble(Registry &registry, const BubbleSpawn &spawn) {
+    Entity bubble = registry.create();
+    registry.add(bubble, Transform{spawn.position, vec2(spawn.radius * 2)});
+    registry.add(bubble, Velocity{spawn.velocity});
+    registry.add(bubble, CircleCollider{spawn.radius});
+    registry.add(bubble, Renderable{spawn.color, Mesh::circle, Layer::bubble});
+    return bubble;
+}
@@ -0,0 +1,72 @@
+#ifndef GRAPHICS_LEVEL_H
+#define GRAPHICS_LEVEL_H
+
+#include <cstdint>
+#include "glm/glm.hpp"
+#include "../framework/arena.h"
+#include "../ecs/registry.h"
+
+using glm::vec2, glm::vec4;
+
+/// @brief Bubble stats for a single level.
+struct LevelConfig {
+    int numberOfBubbles;
+    float minRadius;
+    float maxRadius;
+    float maxSpeed;
+    /// @brief Each channel of a bubble's color is picked between minColor and maxColor
+    vec4 minColor;
+    vec4 maxColor;
+};
+
+/// @brief Everything needed to place one bubble when a level goes live.
+/// @details Plain data (no OpenGL), so it can be generated away from the render thread.
+struct BubbleSpawn {
+    vec2 position;
+    float radius;
+    vec2 velocity;
+    vec4 color;
+};
+
+/// @brief The spawn data for every bubble in a level.
+/// @details The bubbles array lives in the Arena passed to generateLevel().
+struct LevelSpawns {
+    BubbleSpawn *bubbles = nullptr;
+    int count = 0;
+};
+
+/// @brief Number of levels in the game (beating this level wins the game).
+const int LAST_LEVEL = 5;
+
+/// @brief Returns the bubble stats for the given level.
+/// @details Levels outside 1..LAST_LEVEL are clamped to the nearest level.
+/// @param arenaScreens The level is played in an arena this many screens wide and high (the bubble count goes up
+/// with the area, so the level is just as crowded)
+LevelConfig getLevelConfig(int lvl, int arenaScreens = 1);
+
+/// @brief Returns the number of bytes generateBubbles() needs from its arena for the given number of bubbles.
+size_t getSpawnArenaSize(int count);
+
+/// @brief Returns the number of bytes generateLevel() needs from its arena for the given level.
+size_t getLevelArenaSize(int lvl, int arenaScreens = 1);
+
+/// @brief Generates the spawn data for every bubble in the given level.
+/// @details Does not touch OpenGL, so it is safe to call from a worker thread.
+/// @param lvl The level to generate
+/// @param width The width of the playfield
+/// @param height The height of the playfield
+/// @param seed Seed for the level (the same seed always generates the same level)
+/// @param arena The per-level arena the spawn data is allocated from
+/// @param arenaScreens Screens the playfield is wide and high (see getLevelConfig())
+/// @return One BubbleSpawn per bubble (count is 0 if the arena is too small)
+LevelSpawns generateLevel(int lvl, unsigned int width, unsigned int height, uint64_t seed, Arena &arena,
+                          int arenaScreens = 1);
+
+/// @brief Generates the spawn data for any bubble stats (used by generateLevel() and the headless tools).
+/// @details Same parameters as generateLevel(), with the level's stats passed in directly.
+LevelSpawns generateBubbles(const LevelConfig &config, unsigned int width, unsigned int height, uint64_t seed, Arena &arena);
+
+/// @brief Creates a bubble entity (Transform, Velocity, CircleCollider and Renderable) from its spawn data.
+Entity spawnBubble(Registry &registry, const BubbleSpawn &spawn);
+
+#endif //GRAPHICS_LEVEL_H
@@ -0,0 +1,53 @@
+#include "physics.h"
+#include <cmath>
+
+bool bounceCircles(vec2 &posA, vec2 &velA, float radiusA, vec2 &posB, vec2 &velB, float radiusB) {
+    vec2 delta = posB - posA;
+    float distance = glm::length(delta);
+    float overlap = 0.5f * (radiusA + radiusB - distance);
+
+    // Check if circles are overlapping
+    if (overlap <= 0) {
+        return false;
+    }
+
+    // Adjust positions based on radius (as a proxy for mass)
+    float massA = radiusA * radiusA * M_PI;
+    float massB = radiusB * radiusB * M_PI;
+    float totalMass = massA + massB;
+
+    posA = posA - overlap * (massA / totalMass) * delta / distance;
+    posB = posB + overlap * (massB / totalMass) * delta / distance;
+
+    // Velocity calculations for elastic collision
+    vec2 velocityDifference = velA - velB;
+
+    float dotProduct = glm::dot(velocityDifference, delta) / (distance * distance);
+    vec2 collisionNormal = dotProduct * delta;
+
+    velA = velA - (2 * massB / totalMass) * collisionNormal;
+    velB = velB + (2 * massA / totalMass) * collisionNormal;
+    return true;
+}
+
+void moveInBounds(vec2 &pos, vec2 &velocity, float radius, float deltaTime, vec2 bounds) {
+    pos += velocity * deltaTime;
+
+    // If any bubble hits the edges of the screen, bounce it in the other direction
+    if (pos.x - radius <= 0) {
+        pos.x = radius;
+        velocity.x = -velocity.x;
+    }
+    if (pos.x + radius >= bounds.x) {
+        pos.x = bounds.x - radius;
+        velocity.x = -velocity.x;
+    }
+    if (pos.y - radius <= 0) {
+        pos.y = radius;
+        velocity.y = -velocity.y;
+    }
+    if (pos.y + radius >= bounds.y) {
+        pos.y = bounds.y - radius;
+        velocity.y = -velocity.y;
+    }
+}
@@ -0,0 +1,52 @@
+#ifndef GRAPHICS_PHYSICS_H
+#define GRAPHICS_PHYSICS_H
+
+#include "glm/glm.hpp"
+#include <cmath>
+
+using glm::vec2;
+
+// Collision and movement math shared by the shapes, the engine and the headless tools.
+// Nothing in here touches OpenGL.
+
+/// @brief Checks if two circles are overlapping
+/// @details The distance between the centers is less than the sum of the radii.
+/// @note The overlap tests are inline because they run for every pair the broad phase finds.
+inline bool circlesOverlap(vec2 posA, float radiusA, vec2 posB, float radiusB) {
+    // distance = sqrt((x2 - x1)^2 + (y2 - y1)^2)
+    float dist = glm::distance(posA, posB);
+    float radiusSum = radiusA + radiusB;
+    return dist < radiusSum;
+}
+
+/// @brief Checks if a circle overlaps an axis aligned rectangle
+/// @details Based on the distance from the circle's center to the rectangle's closest point.
+inline bool circleRectOverlap(vec2 center, float radius, vec2 rectMin, vec2 rectMax) {
+    // Closest point of the rectangle to the circle's center
+    float closeX = glm::clamp(center.x, rectMin.x, rectMax.x);
+    float closeY = glm::clamp(center.y, rectMin.y, rectMax.y);
+
+    // Getting the distance from the circles center to the rectangles edges
+    float distX = center.x - closeX;
+    float distY = center.y - closeY;
+
+    float distance = std::sqrt(distX * distX + distY * distY);
+
+    return distance < radius;
+}
+
+/// @brief Checks if two axis aligned rectangles are overlapping (touching edges don't count)
+inline bool rectsOverlap(vec2 minA, vec2 maxA, vec2 minB, vec2 maxB) {
+    return minA.x < maxB.x && minB.x < maxA.x && minA.y < maxB.y && minB.y < maxA.y;
+}
+
+/// @brief Pushes two overlapping circles apart and exchanges their momentum (elastic collision)
+/// @details The radius is used as a proxy for mass (mass = area).
+/// @return true if the circles were overlapping
+bool bounceCircles(vec2 &posA, vec2 &velA, float radiusA, vec2 &posB, vec2 &velB, float radiusB);
+
+/// @brief Moves a circle by its velocity and bounces it off the edges of the playfield
+/// @param bounds The width and height of the playfield
+void moveInBounds(vec2 &pos, vec2 &velocity, float radius, float deltaTime, vec2 bounds);
+
+#endif //GRAPHICS_PHYSICS_H
@@ -0,0 +1,27 @@
+#include "player.h"
+#include "input.h"
+
+namespace {
+void step(vec2 &position, vec2 size, uint16_t buttons, vec2 bounds, float distance) {
+    if ((buttons & BUTTON_UP) && position.y + size.y / 2 < bounds.y) {
+        position.y += distance;
+    }
+    if ((buttons & BUTTON_DOWN) && position.y - size.y / 2 > 0) {
+        position.y -= distance;
+    }
+    if ((buttons & BUTTON_LEFT) && position.x - size.x / 2 > 0) {
+        position.x -= distance;
+    }
+    if ((buttons & BUTTON_RIGHT) && position.x + size.x / 2 < bounds.x) {
+        position.x += distance;
+    }
+}
+}
+
+void movePlayer(vec2 &position, vec2 size, uint16_t buttons, vec2 bounds) {
+    step(position, size, buttons, bounds, PLAYER_SPEED);
+    //Space bar gives player a boost
+    if (buttons & BUTTON_SPACE) {
+        step(position, size, buttons, bounds, PLAYER_BOOST);
+    }
+}
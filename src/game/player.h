@@ -0,0 +1,29 @@
+#ifndef GRAPHICS_PLAYER_H
+#define GRAPHICS_PLAYER_H
+
+#include <cstdint>
+#include "glm/glm.hpp"
+
+using glm::vec2;
+
+/// @brief Width and height of the player's square.
+const float PLAYER_SIZE = 20;
+/// @brief Pixels the player moves per tick with an arrow key held, and the extra boost with space held too.
+const float PLAYER_SPEED = 1.1f;
+const float PLAYER_BOOST = 1.3f;
+
+/// @brief Seconds the player has after a level starts before bubbles can hit them.
+const float SPAWN_GRACE_TIME = 1.5f;
+/// @brief Seconds the player must survive to beat a level.
+const int LEVEL_TIME = 20;
+
+/// @brief Moves the player for one tick (the same rules for the game and simulated sessions).
+/// @details Each held arrow moves PLAYER_SPEED (plus PLAYER_BOOST if space is held) unless the player is already
+/// touching that edge of the playfield.
+/// @param position The center of the player
+/// @param size The size of the player
+/// @param buttons InputButton bits held this tick
+/// @param bounds The size of the playfield
+void movePlayer(vec2 &position, vec2 size, uint16_t buttons, vec2 bounds);
+
+#endif //GRAPHICS_PLAYER_H
@@ -0,0 +1,157 @@
+#include "policy.h"
+#include <algorithm>
+#include <limits>
+#include "input.h"
+#include "player.h"
+#include "session.h"
+
+namespace {
+const uint16_t ARROWS = BUTTON_UP | BUTTON_DOWN | BUTTON_LEFT | BUTTON_RIGHT;
+
+/// @brief Returns the arrow keys closest to a direction (none if the direction is zero).
+uint16_t buttonsToward(vec2 direction, bool boost) {
+    float length = glm::length(direction);
+    if (length < 1e-6f) {
+        return 0;
+    }
+    direction /= length;
+    // Only hold a key if the direction is within 67.5 degrees of it (so diagonals are 45 degrees wide)
+    const float threshold = 0.38f;
+    uint16_t buttons = 0;
+    if (direction.x > threshold)  buttons |= BUTTON_RIGHT;
+    if (direction.x < -threshold) buttons |= BUTTON_LEFT;
+    if (direction.y > threshold)  buttons |= BUTTON_UP;
+    if (direction.y < -threshold) buttons |= BUTTON_DOWN;
+    if (boost) {
+        buttons |= BUTTON_SPACE;
+    }
+    return buttons;
+}
+
+/// @brief Distance between the edge of a circle and a square centered on center (negative if they overlap).
+float gapToSquare(vec2 circle, float radius, vec2 center, float halfSize) {
+    vec2 outside = glm::max(glm::abs(circle - center) - vec2(halfSize), vec2(0));
+    return glm::length(outside) - radius;
+}
+}
+
+uint16_t RandomPolicy::decide(const Session &session, Random &random) {
+    if (ticksLeft <= 0) {
+        held = static_cast<uint16_t>(random.nextInt(32)) & (ARROWS | BUTTON_SPACE);
+        ticksLeft = 10 + random.nextInt(50);
+    }
+    ticksLeft--;
+    return held;
+}
+
+uint16_t GreedyPolicy::decide(const Session &session, Random &random) {
+    const vec2 position = session.getPlayerPosition();
+    const vec2 bounds = session.getBounds();
+    vec2 push(0);
+    float closestGap = THREAT_RANGE;
+    // When no bubble was near the player last tick only the walls matter
+    if (session.getHazards().threats > 0) {
+        session.getWorld().forEachNear(position, THREAT_RANGE, [&](const Bubble &bubble) {
+            vec2 away = position - bubble.position;
+            float distance = glm::length(away);
+            float gap = distance - bubble.radius - PLAYER_SIZE / 2;
+            if (gap > THREAT_RANGE || distance < 1e-4f) {
+                return;
+            }
+            away /= distance;
+            // Bubbles coming towards the player count up to twice as much
+            float closing = std::max(0.0f, glm::dot(bubble.velocity, away));
+            float weight = (1 + std::min(closing / 50, 1.0f)) / std::max(gap * gap, 1.0f);
+            push += away * weight;
+            closestGap = std::min(closestGap, gap);
+        });
+    }
+    // Walls push back too, so the player doesn't get cornered
+    const float wallWeight = 0.5f;
+    push.x += wallWeight / std::max(position.x * position.x, 1.0f);
+    push.x -= wallWeight / std::max((bounds.x - position.x) * (bounds.x - position.x), 1.0f);
+    push.y += wallWeight / std::max(position.y * position.y, 1.0f);
+    push.y -= wallWeight / std::max((bounds.y - position.y) * (bounds.y - position.y), 1.0f);
+    return buttonsToward(push, closestGap < 30);
+}
+
+uint16_t LookaheadPolicy::decide(const Session &session, Random &random) {
+    if (ticksLeft > 0) {
+        ticksLeft--;
+        return held;
+    }
+    const vec2 position = session.getPlayerPosition();
+    const vec2 bounds = session.getBounds();
+    const float horizon = HORIZON_TICKS * Session::TICK;
+
+    // Only bubbles that could reach the player's furthest move within the horizon
+    const float reach = HORIZON_TICKS * (PLAYER_SPEED + PLAYER_BOOST) + PLAYER_SIZE;
+    nearby.clear();
+    const World &world = session.getWorld();
+    world.forEachNear(position, reach + world.getMaxSpeed() * horizon, [&](const Bubble &bubble) {
+        float travel = glm::length(bubble.velocity) * horizon;
+        if (glm::length(bubble.position - position) - bubble.radius - travel < reach) {
+            nearby.push_back(bubble);
+        }
+    });
+
+    // Every arrow combination (opposite keys cancel out, so they're skipped), with and without the boost
+    static const uint16_t MOVES[] = {
+        0, BUTTON_UP, BUTTON_DOWN, BUTTON_LEFT, BUTTON_RIGHT,
+        BUTTON_UP | BUTTON_LEFT, BUTTON_UP | BUTTON_RIGHT, BUTTON_DOWN | BUTTON_LEFT, BUTTON_DOWN | BUTTON_RIGHT,
+    };
+    const float safeGap = 60;
+    uint16_t best = held;
+    float bestScore = -std::numeric_limits<float>::max();
+    for (uint16_t move : MOVES) {
+        for (uint16_t boost : {uint16_t(0), uint16_t(BUTTON_SPACE)}) {
+            if (move == 0 && boost != 0) {
+                continue;
+            }
+            uint16_t buttons = move | boost;
+            vec2 predicted = position;
+            float worstGap = safeGap;
+            for (int tick = 1; tick <= HORIZON_TICKS; ++tick) {
+                movePlayer(predicted, vec2(PLAYER_SIZE), buttons, bounds);
+                if (tick % SAMPLE_TICKS != 0) {
+                    continue;
+                }
+                float time = tick * Session::TICK;
+                for (const Bubble &bubble : nearby) {
+                    worstGap = std::min(worstGap, gapToSquare(bubble.position + bubble.velocity * time, bubble.radius,
+                                                              predicted, PLAYER_SIZE / 2));
+                }
+            }
+            // Once every move is safe, head for open space (away from the walls), and don't change moves for nothing
+            float wallGap = std::min(std::min(predicted.x, bounds.x - predicted.x), std::min(predicted.y, bounds.y - predicted.y));
+            float score = worstGap + 0.05f * std::min(wallGap, 200.0f) + (buttons == held ? 1.0f : 0.0f) - (boost ? 0.5f : 0.0f);
+            if (score > bestScore) {
+                bestScore = score;
+                best = buttons;
+            }
+        }
+    }
+    held = best;
+    ticksLeft = REPLAN_TICKS - 1;
+    return held;
+}
+
+std::unique_ptr<PlayerPolicy> createPolicy(const std::string &name) {
+    if (name == "idle") {
+        return std::make_unique<IdlePolicy>();
+    }
+    if (name == "random") {
+        return std::make_unique<RandomPolicy>();
+    }
+    if (name == "greedy") {
+        return std::make_unique<GreedyPolicy>();
+    }
+    if (name == "lookahead") {
+        return std::make_unique<LookaheadPolicy>();
+    }
+    return nullptr;
+}
+
+const char *getPolicyNames() {
+    return "idle|random|greedy|lookahead";
+}
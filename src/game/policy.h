@@ -0,0 +1,89 @@
+#ifndef GRAPHICS_POLICY_H
+#define GRAPHICS_POLICY_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "spatialGrid.h"
+#include "../framework/random.h"
+
+class Session;
+
+/**
+ * @brief Plays a simulated Session (decides which keys the player holds every tick).
+ * @details Every session owns its policy, so policies can keep state between ticks.
+ */
+class PlayerPolicy {
+    public:
+        virtual ~PlayerPolicy() = default;
+
+        virtual const char *getName() const = 0;
+
+        /// @brief Picks the keys to hold this tick.
+        /// @param random The session's generator (the only randomness a policy should use, so sessions replay)
+        /// @return InputButton bits (arrows and space)
+        virtual uint16_t decide(const Session &session, Random &random) = 0;
+};
+
+/// @brief Never moves.
+class IdlePolicy : public PlayerPolicy {
+    public:
+        const char *getName() const override { return "idle"; }
+        uint16_t decide(const Session &session, Random &random) override { return 0; }
+};
+
+/// @brief Random walk: holds a random combination of keys for a random number of ticks, then picks another.
+class RandomPolicy : public PlayerPolicy {
+    public:
+        const char *getName() const override { return "random"; }
+        uint16_t decide(const Session &session, Random &random) override;
+
+    private:
+        uint16_t held = 0;
+        int ticksLeft = 0;
+};
+
+/**
+ * @brief Greedy avoidance: moves away from the nearby bubbles (and walls), weighted by how close they are.
+ * @details Bubbles heading towards the player weigh more; space is held when a bubble is very close.
+ */
+class GreedyPolicy : public PlayerPolicy {
+    public:
+        const char *getName() const override { return "greedy"; }
+        uint16_t decide(const Session &session, Random &random) override;
+
+        /// @brief Bubbles further than this (in pixels, edge to edge) are ignored
+        static constexpr float THREAT_RANGE = 150;
+};
+
+/**
+ * @brief Lookahead: tries every move for the next half second against the nearby bubbles' predicted paths and
+ * keeps the one that stays furthest from them.
+ * @details Bubbles are predicted in straight lines (no bounces). Replans every few ticks.
+ */
+class LookaheadPolicy : public PlayerPolicy {
+    public:
+        const char *getName() const override { return "lookahead"; }
+        uint16_t decide(const Session &session, Random &random) override;
+
+        static constexpr int HORIZON_TICKS = 30;
+        /// @brief The predicted paths are compared every SAMPLE_TICKS ticks
+        static constexpr int SAMPLE_TICKS = 3;
+        static constexpr int REPLAN_TICKS = 4;
+
+    private:
+        uint16_t held = 0;
+        int ticksLeft = 0;
+        /// @brief The bubbles that can reach the player within the horizon (reused every plan)
+        std::vector<Bubble> nearby;
+};
+
+/// @brief Creates a policy from its name (for command line tools).
+/// @return nullptr if there is no policy with that name
+std::unique_ptr<PlayerPolicy> createPolicy(const std::string &name);
+
+/// @brief The names createPolicy() accepts, separated by '|' (for usage messages).
+const char *getPolicyNames();
+
+#endif //GRAPHICS_POLICY_H
@@ -0,0 +1,146 @@
+#include "replay.h"
+#include <cstring>
+#include <iostream>
+
+using std::cout, std::endl;
+
+namespace {
+const char MAGIC[4] = {'D', 'B', 'R', 'P'};
+const uint32_t VERSION = 2;
+// Version 1 replays have no arena size (their arena is always one screen)
+const uint32_t OLDEST_VERSION = 1;
+
+const uint8_t REPLAY_BUTTONS = 1 << 0;
+const uint8_t REPLAY_MOUSE = 1 << 1;
+const uint8_t REPLAY_END = 0xFF;
+}
+
+void StateHash::addBytes(const void *data, size_t size) {
+    const unsigned char *bytes = static_cast<const unsigned char *>(data);
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ull;
+    }
+}
+
+bool ReplayWriter::open(const std::string &path, uint64_t seed, uint32_t arenaScreens) {
+    out.open(path, std::ios::binary);
+    if (!out) {
+        cout << "Could not create replay file " << path << endl;
+        return false;
+    }
+    out.write(MAGIC, sizeof(MAGIC));
+    write(VERSION);
+    write(seed);
+    write(arenaScreens);
+    last = InputFrame();
+    ticks = 0;
+    return true;
+}
+
+void ReplayWriter::record(const InputFrame &frame) {
+    uint8_t flags = 0;
+    if (frame.buttons != last.buttons) {
+        flags |= REPLAY_BUTTONS;
+    }
+    if (frame.mouseX != last.mouseX || frame.mouseY != last.mouseY) {
+        flags |= REPLAY_MOUSE;
+    }
+    write(flags);
+    writeVarint(frame.time - last.time);
+    if (flags & REPLAY_BUTTONS) {
+        write(frame.buttons);
+    }
+    if (flags & REPLAY_MOUSE) {
+        write(frame.mouseX);
+        write(frame.mouseY);
+    }
+    last = frame;
+    ticks++;
+}
+
+void ReplayWriter::finish(uint64_t stateHash) {
+    if (!out.is_open()) {
+        return;
+    }
+    write(REPLAY_END);
+    write(ticks);
+    write(stateHash);
+    out.close();
+}
+
+void ReplayWriter::writeVarint(uint64_t value) {
+    // 7 bits per byte, high bit set on every byte but the last
+    while (value >= 0x80) {
+        out.put(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    out.put(static_cast<char>(value));
+}
+
+bool ReplayReader::open(const std::string &path) {
+    in.open(path, std::ios::binary);
+    if (!in) {
+        cout << "Could not open replay file " << path << endl;
+        return false;
+    }
+    char magic[4];
+    uint32_t version;
+    if (!in.read(magic, sizeof(magic)) || memcmp(magic, MAGIC, sizeof(MAGIC)) != 0 || !read(version) || !read(seed)) {
+        cout << path << " is not a replay file" << endl;
+        return false;
+    }
+    if (version < OLDEST_VERSION || version > VERSION) {
+        cout << path << " is a version " << version << " replay (expected " << OLDEST_VERSION << " to " << VERSION
+             << ")" << endl;
+        return false;
+    }
+    arenaScreens = 1;
+    if (version >= 2 && (!read(arenaScreens) || arenaScreens == 0)) {
+        cout << path << " is not a replay file" << endl;
+        return false;
+    }
+    last = InputFrame();
+    complete = false;
+    return true;
+}
+
+bool ReplayReader::next(InputFrame &frame) {
+    uint8_t flags;
+    if (complete || !read(flags)) {
+        return false;
+    }
+    if (flags == REPLAY_END) {
+        complete = read(tickCount) && read(stateHash);
+        return false;
+    }
+    uint64_t delta;
+    if (!readVarint(delta)) {
+        return false;
+    }
+    frame = last;
+    frame.time += delta;
+    if ((flags & REPLAY_BUTTONS) && !read(frame.buttons)) {
+        return false;
+    }
+    if ((flags & REPLAY_MOUSE) && !(read(frame.mouseX) && read(frame.mouseY))) {
+        return false;
+    }
+    last = frame;
+    return true;
+}
+
+bool ReplayReader::readVarint(uint64_t &value) {
+    value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        int byte = in.get();
+        if (byte == EOF) {
+            return false;
+        }
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
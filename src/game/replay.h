@@ -0,0 +1,99 @@
+#ifndef GRAPHICS_REPLAY_H
+#define GRAPHICS_REPLAY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <type_traits>
+#include "input.h"
+
+// Replay file format (little endian):
+//   header  "DBRP", uint32 version, uint64 seed, uint32 arena size in screens (version 2 and up, 1 before)
+//   ticks   uint8 flags, varint time since the previous tick (microseconds),
+//           uint16 buttons (if flags & REPLAY_BUTTONS), int16 mouse x and y (if flags & REPLAY_MOUSE)
+//   end     uint8 REPLAY_END, uint64 tick count, uint64 state hash after the last tick
+// Buttons and mouse are only written when they change, so an idle tick is 2 bytes.
+
+/// @brief FNV-1a hash of the game state (a replay must end with the same hash as the game it recorded).
+class StateHash {
+    public:
+        template <typename T>
+        void add(const T &value) {
+            static_assert(std::is_trivially_copyable_v<T>, "Only plain data can be hashed");
+            addBytes(&value, sizeof(T));
+        }
+
+        void addBytes(const void *data, size_t size);
+
+        uint64_t get() const { return hash; }
+
+    private:
+        uint64_t hash = 14695981039346656037ull;
+};
+
+/**
+ * @brief Writes the seed, the arena size and every tick's InputFrame to a replay file.
+ */
+class ReplayWriter {
+    public:
+        /// @brief Creates the file and writes the header.
+        /// @return false if the file could not be created
+        bool open(const std::string &path, uint64_t seed, uint32_t arenaScreens = 1);
+
+        bool isOpen() const { return out.is_open(); }
+
+        /// @brief Appends one tick.
+        void record(const InputFrame &frame);
+
+        /// @brief Writes the end of the file (tick count and final state hash) and closes it.
+        void finish(uint64_t stateHash);
+
+    private:
+        std::ofstream out;
+        InputFrame last;
+        uint64_t ticks = 0;
+
+        void writeVarint(uint64_t value);
+        template <typename T>
+        void write(T value) { out.write(reinterpret_cast<const char *>(&value), sizeof(T)); }
+};
+
+/**
+ * @brief Reads a replay file back one tick at a time.
+ */
+class ReplayReader {
+    public:
+        /// @brief Opens the file and reads the header.
+        /// @return false if the file is missing or isn't a replay
+        bool open(const std::string &path);
+
+        uint64_t getSeed() const { return seed; }
+        /// @brief Width (and height) of the recorded game's arena in screens
+        uint32_t getArenaScreens() const { return arenaScreens; }
+
+        /// @brief Reads the next tick.
+        /// @return false once every tick has been read (or the file is cut short)
+        bool next(InputFrame &frame);
+
+        /// @brief True if the end of the file was read (the game closed normally while recording).
+        bool isComplete() const { return complete; }
+        /// @brief Number of ticks and the state hash the recorded game ended with (only valid if isComplete())
+        uint64_t getTickCount() const { return tickCount; }
+        uint64_t getStateHash() const { return stateHash; }
+
+    private:
+        std::ifstream in;
+        InputFrame last;
+        uint64_t seed = 0;
+        uint32_t arenaScreens = 1;
+        bool complete = false;
+        uint64_t tickCount = 0;
+        uint64_t stateHash = 0;
+
+        bool readVarint(uint64_t &value);
+        template <typename T>
+        bool read(T &value) { return static_cast<bool>(in.read(reinterpret_cast<char *>(&value), sizeof(T))); }
+};
+
+#endif //GRAPHICS_REPLAY_H
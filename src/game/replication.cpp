@@ -0,0 +1,405 @@
+#include "replication.h"
+#include <algorithm>
+#include <cmath>
+#include "session.h"
+#include "../framework/bitStream.h"
+#include "../framework/profiler.h"
+
+namespace {
+/// @brief How a bubble changed since the baseline.
+enum DeltaCode : uint32_t {
+    /// @brief Where the baseline's velocity puts it (within NET_POSITION_TOLERANCE)
+    DELTA_PREDICTED = 0,
+    /// @brief Predicted position plus a small correction (NET_NUDGE_BITS per axis)
+    DELTA_NUDGED = 1,
+    /// @brief New position, same velocity
+    DELTA_MOVED = 2,
+    /// @brief New position and velocity (it bounced)
+    DELTA_BOUNCED = 3,
+};
+
+int32_t quantize(float value, int scale, int bits) {
+    const float limit = float(1 << (bits - 1)) - 1;
+    return static_cast<int32_t>(std::lround(glm::clamp(value * scale, -limit, limit)));
+}
+
+uint32_t packColor(const vec4 &color) {
+    uint32_t packed = 0;
+    for (int channel = 0; channel < 4; ++channel) {
+        // Alpha goes above 1 (OpenGL clamps it)
+        packed |= uint32_t(std::lround(glm::clamp(color[channel], 0.0f, 1.0f) * 255)) << (channel * 8);
+    }
+    return packed;
+}
+
+/// @brief a * b / c rounded to the nearest integer (the same on the server and the client).
+int32_t scaleRounded(int64_t a, int64_t b, int64_t c) {
+    int64_t product = a * b;
+    return static_cast<int32_t>(product >= 0 ? (product + c / 2) / c : -((-product + c / 2) / c));
+}
+
+/// @brief Where a bubble of the baseline is after some ticks, going in a straight line.
+void predict(const NetBubble &bubble, uint32_t ticks, int32_t &x, int32_t &y) {
+    const int64_t scale = int64_t(NET_TICKS_PER_SECOND) * NET_VELOCITY_SCALE / NET_POSITION_SCALE;
+    x = bubble.x + scaleRounded(bubble.velocityX, ticks, scale);
+    y = bubble.y + scaleRounded(bubble.velocityY, ticks, scale);
+}
+
+bool fits(int32_t value, int bits) {
+    return value >= -(1 << (bits - 1)) && value < (1 << (bits - 1));
+}
+
+void writeBubble(BitWriter &writer, const NetBubble &bubble) {
+    writer.write(bubble.id, 32);
+    writer.writeSigned(bubble.x, NET_POSITION_BITS);
+    writer.writeSigned(bubble.y, NET_POSITION_BITS);
+    writer.writeSigned(bubble.velocityX, NET_VELOCITY_BITS);
+    writer.writeSigned(bubble.velocityY, NET_VELOCITY_BITS);
+    writer.write(bubble.radius, NET_RADIUS_BITS);
+    writer.write(bubble.color, 32);
+}
+
+bool readBubble(BitReader &reader, NetBubble &bubble) {
+    return reader.read(bubble.id, 32) &&
+           reader.readSigned(bubble.x, NET_POSITION_BITS) && reader.readSigned(bubble.y, NET_POSITION_BITS) &&
+           reader.readSigned(bubble.velocityX, NET_VELOCITY_BITS) &&
+           reader.readSigned(bubble.velocityY, NET_VELOCITY_BITS) &&
+           reader.read(bubble.radius, NET_RADIUS_BITS) && reader.read(bubble.color, 32);
+}
+
+/// @brief Whether a bubble is still the one the baseline had (ids are reused once a bubble is gone).
+bool isSameBubble(const NetBubble &a, const NetBubble &b) {
+    return a.id == b.id && a.radius == b.radius && a.color == b.color;
+}
+
+bool byId(const NetBubble &a, const NetBubble &b) {
+    return a.id < b.id;
+}
+
+vec2 lerp(vec2 from, vec2 to, float t) {
+    return from + (to - from) * t;
+}
+}
+
+void captureSnapshot(const Session &session, uint32_t sequence, uint32_t tick, NetSnapshot &snapshot) {
+    PROFILE_SCOPE("captureSnapshot");
+    snapshot.sequence = sequence;
+    snapshot.tick = tick;
+
+    snapshot.players.clear();
+    vec2 position = session.getPlayerPosition();
+    snapshot.players.push_back({quantize(position.x, NET_POSITION_SCALE, NET_POSITION_BITS),
+                                quantize(position.y, NET_POSITION_SCALE, NET_POSITION_BITS),
+                                !session.isOver() || session.getResult().survived});
+
+    snapshot.bubbles.clear();
+    session.getRegistry().each<CircleCollider, Transform, Velocity, Renderable>(
+        [&](Entity entity, const CircleCollider &collider, const Transform &transform, const Velocity &velocity,
+            const Renderable &renderable) {
+            snapshot.bubbles.push_back({
+                entity.index,
+                quantize(transform.position.x, NET_POSITION_SCALE, NET_POSITION_BITS),
+                quantize(transform.position.y, NET_POSITION_SCALE, NET_POSITION_BITS),
+                quantize(velocity.value.x, NET_VELOCITY_SCALE, NET_VELOCITY_BITS),
+                quantize(velocity.value.y, NET_VELOCITY_SCALE, NET_VELOCITY_BITS),
+                uint32_t(glm::clamp(std::lround(collider.radius * NET_POSITION_SCALE), 0l,
+                                    long(BitWriter::mask(NET_RADIUS_BITS)))),
+                packColor(renderable.color),
+            });
+        });
+    std::sort(snapshot.bubbles.begin(), snapshot.bubbles.end(), byId);
+}
+
+void writeMessage(NetPacket type, uint32_t value, vector<unsigned char> &packet) {
+    BitWriter writer(packet);
+    writer.write(type, 8);
+    writer.write(value, 32);
+    writer.flush();
+}
+
+bool readMessage(const unsigned char *data, size_t size, NetPacket &type, uint32_t &value) {
+    BitReader reader(data, size);
+    uint32_t typeBits;
+    if (!reader.read(typeBits, 8) || !reader.read(value, 32)) {
+        return false;
+    }
+    type = static_cast<NetPacket>(typeBits);
+    return true;
+}
+
+size_t getMaxSnapshotSize(size_t bubbleCount) {
+    const size_t headerBits = 8 + 32 + 32 + 32 + 3 + NET_MAX_PLAYERS * (2 * NET_POSITION_BITS + 1) + 16;
+    const size_t newBubbleBits = 32 + 2 * NET_POSITION_BITS + 2 * NET_VELOCITY_BITS + NET_RADIUS_BITS + 32;
+    // Each new bubble, plus the 1 bit of a baseline bubble that's gone
+    return (headerBits + bubbleCount * (newBubbleBits + 1) + 7) / 8;
+}
+
+void SnapshotEncoder::encode(const NetSnapshot &snapshot, vector<unsigned char> &packet) {
+    PROFILE_SCOPE("SnapshotEncoder::encode");
+    // The acknowledged snapshot is only a baseline while it's still in the history (and not about to be replaced)
+    const NetSnapshot *baseline = nullptr;
+    if (acknowledged != 0 && snapshot.sequence - acknowledged < NET_HISTORY &&
+        history[acknowledged % NET_HISTORY].sequence == acknowledged) {
+        baseline = &history[acknowledged % NET_HISTORY];
+    }
+    lastWasDelta = baseline != nullptr;
+
+    // What the client will have: the snapshot, with the positions it predicts instead of the real ones
+    NetSnapshot &sent = history[snapshot.sequence % NET_HISTORY];
+    sent.sequence = snapshot.sequence;
+    sent.tick = snapshot.tick;
+    sent.players = snapshot.players;
+    sent.bubbles = snapshot.bubbles;
+
+    BitWriter writer(packet);
+    writer.write(PACKET_SNAPSHOT, 8);
+    writer.write(snapshot.sequence, 32);
+    writer.write(baseline != nullptr ? baseline->sequence : 0, 32);
+    writer.write(snapshot.tick, 32);
+
+    int playerCount = std::min(int(snapshot.players.size()), NET_MAX_PLAYERS);
+    writer.write(playerCount, 3);
+    for (int i = 0; i < playerCount; ++i) {
+        writer.writeSigned(snapshot.players[i].x, NET_POSITION_BITS);
+        writer.writeSigned(snapshot.players[i].y, NET_POSITION_BITS);
+        writer.write(snapshot.players[i].alive, 1);
+    }
+
+    // Walk the baseline and the snapshot together (both are sorted by id); what isn't in the baseline is new
+    vector<NetBubble> &bubbles = sent.bubbles;
+    size_t next = 0;
+    size_t newCount = 0;
+    auto countNew = [&](size_t end) {
+        newCount += end - next;
+        next = end;
+    };
+    if (baseline != nullptr) {
+        const uint32_t ticks = snapshot.tick - baseline->tick;
+        for (const NetBubble &old : baseline->bubbles) {
+            size_t match = next;
+            while (match < bubbles.size() && bubbles[match].id < old.id) {
+                match++;
+            }
+            countNew(match);
+            if (match == bubbles.size() || !isSameBubble(bubbles[match], old)) {
+                // Gone (or replaced by another bubble with the same id, which is sent as a new one)
+                writer.write(0, 1);
+                continue;
+            }
+            writer.write(1, 1);
+            NetBubble &bubble = bubbles[match];
+            next = match + 1;
+            if (bubble.velocityX != old.velocityX || bubble.velocityY != old.velocityY) {
+                writer.write(DELTA_BOUNCED, 2);
+                writer.writeSigned(bubble.x, NET_POSITION_BITS);
+                writer.writeSigned(bubble.y, NET_POSITION_BITS);
+                writer.writeSigned(bubble.velocityX, NET_VELOCITY_BITS);
+                writer.writeSigned(bubble.velocityY, NET_VELOCITY_BITS);
+                continue;
+            }
+            int32_t x, y;
+            predict(old, ticks, x, y);
+            int32_t dx = bubble.x - x, dy = bubble.y - y;
+            if (std::abs(dx) <= NET_POSITION_TOLERANCE && std::abs(dy) <= NET_POSITION_TOLERANCE) {
+                writer.write(DELTA_PREDICTED, 2);
+                bubble.x = x;
+                bubble.y = y;
+            }
+            else if (fits(dx, NET_NUDGE_BITS) && fits(dy, NET_NUDGE_BITS)) {
+                writer.write(DELTA_NUDGED, 2);
+                writer.writeSigned(dx, NET_NUDGE_BITS);
+                writer.writeSigned(dy, NET_NUDGE_BITS);
+            }
+            else {
+                writer.write(DELTA_MOVED, 2);
+                writer.writeSigned(bubble.x, NET_POSITION_BITS);
+                writer.writeSigned(bubble.y, NET_POSITION_BITS);
+            }
+        }
+    }
+    countNew(bubbles.size());
+
+    // New bubbles are the ones no baseline bubble matched, in id order
+    newCount = std::min(newCount, size_t(NET_MAX_NEW_BUBBLES));
+    writer.write(uint32_t(newCount), 16);
+    size_t written = 0;
+    size_t kept = 0;
+    size_t oldIndex = 0;
+    const size_t oldCount = baseline != nullptr ? baseline->bubbles.size() : 0;
+    for (size_t i = 0; i < bubbles.size(); ++i) {
+        while (oldIndex < oldCount && baseline->bubbles[oldIndex].id < bubbles[i].id) {
+            oldIndex++;
+        }
+        if (oldIndex >= oldCount || !isSameBubble(baseline->bubbles[oldIndex], bubbles[i])) {
+            if (written == newCount) {
+                // Past the cap: the client won't have it, so it's new again next time
+                continue;
+            }
+            writeBubble(writer, bubbles[i]);
+            written++;
+        }
+        bubbles[kept++] = bubbles[i];
+    }
+    bubbles.resize(kept);
+    writer.flush();
+}
+
+void SnapshotEncoder::acknowledge(uint32_t sequence) {
+    if (sequence > acknowledged) {
+        acknowledged = sequence;
+    }
+}
+
+bool SnapshotDecoder::decode(const unsigned char *data, size_t size, NetSnapshot &snapshot) {
+    PROFILE_SCOPE("SnapshotDecoder::decode");
+    BitReader reader(data, size);
+    uint32_t type, sequence, baselineSequence, tick, playerCount;
+    if (!reader.read(type, 8) || type != PACKET_SNAPSHOT || !reader.read(sequence, 32) ||
+        !reader.read(baselineSequence, 32) || !reader.read(tick, 32) || !reader.read(playerCount, 3)) {
+        return false;
+    }
+    const NetSnapshot *baseline = nullptr;
+    if (baselineSequence != 0) {
+        baseline = &history[baselineSequence % NET_HISTORY];
+        if (baseline->sequence != baselineSequence || sequence - baselineSequence >= NET_HISTORY) {
+            return false;
+        }
+    }
+
+    snapshot.sequence = sequence;
+    snapshot.tick = tick;
+    snapshot.players.resize(playerCount);
+    for (NetPlayer &player : snapshot.players) {
+        uint32_t alive;
+        if (!reader.readSigned(player.x, NET_POSITION_BITS) || !reader.readSigned(player.y, NET_POSITION_BITS) ||
+            !reader.read(alive, 1)) {
+            return false;
+        }
+        player.alive = alive != 0;
+    }
+
+    kept.clear();
+    if (baseline != nullptr) {
+        const uint32_t ticks = tick - baseline->tick;
+        for (const NetBubble &old : baseline->bubbles) {
+            uint32_t present, code;
+            if (!reader.read(present, 1)) {
+                return false;
+            }
+            if (!present) {
+                continue;
+            }
+            if (!reader.read(code, 2)) {
+                return false;
+            }
+            NetBubble bubble = old;
+            bool valid = true;
+            if (code == DELTA_BOUNCED) {
+                valid = reader.readSigned(bubble.x, NET_POSITION_BITS) &&
+                        reader.readSigned(bubble.y, NET_POSITION_BITS) &&
+                        reader.readSigned(bubble.velocityX, NET_VELOCITY_BITS) &&
+                        reader.readSigned(bubble.velocityY, NET_VELOCITY_BITS);
+            }
+            else if (code == DELTA_MOVED) {
+                valid = reader.readSigned(bubble.x, NET_POSITION_BITS) &&
+                        reader.readSigned(bubble.y, NET_POSITION_BITS);
+            }
+            else {
+                predict(old, ticks, bubble.x, bubble.y);
+                if (code == DELTA_NUDGED) {
+                    int32_t dx, dy;
+                    valid = reader.readSigned(dx, NET_NUDGE_BITS) && reader.readSigned(dy, NET_NUDGE_BITS);
+                    bubble.x += dx;
+                    bubble.y += dy;
+                }
+            }
+            if (!valid) {
+                return false;
+            }
+            kept.push_back(bubble);
+        }
+    }
+
+    uint32_t newCount;
+    if (!reader.read(newCount, 16)) {
+        return false;
+    }
+    added.resize(newCount);
+    for (uint32_t i = 0; i < newCount; ++i) {
+        if (!readBubble(reader, added[i]) || (i > 0 && added[i].id <= added[i - 1].id)) {
+            return false;
+        }
+    }
+
+    snapshot.bubbles.resize(kept.size() + added.size());
+    std::merge(kept.begin(), kept.end(), added.begin(), added.end(), snapshot.bubbles.begin(), byId);
+
+    // Keep it as a baseline for the next ones
+    NetSnapshot &stored = history[sequence % NET_HISTORY];
+    stored.sequence = snapshot.sequence;
+    stored.tick = snapshot.tick;
+    stored.players = snapshot.players;
+    stored.bubbles = snapshot.bubbles;
+    latest = std::max(latest, sequence);
+    return true;
+}
+
+void SnapshotInterpolator::add(const NetSnapshot &snapshot) {
+    if (count > 0 && snapshot.tick <= getNewestTick()) {
+        return;
+    }
+    NetSnapshot &slot = snapshots[(first + count) % CAPACITY];
+    slot.sequence = snapshot.sequence;
+    slot.tick = snapshot.tick;
+    slot.players = snapshot.players;
+    slot.bubbles = snapshot.bubbles;
+    if (count < CAPACITY) {
+        count++;
+    }
+    else {
+        first = (first + 1) % CAPACITY;
+    }
+}
+
+bool SnapshotInterpolator::sample(double tick, InterpolatedState &state) const {
+    state.players.clear();
+    state.bubbles.clear();
+    if (count == 0) {
+        return false;
+    }
+    // The two snapshots around the tick (the same one twice before the oldest or after the newest)
+    int after = 0;
+    while (after < count && get(after).tick < tick) {
+        after++;
+    }
+    const bool inRange = after < count;
+    after = std::min(after, count - 1);
+    const NetSnapshot &to = get(after);
+    const NetSnapshot &from = get(std::max(after - 1, 0));
+    float t = 1;
+    if (to.tick != from.tick) {
+        t = float(glm::clamp((tick - from.tick) / double(to.tick - from.tick), 0.0, 1.0));
+    }
+
+    auto toPixels = [](int32_t x, int32_t y) { return vec2(x, y) / float(NET_POSITION_SCALE); };
+    for (size_t i = 0; i < to.players.size(); ++i) {
+        vec2 position = toPixels(to.players[i].x, to.players[i].y);
+        if (i < from.players.size()) {
+            position = lerp(toPixels(from.players[i].x, from.players[i].y), position, t);
+        }
+        state.players.push_back(position);
+    }
+    // Both are sorted by id; bubbles only in the newer snapshot just appear
+    size_t old = 0;
+    for (const NetBubble &bubble : to.bubbles) {
+        while (old < from.bubbles.size() && from.bubbles[old].id < bubble.id) {
+            old++;
+        }
+        vec2 position = toPixels(bubble.x, bubble.y);
+        if (old < from.bubbles.size() && isSameBubble(from.bubbles[old], bubble)) {
+            position = lerp(toPixels(from.bubbles[old].x, from.bubbles[old].y), position, t);
+        }
+        state.bubbles.push_back({bubble.id, position, float(bubble.radius) / NET_POSITION_SCALE, bubble.color});
+    }
+    return inRange;
+}
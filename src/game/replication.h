@@ -0,0 +1,173 @@
+#ifndef GRAPHICS_REPLICATION_H
+#define GRAPHICS_REPLICATION_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "glm/glm.hpp"
+
+using std::vector, glm::vec2;
+
+class Session;
+
+// State replication for spectators (and later co-op): the server sends quantized snapshots of the players and
+// bubbles, each one delta compressed against the newest snapshot the client acknowledged.
+//
+// Snapshot packet (bit packed with BitWriter):
+//   header   uint8 PACKET_SNAPSHOT, uint32 sequence, uint32 baseline sequence (0: no baseline), uint32 tick
+//   players  3 bit count, then x and y (NET_POSITION_BITS each) and 1 bit alive per player
+//   bubbles  for every bubble of the baseline (in id order): 1 bit still there, then a 2 bit DeltaCode and its data
+//            then a 16 bit count of new bubbles, each one complete (id, position, velocity, radius, color)
+// Positions are predicted from the baseline's velocity, so a bubble moving in a straight line costs 3 bits.
+
+/// @brief Packet types (the first byte of every packet).
+enum NetPacket : uint8_t {
+    /// @brief Client to server: start sending me snapshots
+    PACKET_HELLO = 1,
+    PACKET_SNAPSHOT = 2,
+    /// @brief Client to server: the newest snapshot sequence received
+    PACKET_ACK = 3,
+    /// @brief Server to client: the stream is over
+    PACKET_BYE = 4,
+};
+
+/// @brief Quantized bubble, as sent over the network.
+struct NetBubble {
+    /// @brief The bubble's entity index on the server
+    uint32_t id;
+    /// @brief Position in 1/NET_POSITION_SCALE pixels
+    int32_t x, y;
+    /// @brief Velocity in 1/NET_VELOCITY_SCALE pixels per second
+    int32_t velocityX, velocityY;
+    /// @brief Radius in 1/NET_POSITION_SCALE pixels
+    uint32_t radius;
+    /// @brief RGBA, 8 bits per channel (red in the low byte)
+    uint32_t color;
+};
+
+struct NetPlayer {
+    int32_t x, y;
+    bool alive;
+};
+
+/// @brief Everything a spectator sees at one tick.
+struct NetSnapshot {
+    uint32_t sequence = 0;
+    /// @brief Game tick the snapshot was taken at (NET_TICKS_PER_SECOND per second)
+    uint32_t tick = 0;
+    vector<NetPlayer> players;
+    /// @brief Sorted by id
+    vector<NetBubble> bubbles;
+};
+
+const int NET_TICKS_PER_SECOND = 60;
+const int NET_POSITION_SCALE = 8;
+const int NET_POSITION_BITS = 20;
+const int NET_VELOCITY_SCALE = 8;
+const int NET_VELOCITY_BITS = 14;
+const int NET_RADIUS_BITS = 12;
+/// @brief A predicted position this close (in 1/NET_POSITION_SCALE pixels) to the real one is sent as is
+const int NET_POSITION_TOLERANCE = 1;
+/// @brief Bits per axis of a small correction to the predicted position
+const int NET_NUDGE_BITS = 5;
+const int NET_MAX_PLAYERS = 7;
+const int NET_MAX_NEW_BUBBLES = 0xFFFF;
+/// @brief Snapshots kept to delta compress against (about 2 seconds at 30 snapshots per second)
+const int NET_HISTORY = 64;
+
+/// @brief Largest a snapshot with this many bubbles can be, in bytes
+/// @details The worst case is a delta where every bubble is new (sent complete) and as many baseline bubbles are gone.
+size_t getMaxSnapshotSize(size_t bubbleCount);
+
+/// @brief Quantizes the session's player and bubbles.
+void captureSnapshot(const Session &session, uint32_t sequence, uint32_t tick, NetSnapshot &snapshot);
+
+/// @brief Writes a packet that only holds its type and one number (hello, ack and bye).
+void writeMessage(NetPacket type, uint32_t value, vector<unsigned char> &packet);
+
+/// @brief Reads a packet written by writeMessage().
+bool readMessage(const unsigned char *data, size_t size, NetPacket &type, uint32_t &value);
+
+/**
+ * @brief Server side: writes the snapshots sent to one client.
+ * @details Keeps the last NET_HISTORY snapshots as the client will see them, so each one can be the baseline of a
+ * later one once the client acknowledges it. Sends a complete snapshot until then.
+ */
+class SnapshotEncoder {
+    public:
+        /// @brief Writes a snapshot packet (snapshot.sequence must be higher than the last one's).
+        void encode(const NetSnapshot &snapshot, vector<unsigned char> &packet);
+
+        /// @brief The client received this snapshot (older acknowledgements are ignored).
+        void acknowledge(uint32_t sequence);
+
+        uint32_t getAcknowledged() const { return acknowledged; }
+        /// @brief Whether the last packet was delta compressed
+        bool wasDelta() const            { return lastWasDelta; }
+
+    private:
+        NetSnapshot history[NET_HISTORY];
+        uint32_t acknowledged = 0;
+        bool lastWasDelta = false;
+};
+
+/**
+ * @brief Client side: rebuilds snapshots from packets.
+ */
+class SnapshotDecoder {
+    public:
+        /// @brief Decodes a snapshot packet.
+        /// @return false if the packet is malformed, or its baseline is too old (the server sends a newer one once
+        /// it gets the next acknowledgement)
+        bool decode(const unsigned char *data, size_t size, NetSnapshot &snapshot);
+
+        /// @brief The newest sequence decoded (what to acknowledge)
+        uint32_t getLatestSequence() const { return latest; }
+
+    private:
+        NetSnapshot history[NET_HISTORY];
+        uint32_t latest = 0;
+        /// @brief The baseline's bubbles that are still there, and the new ones (reused every decode)
+        vector<NetBubble> kept, added;
+};
+
+/// @brief A bubble between two snapshots, back in pixels.
+struct InterpolatedBubble {
+    uint32_t id;
+    vec2 position;
+    float radius;
+    uint32_t color;
+};
+
+struct InterpolatedState {
+    vector<vec2> players;
+    vector<InterpolatedBubble> bubbles;
+};
+
+/**
+ * @brief Client side: smooths snapshots out by drawing a little in the past, between the two snapshots around it.
+ */
+class SnapshotInterpolator {
+    public:
+        static constexpr int CAPACITY = 16;
+
+        /// @brief Keeps a decoded snapshot (ignored if it's older than the newest one kept).
+        void add(const NetSnapshot &snapshot);
+
+        /// @brief The state at a (fractional) tick.
+        /// @return false if there's no snapshot yet, or tick is past the newest one (which is returned instead)
+        bool sample(double tick, InterpolatedState &state) const;
+
+        bool isEmpty() const           { return count == 0; }
+        uint32_t getNewestTick() const { return count == 0 ? 0 : get(count - 1).tick; }
+
+    private:
+        /// @brief The i-th oldest snapshot
+        const NetSnapshot &get(int i) const { return snapshots[(first + i) % CAPACITY]; }
+
+        NetSnapshot snapshots[CAPACITY];
+        int first = 0;
+        int count = 0;
+};
+
+#endif //GRAPHICS_REPLICATION_H
@@ -0,0 +1,65 @@
+#include "session.h"
+#include "player.h"
+
+Session::Session(int level, uint64_t seed, std::unique_ptr<PlayerPolicy> policy, vec2 bounds) :
+    // Same seed as Engine::getLevelSeed()
+    Session(getLevelConfig(level), Random::mix(seed, level), std::move(policy), bounds) {
+    result.level = level;
+    result.seed = seed;
+}
+
+Session::Session(const LevelConfig &config, uint64_t levelSeed, std::unique_ptr<PlayerPolicy> policy, vec2 bounds) :
+    bounds(bounds),
+    arena(getSpawnArenaSize(config.numberOfBubbles)),
+    world(bounds),
+    // A separate stream for the policy
+    random(Random::mix(levelSeed, 1)),
+    policy(std::move(policy)) {
+    result.seed = levelSeed;
+
+    LevelSpawns spawns = generateBubbles(config, unsigned(bounds.x), unsigned(bounds.y), levelSeed, arena);
+    registry.reserve(spawns.count + 1);
+    for (int i = 0; i < spawns.count; ++i) {
+        spawnBubble(registry, spawns.bubbles[i]);
+    }
+    player = registry.create();
+    registry.add(player, Transform{bounds / 2.0f, vec2(PLAYER_SIZE)});
+    registry.add(player, RectCollider{vec2(PLAYER_SIZE / 2)});
+    world.load(registry);
+    hazards.update(world, bounds / 2.0f - vec2(PLAYER_SIZE / 2), bounds / 2.0f + vec2(PLAYER_SIZE / 2));
+    arena.reset();
+}
+
+bool Session::step() {
+    if (over) {
+        return false;
+    }
+    // Same order as the game: input, level timer, bubbles, then the player/bubble check
+    Transform &playerTransform = registry.get<Transform>(player);
+    movePlayer(playerTransform.position, playerTransform.size, policy->decide(*this, random), bounds);
+    ticks++;
+    float time = getTime();
+    if (time >= LEVEL_TIME) {
+        over = true;
+        result.survived = true;
+    }
+    else {
+        world.step(registry, TICK);
+        const RectCollider &collider = registry.get<RectCollider>(player);
+        const HazardReport &hazard = hazards.update(world, playerTransform.position - collider.halfSize,
+                                                    playerTransform.position + collider.halfSize);
+        if (time >= SPAWN_GRACE_TIME && hazard.hit.isValid()) {
+            over = true;
+        }
+    }
+    if (over) {
+        result.timeSurvived = result.survived ? LEVEL_TIME : time;
+        result.ticks = ticks;
+    }
+    return !over;
+}
+
+SessionResult Session::run() {
+    while (step()) {}
+    return result;
+}
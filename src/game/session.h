@@ -0,0 +1,80 @@
+#ifndef GRAPHICS_SESSION_H
+#define GRAPHICS_SESSION_H
+
+#include <cstdint>
+#include <memory>
+#include "level.h"
+#include "world.h"
+#include "hazards.h"
+#include "policy.h"
+#include "../ecs/registry.h"
+#include "../framework/arena.h"
+#include "../framework/random.h"
+
+/// @brief How a simulated level ended.
+struct SessionResult {
+    /// @brief The level played (0 for sessions made from a LevelConfig)
+    int level = 0;
+    uint64_t seed = 0;
+    bool survived = false;
+    /// @brief Seconds until the player was hit (LEVEL_TIME if they survived)
+    float timeSurvived = 0;
+    uint64_t ticks = 0;
+};
+
+/**
+ * @brief One simulated attempt at a level, played by a PlayerPolicy.
+ * @details Uses the game's rules (level generation, bubble physics, player movement, grace period and level time)
+ * at a fixed 60 ticks per second. Owns everything it touches (no OpenGL, no globals), so any number of sessions
+ * can run at once on different threads.
+ */
+class Session {
+    public:
+        static constexpr float TICK = 1.0f / 60.0f;
+
+        /// @param level The level to play
+        /// @param seed The game seed (the level's bubbles are the same as in a game started with --seed)
+        /// @param policy Plays the session
+        /// @param bounds The size of the playfield (the game window by default)
+        Session(int level, uint64_t seed, std::unique_ptr<PlayerPolicy> policy, vec2 bounds = vec2(1600, 1200));
+
+        /// @brief A session with any bubble stats (used to tune levels).
+        /// @param config The bubble stats
+        /// @param levelSeed Seed for the bubbles and the policy
+        Session(const LevelConfig &config, uint64_t levelSeed, std::unique_ptr<PlayerPolicy> policy,
+                vec2 bounds = vec2(1600, 1200));
+
+        /// @brief Plays one tick.
+        /// @return false once the session is over (the player was hit or survived the level)
+        bool step();
+
+        /// @brief Plays until the session is over.
+        SessionResult run();
+
+        const SessionResult &getResult() const  { return result; }
+        bool isOver() const                     { return over; }
+        /// @brief Seconds since the level started
+        float getTime() const                   { return ticks * TICK; }
+        vec2 getBounds() const                  { return bounds; }
+        const Registry &getRegistry() const     { return registry; }
+        const World &getWorld() const           { return world; }
+        /// @brief Bubbles around the player after the last tick (what the player saw before deciding)
+        const HazardReport &getHazards() const  { return hazards.getReport(); }
+        Entity getPlayer() const                { return player; }
+        vec2 getPlayerPosition() const          { return registry.get<Transform>(player).position; }
+
+    private:
+        vec2 bounds;
+        Arena arena;
+        Registry registry;
+        World world;
+        HazardQuery hazards;
+        Random random;
+        std::unique_ptr<PlayerPolicy> policy;
+        Entity player;
+        uint64_t ticks = 0;
+        bool over = false;
+        SessionResult result;
+};
+
+#endif //GRAPHICS_SESSION_H
@@ -0,0 +1,40 @@
+#include "spatialGrid.h"
+#include <algorithm>
+#include <cmath>
+
+int SpatialGrid::getColumn(float x) const {
+    return std::clamp(static_cast<int>(x / cellSize), 0, columns - 1);
+}
+
+int SpatialGrid::getRow(float y) const {
+    return std::clamp(static_cast<int>(y / cellSize), 0, rows - 1);
+}
+
+void SpatialGrid::build(const vector<Bubble> &bubbles, vec2 bounds, float cellSize) {
+    this->cellSize = cellSize;
+    columns = std::max(1, static_cast<int>(std::ceil(bounds.x / cellSize)));
+    rows = std::max(1, static_cast<int>(std::ceil(bounds.y / cellSize)));
+
+    // Count the bubbles in each cell
+    cellStart.assign(columns * rows + 1, 0);
+    bubbleCell.resize(bubbles.size());
+    for (size_t i = 0; i < bubbles.size(); ++i) {
+        int cell = getRow(bubbles[i].position.y) * columns + getColumn(bubbles[i].position.x);
+        bubbleCell[i] = cell;
+        cellStart[cell + 1]++;
+    }
+
+    // Turn the counts into start offsets, then drop every bubble into its cell
+    for (size_t cell = 1; cell < cellStart.size(); ++cell) {
+        cellStart[cell] += cellStart[cell - 1];
+    }
+    indices.resize(bubbles.size());
+    for (size_t i = bubbles.size(); i > 0; --i) {
+        indices[--cellStart[bubbleCell[i - 1] + 1]] = static_cast<int>(i - 1);
+    }
+    // cellStart[c + 1] was decremented once per bubble in c, so it now holds the start of cell c
+    for (size_t cell = 0; cell + 1 < cellStart.size(); ++cell) {
+        cellStart[cell] = cellStart[cell + 1];
+    }
+    cellStart.back() = static_cast<int>(bubbles.size());
+}
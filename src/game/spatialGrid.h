@@ -0,0 +1,91 @@
+#ifndef GRAPHICS_SPATIALGRID_H
+#define GRAPHICS_SPATIALGRID_H
+
+#include <vector>
+#include "glm/glm.hpp"
+
+using std::vector, glm::vec2;
+
+/// @brief State of one bubble in the simulation (no OpenGL, see World).
+struct Bubble {
+    vec2 position;
+    vec2 velocity;
+    float radius;
+};
+
+/**
+ * @brief Uniform grid over the playfield used to find bubbles that might overlap.
+ * @details Rebuilt every step with a counting sort, so building is O(n) and doesn't allocate once the grid has
+ * reached its size. Cells are at least as wide as the largest bubble, so overlapping bubbles are always in the same
+ * or neighbouring cells.
+ */
+class SpatialGrid {
+    public:
+        /// @brief Sorts the bubbles into cells.
+        /// @param bounds The width and height of the playfield
+        /// @param cellSize Width and height of a cell (at least the largest bubble's diameter)
+        void build(const vector<Bubble> &bubbles, vec2 bounds, float cellSize);
+
+        int getColumns() const { return columns; }
+        int getRows() const    { return rows; }
+
+        /// @brief Calls pair(i, j) once for every pair of bubbles in the same or neighbouring cells.
+        /// @details Only pairs whose first bubble is in rows [firstRow, lastRow) are visited, so rows can be split
+        /// between threads.
+        template <typename PairFunction>
+        void forEachPair(int firstRow, int lastRow, PairFunction pair) const {
+            // Visit the cell itself and the 4 "forward" neighbours, so each pair of cells is only visited once
+            const int offsets[4][2] = {{1, 0}, {-1, 1}, {0, 1}, {1, 1}};
+            for (int row = firstRow; row < lastRow; ++row) {
+                for (int column = 0; column < columns; ++column) {
+                    int cell = row * columns + column;
+                    for (int a = cellStart[cell]; a < cellStart[cell + 1]; ++a) {
+                        for (int b = a + 1; b < cellStart[cell + 1]; ++b) {
+                            pair(indices[a], indices[b]);
+                        }
+                        for (const int *offset : offsets) {
+                            int otherColumn = column + offset[0];
+                            int otherRow = row + offset[1];
+                            if (otherColumn < 0 || otherColumn >= columns || otherRow >= rows) {
+                                continue;
+                            }
+                            int other = otherRow * columns + otherColumn;
+                            for (int b = cellStart[other]; b < cellStart[other + 1]; ++b) {
+                                pair(indices[a], indices[b]);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+
+        /// @brief Calls visit(i) for every bubble in a cell touching the rectangle [min, max].
+        /// @details Bubbles are only sorted by their center, so pass a rectangle grown by the largest radius.
+        template <typename VisitFunction>
+        void forEachInRange(vec2 min, vec2 max, VisitFunction visit) const {
+            int firstColumn = getColumn(min.x), lastColumn = getColumn(max.x);
+            int firstRow = getRow(min.y), lastRow = getRow(max.y);
+            for (int row = firstRow; row <= lastRow; ++row) {
+                for (int column = firstColumn; column <= lastColumn; ++column) {
+                    int cell = row * columns + column;
+                    for (int a = cellStart[cell]; a < cellStart[cell + 1]; ++a) {
+                        visit(indices[a]);
+                    }
+                }
+            }
+        }
+
+    private:
+        int getColumn(float x) const;
+        int getRow(float y) const;
+
+        float cellSize = 1;
+        int columns = 0, rows = 0;
+        /// @brief Bubbles of cell c are indices[cellStart[c]] to indices[cellStart[c + 1] - 1]
+        vector<int> cellStart;
+        vector<int> indices;
+        /// @brief Cell of each bubble (scratch for build())
+        vector<int> bubbleCell;
+};
+
+#endif //GRAPHICS_SPATIALGRID_H
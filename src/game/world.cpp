@@ -0,0 +1,147 @@
+#include "world.h"
+#include <algorithm>
+#include <cmath>
+#include "physics.h"
+#include "../framework/profiler.h"
+#include "../framework/threadPool.h"
+
+World::World(vec2 bounds, int threadCount) : bounds(bounds), threadCount(1) {
+    setThreadCount(threadCount);
+}
+
+World::~World() = default;
+
+void World::setThreadCount(int threadCount) {
+    threadCount = std::max(1, threadCount);
+    if (workers == nullptr || workers->getThreadCount() != threadCount - 1) {
+        workers.reset();
+        if (threadCount > 1) {
+            workers = std::make_unique<ThreadPool>(threadCount - 1);
+        }
+    }
+    this->threadCount = threadCount;
+    contacts.resize(threadCount);
+    pairTests.resize(threadCount);
+    slices.resize(threadCount);
+}
+
+void World::gather(const Registry &registry) {
+    const ComponentArray<CircleCollider> &colliders = registry.components<CircleCollider>();
+    const ComponentArray<Transform> &transforms = registry.components<Transform>();
+    const ComponentArray<Velocity> &velocities = registry.components<Velocity>();
+
+    bubbles.clear();
+    entities.clear();
+    maxRadius = 0;
+    for (size_t i = 0; i < colliders.size(); ++i) {
+        Entity entity = colliders.getEntities()[i];
+        const Velocity *velocity = velocities.find(entity);
+        if (velocity == nullptr || !transforms.has(entity)) {
+            continue;
+        }
+        float radius = colliders.data()[i].radius;
+        bubbles.push_back({transforms.get(entity).position, velocity->value, radius});
+        entities.push_back(entity);
+        maxRadius = std::max(maxRadius, radius);
+    }
+}
+
+void World::updateMaxSpeed() {
+    float maxSpeedSquared = 0;
+    for (const Bubble &bubble : bubbles) {
+        maxSpeedSquared = std::max(maxSpeedSquared, glm::dot(bubble.velocity, bubble.velocity));
+    }
+    maxSpeed = std::sqrt(maxSpeedSquared);
+}
+
+void World::load(const Registry &registry) {
+    gather(registry);
+    updateMaxSpeed();
+    // Roughly one contact per bubble is already a crowded playfield, so the lists rarely grow mid-game
+    grid.build(bubbles, bounds, std::max(2 * maxRadius, 1.0f));
+    for (vector<Contact> &list : contacts) {
+        list.reserve(bubbles.size() / threadCount + 1);
+    }
+}
+
+void World::step(Registry &registry, float deltaTime) {
+    PROFILE_SCOPE("world:step");
+    gather(registry);
+    {
+        PROFILE_SCOPE("world:move");
+        for (Bubble &bubble : bubbles) {
+            moveInBounds(bubble.position, bubble.velocity, bubble.radius, deltaTime, bounds);
+        }
+    }
+
+    {
+        PROFILE_SCOPE("world:grid");
+        // Cells as wide as the largest bubble, so overlapping bubbles are in the same or neighbouring cells
+        grid.build(bubbles, bounds, std::max(2 * maxRadius, 1.0f));
+    }
+
+    {
+        PROFILE_SCOPE("world:broadphase");
+        const int rows = grid.getRows();
+        const int sliceCount = std::min(threadCount, rows);
+        for (int slice = 0; slice < sliceCount; ++slice) {
+            slices[slice] = {rows * slice / sliceCount, rows * (slice + 1) / sliceCount};
+        }
+        // Only this and the slice index are captured, small enough that std::function doesn't allocate
+        for (int slice = 1; slice < sliceCount; ++slice) {
+            workers->submit([this, slice] { findContacts(slice, slices[slice].firstRow, slices[slice].lastRow); });
+        }
+        findContacts(0, slices[0].firstRow, slices[0].lastRow);
+        if (sliceCount > 1) {
+            workers->wait();
+        }
+        for (int slice = sliceCount; slice < threadCount; ++slice) {
+            contacts[slice].clear();
+            pairTests[slice] = 0;
+        }
+    }
+
+    // Bounce in grid order on this thread, so the result doesn't depend on the thread count
+    PROFILE_SCOPE("world:resolve");
+    stepStats = StepStats();
+    for (int slice = 0; slice < threadCount; ++slice) {
+        stepStats.pairTests += pairTests[slice];
+        for (const Contact &contact : contacts[slice]) {
+            Bubble &a = bubbles[contact.a];
+            Bubble &b = bubbles[contact.b];
+            // An earlier bounce this step may have already pushed them apart
+            if (bounceCircles(a.position, a.velocity, a.radius, b.position, b.velocity, b.radius)) {
+                stepStats.contacts++;
+            }
+        }
+    }
+
+    {
+        // Sorted again by where the bubbles ended up, so queries between steps (forEachNear, HazardQuery) are exact
+        PROFILE_SCOPE("world:regrid");
+        grid.build(bubbles, bounds, std::max(2 * maxRadius, 1.0f));
+    }
+    updateMaxSpeed();
+
+    // Write the results back
+    ComponentArray<Transform> &transforms = registry.components<Transform>();
+    ComponentArray<Velocity> &velocities = registry.components<Velocity>();
+    for (size_t i = 0; i < bubbles.size(); ++i) {
+        transforms.get(entities[i]).position = bubbles[i].position;
+        velocities.get(entities[i]).value = bubbles[i].velocity;
+    }
+}
+
+void World::findContacts(int slice, int firstRow, int lastRow) {
+    PROFILE_SCOPE("world:findContacts");
+    vector<Contact> &list = contacts[slice];
+    uint64_t tests = 0;
+    list.clear();
+    grid.forEachPair(firstRow, lastRow, [&](int a, int b) {
+        tests++;
+        if (circlesOverlap(bubbles[a].position, bubbles[a].radius, bubbles[b].position, bubbles[b].radius)) {
+            list.push_back({std::min(a, b), std::max(a, b)});
+        }
+    });
+    pairTests[slice] = tests;
+}
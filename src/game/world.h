@@ -0,0 +1,119 @@
+#ifndef GRAPHICS_WORLD_H
+#define GRAPHICS_WORLD_H
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "glm/glm.hpp"
+#include "spatialGrid.h"
+#include "../ecs/registry.h"
+
+using std::vector, glm::vec2;
+
+class ThreadPool;
+
+/// @brief Work done by the last World::step().
+struct StepStats {
+    /// @brief Pairs of bubbles the broadphase tested for overlap
+    uint64_t pairTests = 0;
+    /// @brief Pairs of bubbles that were overlapping and got bounced apart
+    uint64_t contacts = 0;
+};
+
+/**
+ * @brief The bubble simulation (movement, walls and bubble/bubble bounces), without any OpenGL.
+ * @details Simulates every entity with a CircleCollider, Transform and Velocity. Each step gathers them into a packed
+ * array, moves and bounces them, then writes the results back to the registry.
+ * Overlapping pairs are found with a SpatialGrid, optionally split across threads, then bounced on the calling thread
+ * in grid order, so the result is the same for any number of threads. The threads are started once (by the
+ * constructor or setThreadCount()), not every step.
+ */
+class World {
+    public:
+        /// @param bounds The width and height of the playfield
+        /// @param threadCount Threads used to find overlapping bubbles (1 keeps everything on the calling thread)
+        explicit World(vec2 bounds, int threadCount = 1);
+        ~World();
+
+        World(const World &) = delete;
+        World &operator=(const World &) = delete;
+
+        /// @brief Sizes everything step() uses for the registry's bubbles, so stepping doesn't allocate.
+        /// @details Call after spawning a level (step() still works without it, it just allocates the first time).
+        void load(const Registry &registry);
+
+        /// @brief Moves every bubble, bounces them off the walls and each other.
+        void step(Registry &registry, float deltaTime);
+
+        /// @brief The bubbles as of the end of the last step(), and the entity each one belongs to (same order)
+        const vector<Bubble> &getBubbles() const        { return bubbles; }
+        const vector<Entity> &getBubbleEntities() const { return entities; }
+        /// @brief Grid of the bubbles' positions at the end of the last step() (or load())
+        const SpatialGrid &getGrid() const       { return grid; }
+        const StepStats &getStepStats() const    { return stepStats; }
+        vec2 getBounds() const                   { return bounds; }
+        float getMaxRadius() const               { return maxRadius; }
+        /// @brief Speed of the fastest bubble as of the end of the last step() (or load()), in pixels per second
+        float getMaxSpeed() const                { return maxSpeed; }
+        int getThreadCount() const               { return threadCount; }
+
+        /**
+         * @brief Calls visit(bubble) for every bubble that may be within range of point (nearest-threat queries).
+         * @details Visits whole grid cells, so it may also visit bubbles a little further away.
+         */
+        template <typename VisitFunction>
+        void forEachNear(vec2 point, float range, VisitFunction visit) const {
+            forEachIndexNear(point, range, [&](int index) { visit(bubbles[index]); });
+        }
+
+        /// @brief Same as forEachNear(), but visit(index) gets the index in getBubbles() and getBubbleEntities().
+        template <typename VisitFunction>
+        void forEachIndexNear(vec2 point, float range, VisitFunction visit) const {
+            forEachIndexInRect(point - vec2(range), point + vec2(range), visit);
+        }
+
+        /// @brief Calls visit(index) for every bubble that may overlap the rectangle [min, max] (camera culling).
+        template <typename VisitFunction>
+        void forEachIndexInRect(vec2 min, vec2 max, VisitFunction visit) const {
+            grid.forEachInRange(min - vec2(maxRadius), max + vec2(maxRadius), visit);
+        }
+
+        void setBounds(vec2 bounds)              { this->bounds = bounds; }
+        /// @brief Starts (or stops) the threads the broadphase is split across
+        void setThreadCount(int threadCount);
+
+    private:
+        /// @brief Copies the bubbles out of the registry.
+        void gather(const Registry &registry);
+        /// @brief Finds the speed of the fastest bubble (bounces change it, so after the bubbles move).
+        void updateMaxSpeed();
+
+        /// @brief Finds the overlapping pairs whose first bubble is in rows [firstRow, lastRow) of the grid.
+        void findContacts(int slice, int firstRow, int lastRow);
+
+        vec2 bounds;
+        int threadCount;
+        vector<Bubble> bubbles;
+        vector<Entity> entities;
+        float maxRadius = 0;
+        float maxSpeed = 0;
+
+        SpatialGrid grid;
+        StepStats stepStats;
+
+        /// @brief Overlapping pairs and pair test counts, one list per thread
+        struct Contact {
+            int a, b;
+        };
+        vector<vector<Contact>> contacts;
+        vector<uint64_t> pairTests;
+        /// @brief Grid rows [first, last) of each slice of the broadphase (slice 0 runs on the calling thread)
+        struct Slice {
+            int firstRow, lastRow;
+        };
+        vector<Slice> slices;
+        /// @brief Runs slices 1 and up (null with a single thread)
+        std::unique_ptr<ThreadPool> workers;
+};
+
+#endif //GRAPHICS_WORLD_H
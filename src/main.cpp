@@ -1,15 +1,199 @@
 #include "engine.h"
 
+#include <algorithm>
+#include <chrono>
 #include <iostream>
+#include <string>
+
+// Re-runs a recorded game without a window, as fast as possible, and checks it ends in the same state
+int runReplay(const std::string &path) {
+    ReplayReader replay;
+    if (!replay.open(path)) {
+        return 1;
+    }
+    Engine engine(replay.getSeed(), true, static_cast<int>(replay.getArenaScreens()));
+
+    InputFrame frame;
+    uint64_t ticks = 0;
+    auto start = std::chrono::steady_clock::now();
+    while (replay.next(frame)) {
+        {
+            PROFILE_SCOPE("frame");
+            engine.processInput(frame);
+            engine.update();
+        }
+#ifdef DODGEBALL_ALLOCATION_TRACKING
+        AllocationTracker::endFrame();
+#endif
+        PROFILE_FRAME();
+        ticks++;
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "Replayed " << ticks << " ticks in " << seconds << "s (" << ticks / seconds << " ticks/s)" << std::endl;
+
+#ifdef DODGEBALL_PROFILER
+    Profiler::get().stopCapture();
+#endif
+
+    if (!replay.isComplete()) {
+        std::cout << "Replay file was cut short, the final state can't be checked" << std::endl;
+        return 1;
+    }
+    uint64_t hash = engine.getStateHash();
+    if (ticks != replay.getTickCount() || hash != replay.getStateHash()) {
+        std::cout << "Replay diverged: " << ticks << " ticks, state hash " << std::hex << hash << " (recorded "
+                  << std::dec << replay.getTickCount() << " ticks, state hash " << std::hex << replay.getStateHash()
+                  << ")" << std::dec << std::endl;
+        return 1;
+    }
+    std::cout << "Final state matches (state hash " << std::hex << hash << std::dec << ")" << std::endl;
+    return 0;
+}
 
 int main(int argc, char *argv[]) {
-    Engine engine;
+    // --seed <n> replays a previous game's levels
+    // --arena <screens> plays in an arena that many screens wide and high (the camera follows the player)
+    // --trace <frames> [file] writes the first frames (including startup) as a Chrome trace
+    // --alloc-check <off|warn|abort> what to do when the play screen allocates (warn in debug builds, off otherwise)
+    // --render-scale <0.25-1|auto> renders at that fraction of the window's resolution and upscales (auto changes
+    //     the scale to keep the GPU time of a frame near --frame-target)
+    // --frame-target <ms> GPU time per frame the automatic render scale aims for (12 by default)
+    // --render-filter <nearest|linear> how a scaled frame is upscaled (linear by default)
+    // --native-text draws text at the window's resolution on top of a scaled frame
+    // --record <file> writes the seed and every tick's input to a replay file
+    // --replay <file> re-runs a replay file headless at full speed and checks the final state
+    uint64_t seed = Random::randomSeed();
+    std::string recordPath;
+    std::string replayPath;
+    int arenaScreens = 1;
+    RenderScaleSettings renderScale;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--seed" && i + 1 < argc) {
+            seed = std::stoull(argv[++i]);
+        }
+        else if (arg == "--arena" && i + 1 < argc) {
+            arenaScreens = std::max(1, std::stoi(argv[++i]));
+        }
+        else if (arg == "--render-scale" && i + 1 < argc) {
+            std::string scale = argv[++i];
+            if (scale == "auto") {
+                renderScale.automatic = true;
+            }
+            else {
+                renderScale.scale = std::stof(scale);
+            }
+        }
+        else if (arg == "--frame-target" && i + 1 < argc) {
+            renderScale.targetFrameTime = static_cast<uint64_t>(std::stod(argv[++i]) * 1000);
+        }
+        else if (arg == "--render-filter" && i + 1 < argc) {
+            std::string filter = argv[++i];
+            if (filter == "nearest") {
+                renderScale.filter = ScaleFilter::nearest;
+            }
+            else if (filter == "linear") {
+                renderScale.filter = ScaleFilter::linear;
+            }
+            else {
+                std::cout << "--render-filter must be nearest or linear" << std::endl;
+            }
+        }
+        else if (arg == "--native-text") {
+            renderScale.nativeText = true;
+        }
+        else if (arg == "--trace" && i + 1 < argc) {
+            [[maybe_unused]] int frames = std::stoi(argv[++i]);
+            [[maybe_unused]] std::string path = "trace.json";
+            if (i + 1 < argc && argv[i + 1][0] != '-') {
+                path = argv[++i];
+            }
+#ifdef DODGEBALL_PROFILER
+            Profiler::get().startCapture(frames, path);
+#else
+            std::cout << "--trace needs a build with DODGEBALL_PROFILER" << std::endl;
+#endif
+        }
+        else if (arg == "--alloc-check" && i + 1 < argc) {
+            std::string check = argv[++i];
+#ifdef DODGEBALL_ALLOCATION_TRACKING
+            if (check == "off") {
+                AllocationTracker::setCheck(AllocationCheck::off);
+            }
+            else if (check == "warn") {
+                AllocationTracker::setCheck(AllocationCheck::warn);
+            }
+            else if (check == "abort") {
+                AllocationTracker::setCheck(AllocationCheck::abort);
+            }
+            else {
+                std::cout << "--alloc-check must be off, warn or abort" << std::endl;
+            }
+#else
+            std::cout << "--alloc-check needs a build with DODGEBALL_ALLOCATION_TRACKING" << std::endl;
+#endif
+        }
+        else if (arg == "--record" && i + 1 < argc) {
+            recordPath = argv[++i];
+        }
+        else if (arg == "--replay" && i + 1 < argc) {
+            replayPath = argv[++i];
+        }
+    }
+
+    if (!replayPath.empty()) {
+        return runReplay(replayPath);
+    }
+
+    Engine engine(seed, false, arenaScreens);
+    engine.setRenderScale(renderScale);
+    ReplayWriter recorder;
+    if (!recordPath.empty()) {
+        recorder.open(recordPath, seed, arenaScreens);
+    }
+
+    // A frame is input -> physics -> (HUD layout || draw lists) -> submit. Input and submit stay on this thread
+    // (GLFW and OpenGL), the rest runs wherever the job system has a free thread.
+    JobSystem jobs;
+    TaskGraph frame;
+    int inputTask = frame.add("input", [&] {
+        InputFrame input = engine.pollInput();
+        if (recorder.isOpen()) {
+            recorder.record(input);
+        }
+        engine.processInput(input);
+    }, TaskGraph::Affinity::main);
+    int physicsTask = frame.add("physics", [&] { engine.update(); });
+    int hudTask = frame.add("hudLayout", [&] { engine.layoutHud(); });
+    int drawListTask = frame.add("drawLists", [&] { engine.prepareDraws(); });
+    int submitTask = frame.add("submit", [&] { engine.render(); }, TaskGraph::Affinity::main);
+    frame.addDependency(physicsTask, inputTask);
+    frame.addDependency(hudTask, physicsTask);
+    frame.addDependency(drawListTask, physicsTask);
+    frame.addDependency(submitTask, hudTask);
+    frame.addDependency(submitTask, drawListTask);
+    engine.setFrameGraph(&frame);
 
     while (!engine.shouldClose()) {
-        engine.processInput();
-        engine.update();
-        engine.render();
+        {
+            PROFILE_SCOPE("frame");
+            frame.run(jobs);
+        }
+#ifdef DODGEBALL_ALLOCATION_TRACKING
+        AllocationTracker::endFrame();
+#endif
+#ifdef DODGEBALL_GL_STATS
+        GLStats::endFrame();
+#endif
+        PROFILE_FRAME();
     }
+    engine.reportFrameTimes(std::cout);
+    recorder.finish(engine.getStateHash());
+
+#ifdef DODGEBALL_PROFILER
+    // Write a capture that was still running when the window closed
+    Profiler::get().stopCapture();
+#endif
 
     glfwTerminate();
     return 0;
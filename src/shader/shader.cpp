@@ -1,48 +1,60 @@
 #include "shader.h"
+#include "../framework/log.h"
 
 Shader &Shader::use() {
     glUseProgram(this->ID);
     return *this;
 }
 
-void Shader::compile(const char* vertexSource, const char* fragmentSource, const char* geometrySource) {
-    unsigned int sVertex, sFragment, gShader;
+bool Shader::compile(const char* vertexSource, const char* fragmentSource, const char* geometrySource) {
+    return finish(submit(vertexSource, fragmentSource, geometrySource));
+}
+
+ShaderStages Shader::submit(const char* vertexSource, const char* fragmentSource, const char* geometrySource) {
+    ShaderStages stages;
 
     // vertex Shader
-    sVertex = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(sVertex, 1, &vertexSource, NULL);
-    glCompileShader(sVertex);
-    checkCompileErrors(sVertex, "VERTEX");
+    stages.vertex = glCreateShader(GL_VERTEX_SHADER);
+    glShaderSource(stages.vertex, 1, &vertexSource, NULL);
+    glCompileShader(stages.vertex);
 
     // fragment Shader
-    sFragment = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(sFragment, 1, &fragmentSource, NULL);
-    glCompileShader(sFragment);
-    checkCompileErrors(sFragment, "FRAGMENT");
+    stages.fragment = glCreateShader(GL_FRAGMENT_SHADER);
+    glShaderSource(stages.fragment, 1, &fragmentSource, NULL);
+    glCompileShader(stages.fragment);
 
     // if geometry shader source code is given, also compile geometry shader
     if (geometrySource != nullptr) {
-        gShader = glCreateShader(GL_GEOMETRY_SHADER);
-        glShaderSource(gShader, 1, &geometrySource, NULL);
-        glCompileShader(gShader);
-        checkCompileErrors(gShader, "GEOMETRY");
+        stages.geometry = glCreateShader(GL_GEOMETRY_SHADER);
+        glShaderSource(stages.geometry, 1, &geometrySource, NULL);
+        glCompileShader(stages.geometry);
     }
 
-    // shader program
+    // shader program (linking doesn't have to wait for the compiles, the driver orders them)
     this->ID = glCreateProgram();
-    glAttachShader(this->ID, sVertex);
-    glAttachShader(this->ID, sFragment);
-    if (geometrySource != nullptr)
-        glAttachShader(this->ID, gShader);
+    glAttachShader(this->ID, stages.vertex);
+    glAttachShader(this->ID, stages.fragment);
+    if (stages.geometry != 0)
+        glAttachShader(this->ID, stages.geometry);
 
     glLinkProgram(this->ID);
-    checkCompileErrors(this->ID, "PROGRAM");
+    return stages;
+}
+
+bool Shader::finish(const ShaderStages &stages) {
+    // Asking for a status waits for the driver to finish that compile or link
+    bool success = checkCompileErrors(stages.vertex, "VERTEX");
+    success = checkCompileErrors(stages.fragment, "FRAGMENT") && success;
+    if (stages.geometry != 0)
+        success = checkCompileErrors(stages.geometry, "GEOMETRY") && success;
+    success = checkCompileErrors(this->ID, "PROGRAM") && success;
 
     // delete the shaders as they're linked into our program now and no longer necessary
-    glDeleteShader(sVertex);
-    glDeleteShader(sFragment);
-    if (geometrySource != nullptr)
-        glDeleteShader(gShader);
+    glDeleteShader(stages.vertex);
+    glDeleteShader(stages.fragment);
+    if (stages.geometry != 0)
+        glDeleteShader(stages.geometry);
+    return success;
 }
 
 void Shader::setFloat(const char *name, float value) const {
@@ -82,8 +94,24 @@ void Shader::setMatrix4(const char *name, const glm::mat4 &matrix) const {
     glUniformMatrix4fv(glGetUniformLocation(this->ID, name), 1, false, glm::value_ptr(matrix));
 }
 
+int Shader::getUniformLocation(const char *name) const {
+    return glGetUniformLocation(this->ID, name);
+}
+
+void Shader::setFloat(int location, float value) const {
+    glUniform1f(location, value);
+}
+
+void Shader::setVector2f(int location, const glm::vec2 &value) const {
+    glUniform2f(location, value.x, value.y);
+}
+
+void Shader::setVector4f(int location, const glm::vec4 &value) const {
+    glUniform4f(location, value.x, value.y, value.z, value.w);
+}
+
 
-void Shader::checkCompileErrors(unsigned int object, string type) {
+bool Shader::checkCompileErrors(unsigned int object, string type) {
     int success;
     char infoLog[1024];
 
@@ -91,9 +119,7 @@ void Shader::checkCompileErrors(unsigned int object, string type) {
         glGetShaderiv(object, GL_COMPILE_STATUS, &success);
         if (!success) {
             glGetShaderInfoLog(object, 1024, NULL, infoLog);
-            cout << "| ERROR::SHADER: Compile-time error: Type: " << type << "\n"
-                      << infoLog << "\n -- --------------------------------------------------- -- "
-                      << endl;
+            LOG_ERROR("Shader compile error ({}):\n{}", type, infoLog);
         }
     }
 
@@ -101,9 +127,8 @@ void Shader::checkCompileErrors(unsigned int object, string type) {
         glGetProgramiv(object, GL_LINK_STATUS, &success);
         if (!success) {
             glGetProgramInfoLog(object, 1024, NULL, infoLog);
-            cout << "| ERROR::Shader: Link-time error: Type: " << type << "\n"
-                      << infoLog << "\n -- --------------------------------------------------- -- "
-                      << endl;
+            LOG_ERROR("Shader link error ({}):\n{}", type, infoLog);
         }
     }
+    return success != 0;
 }
\ No newline at end of file
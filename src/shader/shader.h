@@ -7,12 +7,20 @@
 #include <iostream>
 using std::string, std::ifstream, std::stringstream, std::cout, std::endl;
 
+/// @brief The stage objects of a program that was submitted but not finished (see Shader::submit()).
+struct ShaderStages {
+    unsigned int vertex = 0;
+    unsigned int fragment = 0;
+    /// @brief 0 if there is no geometry shader
+    unsigned int geometry = 0;
+};
+
 /// @brief General purpose shader object.
 /// @details Compiles from file, generates compile/link-time error messages and hosts several utility functions for easy management.
 class Shader {
     public:
         /// @brief The shader program ID
-        unsigned int ID;
+        unsigned int ID = 0;
 
         /// @brief Construct a new Shader object
         Shader() { }
@@ -27,7 +35,18 @@ class Shader {
         /// @param vertexSource the source code for the vertex shader
         /// @param fragmentSource the source code for the fragment shader
         /// @param geometrySource the source code for the geometry shader (optional)
-        void compile(const char *vertexSource, const char *fragmentSource, const char *geometrySource = nullptr); // note: geometry source code is optional
+        /// @return false if a stage failed to compile or the program failed to link (the errors are logged)
+        bool compile(const char *vertexSource, const char *fragmentSource, const char *geometrySource = nullptr); // note: geometry source code is optional
+
+        /// @brief Starts compiling and linking without waiting for the driver
+        /// @details The ID is valid right away (using the program before finish() waits for the link), but errors
+        /// aren't checked until finish(), so several programs can compile at once.
+        /// @return The stage objects to pass to finish()
+        ShaderStages submit(const char *vertexSource, const char *fragmentSource, const char *geometrySource = nullptr);
+
+        /// @brief Waits for a submit() to finish, logs any errors and deletes the stage objects
+        /// @return false if a stage failed to compile or the program failed to link
+        bool finish(const ShaderStages &stages);
 
         // ------------------------------------------------------------------------
         // utility functions
@@ -87,11 +106,23 @@ class Shader {
         /// @param useShader boolean to indicate whether to use this shader
         void setMatrix4(const char *name, const glm::mat4 &matrix) const;
 
+        /// @brief Returns the location of a uniform (-1 if the program doesn't have it)
+        /// @details Look it up once and set it with the overloads below, for uniforms set many times per frame.
+        int getUniformLocation(const char *name) const;
+
+        /// @brief set a uniform float at a location from getUniformLocation() (the shader has to be in use)
+        void setFloat(int location, float value) const;
+        /// @brief set a uniform vector of two floats at a location from getUniformLocation()
+        void setVector2f(int location, const glm::vec2 &value) const;
+        /// @brief set a uniform vector of four floats at a location from getUniformLocation()
+        void setVector4f(int location, const glm::vec4 &value) const;
+
     private:
         /// @brief Checks if compilation or linking failed and if so, print the error logs
         /// @param object the shader object to check
         /// @param type the type of shader object (vertex, fragment, geometry)
-        void checkCompileErrors(unsigned int object, std::string type);
+        /// @return true if there were no errors
+        bool checkCompileErrors(unsigned int object, std::string type);
 };
 
 #endif
@@ -1,63 +1,280 @@
 #include "shaderManager.h"
+#include "../framework/log.h"
+#include "../framework/profiler.h"
+#include <cstring>
 #include <fstream>
 #include <sstream>
+#include <thread>
 
+// Same value in the KHR and ARB extensions (not every glad build loads them)
+#ifndef GL_COMPLETION_STATUS_KHR
+#define GL_COMPLETION_STATUS_KHR 0x91B1
+#endif
+
+const char *const SHADER_FEATURE_NAMES[SHADER_FEATURE_COUNT] = {"MODEL_MATRIX", "TEXTURED", "GLYPH"};
+
+namespace {
+/// @brief Trace rows for compiles start here (well above the thread ids)
+const uint32_t COMPILE_TRACK = 1000;
+
+/// @brief "0 = circle.frag, 1 = include/sdf.glsl" (the source string numbers in compile errors)
+std::string describeSources(const std::vector<std::string> &sourceFiles) {
+    std::string description;
+    for (size_t i = 0; i < sourceFiles.size(); ++i) {
+        description += (i > 0 ? ", " : "") + std::to_string(i) + " = " + sourceFiles[i];
+    }
+    return description;
+}
+}
 
 ShaderManager::~ShaderManager() {
     clear();
 }
 
+void ShaderManager::addProgram(const std::string &name, const char *vShaderFile, const char *fShaderFile,
+                               const char *gShaderFile) {
+    programs[name] = ProgramFiles{vShaderFile, fShaderFile, gShaderFile != nullptr ? gShaderFile : ""};
+    // Variants of a program that was registered before under this name are built again
+    auto variant = variants.lower_bound({name, 0});
+    while (variant != variants.end() && variant->first.first == name) {
+        variant = variants.erase(variant);
+    }
+}
+
+Shader &ShaderManager::getVariant(const std::string &name, uint32_t features) {
+    auto found = variants.find({name, features});
+    if (found != variants.end()) {
+        return found->second;
+    }
+    PROFILE_SCOPE("compileVariant");
+    Shader &variant = variants[{name, features}];
+    auto program = programs.find(name);
+    if (program == programs.end()) {
+        LOG_ERROR("Shader {} was never added", name);
+        return variant;
+    }
+    const ProgramFiles &programFiles = program->second;
+    const bool hasGeometry = !programFiles.geometry.empty();
+
+    // 1. build each stage's source (includes and feature defines)
+    std::string vertexCode, fragmentCode, geometryCode;
+    std::vector<std::string> vertexFiles, fragmentFiles, geometryFiles;
+    if (!buildSource(programFiles.vertex, features, vertexCode, vertexFiles) ||
+        !buildSource(programFiles.fragment, features, fragmentCode, fragmentFiles) ||
+        (hasGeometry && !buildSource(programFiles.geometry, features, geometryCode, geometryFiles))) {
+        return variant;
+    }
+
+    // 2. variants with the same final sources share a program
+    std::string key = vertexCode + '\0' + fragmentCode + '\0' + geometryCode;
+    auto existing = compiled.find(key);
+    if (existing != compiled.end()) {
+        LOG_DEBUG("Shader {} variant {} is the same program as an earlier variant", name, features);
+        variant = existing->second;
+        return variant;
+    }
+
+    // 3. start compiling it (checked later, see finishCompiles())
+    PendingCompile compile;
+    compile.label = name + "/" + std::to_string(features);
+    compile.submitted = std::chrono::steady_clock::now();
+    compile.stages = compile.shader.submit(vertexCode.c_str(), fragmentCode.c_str(),
+                                           hasGeometry ? geometryCode.c_str() : nullptr);
+    compile.vertexFiles = std::move(vertexFiles);
+    compile.fragmentFiles = std::move(fragmentFiles);
+    compiled.emplace(std::move(key), compile.shader);
+    variant = compile.shader;
+    pending.push_back(std::move(compile));
+    return variant;
+}
+
+bool ShaderManager::enableParallelCompile(void (APIENTRY *maxCompilerThreads)(GLuint count)) {
+    GLint extensionCount = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &extensionCount);
+    bool supported = false;
+    for (GLint i = 0; i < extensionCount && !supported; ++i) {
+        const char *extension = reinterpret_cast<const char *>(glGetStringi(GL_EXTENSIONS, i));
+        supported = extension != nullptr && (std::strcmp(extension, "GL_KHR_parallel_shader_compile") == 0 ||
+                                             std::strcmp(extension, "GL_ARB_parallel_shader_compile") == 0);
+    }
+    parallelCompile = supported && maxCompilerThreads != nullptr;
+    if (parallelCompile) {
+        // As many threads as the driver wants
+        maxCompilerThreads(0xFFFFFFFF);
+    }
+    LOG_DEBUG("Parallel shader compile {}", parallelCompile ? "on" : "not supported");
+    return parallelCompile;
+}
+
+void ShaderManager::pollCompiles() {
+    if (!parallelCompile) {
+        return;
+    }
+    for (size_t i = 0; i < pending.size();) {
+        GLint done = GL_FALSE;
+        glGetProgramiv(pending[i].shader.ID, GL_COMPLETION_STATUS_KHR, &done);
+        if (done) {
+            finishPending(i);
+        }
+        else {
+            ++i;
+        }
+    }
+}
+
+void ShaderManager::finishCompiles() {
+    if (pending.empty()) {
+        return;
+    }
+    PROFILE_SCOPE("finishCompiles");
+    auto start = std::chrono::steady_clock::now();
+    const size_t count = pending.size();
+    if (parallelCompile) {
+        // Finish them in the order the driver gets them done (so each one's time is right)
+        pollCompiles();
+        while (!pending.empty()) {
+            std::this_thread::yield();
+            pollCompiles();
+        }
+    }
+    else {
+        // The first status check of each one waits for it
+        while (!pending.empty()) {
+            finishPending(0);
+        }
+    }
+    double waited = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    LOG_INFO("Compiled {} shader programs ({} ms waiting for the driver)", static_cast<int>(count), waited);
+}
+
+void ShaderManager::finishPending(size_t index) {
+    PendingCompile &compile = pending[index];
+    if (!compile.shader.finish(compile.stages)) {
+        LOG_ERROR("Shader {} failed (vertex sources {}; fragment sources {})", compile.label,
+                  describeSources(compile.vertexFiles), describeSources(compile.fragmentFiles));
+    }
+    auto finished = std::chrono::steady_clock::now();
+    LOG_DEBUG("Shader {} compiled and linked {} ms after it was submitted", compile.label,
+              std::chrono::duration<double, std::milli>(finished - compile.submitted).count());
+    PROFILE_EVENT("shader " + compile.label, compile.submitted, finished, COMPILE_TRACK + compileCount);
+    compileCount++;
+    pending.erase(pending.begin() + index);
+}
+
 Shader ShaderManager::loadShader(const char *vShaderFile, const char *fShaderFile, const char *gShaderFile, std::string name) {
-    return shaders[name] = loadShaderFromFile(vShaderFile, fShaderFile, gShaderFile);
+    PROFILE_SCOPE("loadShader");
+    addProgram(name, vShaderFile, fShaderFile, gShaderFile);
+    Shader shader = getVariant(name);
+    // Loading a single shader waits for it (like it always has)
+    finishCompiles();
+    return shader;
 }
 
 Shader &ShaderManager::getShader(std::string name) {
-    return shaders[name];
+    return getVariant(name);
 }
 
 void ShaderManager::clear() {
-    // delete all shaders: "iter" here is const std::pair<std::string, Shader>&, so we need to use
-    // "iter.second" to get the Shader, and delete the program by ID
-    for (const auto &iter: shaders)
+    for (const PendingCompile &compile : pending) {
+        glDeleteShader(compile.stages.vertex);
+        glDeleteShader(compile.stages.fragment);
+        if (compile.stages.geometry != 0)
+            glDeleteShader(compile.stages.geometry);
+    }
+    pending.clear();
+    // Variants can share a program, so the programs are deleted from the compiled map (once each)
+    for (const auto &iter: compiled)
         glDeleteProgram(iter.second.ID);
+    compiled.clear();
+    variants.clear();
 }
 
-Shader ShaderManager::loadShaderFromFile(const char *vShaderFile, const char *fShaderFile, const char *gShaderFile) {
-    // 1. retrieve the vertex/fragment source code from filePath
-    std::string vertexCode;
-    std::string fragmentCode;
-    std::string geometryCode;
-    try {
-        // open files
-        std::ifstream vertexShaderFile(vShaderFile);
-        std::ifstream fragmentShaderFile(fShaderFile);
-        std::stringstream vShaderStream, fShaderStream;
-        // read file's buffer contents into streams
-        vShaderStream << vertexShaderFile.rdbuf();
-        fShaderStream << fragmentShaderFile.rdbuf();
-        // close file handlers
-        vertexShaderFile.close();
-        fragmentShaderFile.close();
-        // convert stream into string
-        vertexCode = vShaderStream.str();
-        fragmentCode = fShaderStream.str();
-        // if geometry shader path is present, also load a geometry shader
-        if (gShaderFile != nullptr) {
-            std::ifstream geometryShaderFile(gShaderFile);
-            std::stringstream gShaderStream;
-            gShaderStream << geometryShaderFile.rdbuf();
-            geometryShaderFile.close();
-            geometryCode = gShaderStream.str();
-        }
-    }
-    catch (std::exception &e) {
-        std::cout << "ERROR::SHADER: Failed to read shader files" << std::endl;
-    }
-    const char *vShaderCode = vertexCode.c_str();
-    const char *fShaderCode = fragmentCode.c_str();
-    const char *gShaderCode = geometryCode.c_str();
-    // 2. now create shader object from source code
-    Shader shader;
-    shader.compile(vShaderCode, fShaderCode, gShaderFile != nullptr ? gShaderCode : nullptr);
-    return shader;
-}
\ No newline at end of file
+const std::string *ShaderManager::readFile(const std::string &path) {
+    auto found = files.find(path);
+    if (found != files.end()) {
+        return &found->second;
+    }
+    std::ifstream file(path);
+    if (!file) {
+        LOG_ERROR("Failed to read shader file {}", path);
+        return nullptr;
+    }
+    std::stringstream stream;
+    stream << file.rdbuf();
+    return &(files[path] = stream.str());
+}
+
+bool ShaderManager::buildSource(const std::string &path, uint32_t features, std::string &source,
+                                std::vector<std::string> &sourceFiles) {
+    std::string version;
+    std::string body;
+    if (!expandIncludes(path, body, sourceFiles, &version)) {
+        return false;
+    }
+    // #version has to come first, then the defines (only the ones the source uses, so features that don't change
+    // the source don't make a different program)
+    source = version;
+    for (int bit = 0; bit < SHADER_FEATURE_COUNT; ++bit) {
+        if ((features & (1u << bit)) && body.find(SHADER_FEATURE_NAMES[bit]) != std::string::npos) {
+            source += std::string("#define ") + SHADER_FEATURE_NAMES[bit] + " 1\n";
+        }
+    }
+    source += body;
+    return true;
+}
+
+bool ShaderManager::expandIncludes(const std::string &path, std::string &source,
+                                   std::vector<std::string> &sourceFiles, std::string *version) {
+    const std::string *text = readFile(path);
+    if (text == nullptr) {
+        return false;
+    }
+    const int sourceNumber = static_cast<int>(sourceFiles.size());
+    sourceFiles.push_back(path);
+    const std::string directory = path.substr(0, path.find_last_of("/\\") + 1);
+
+    // GLSL 3.30's "#line n s" numbers the next line n + 1, so compile errors point at the right file and line
+    source += "#line 0 " + std::to_string(sourceNumber) + "\n";
+    std::istringstream lines(*text);
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(lines, line)) {
+        lineNumber++;
+        size_t start = line.find_first_not_of(" \t");
+        if (start == std::string::npos) {
+            source += "\n";
+            continue;
+        }
+        if (version != nullptr && version->empty() && line.compare(start, 8, "#version") == 0) {
+            *version = line + "\n";
+            source += "#line " + std::to_string(lineNumber) + " " + std::to_string(sourceNumber) + "\n";
+            continue;
+        }
+        if (line.compare(start, 8, "#include") != 0) {
+            source += line + "\n";
+            continue;
+        }
+
+        size_t open = line.find('"', start);
+        size_t close = open == std::string::npos ? std::string::npos : line.find('"', open + 1);
+        if (close == std::string::npos) {
+            LOG_ERROR("Bad #include in {} line {}: {}", path, lineNumber, line);
+            return false;
+        }
+        const std::string included = directory + line.substr(open + 1, close - open - 1);
+        bool alreadyIncluded = false;
+        for (const std::string &file : sourceFiles) {
+            alreadyIncluded = alreadyIncluded || file == included;
+        }
+        if (alreadyIncluded) {
+            source += "\n";
+            continue;
+        }
+        if (!expandIncludes(included, source, sourceFiles, nullptr)) {
+            LOG_ERROR("Included from {} line {}", path, lineNumber);
+            return false;
+        }
+        source += "#line " + std::to_string(lineNumber) + " " + std::to_string(sourceNumber) + "\n";
+    }
+    return true;
+}
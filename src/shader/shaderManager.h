@@ -3,44 +3,147 @@
 
 #include "shader.h"
 
+#include <chrono>
+#include <cstdint>
 #include <map>
 #include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
 
+/// @brief Optional parts of a shader source, one bit each (a variant is a program plus a set of features).
+/// @details A variant's source gets "#define <name> 1" (the names are in SHADER_FEATURE_NAMES) for each feature it
+/// has, if the source mentions the name at all.
+enum ShaderFeature : uint32_t {
+    /// @brief Vertices are moved and scaled by a model matrix
+    SHADER_MODEL_MATRIX = 1 << 0,
+    /// @brief Vertices carry texture coordinates and the color is multiplied by a texture
+    SHADER_TEXTURED     = 1 << 1,
+    /// @brief The texture is a single channel coverage mask (font glyphs)
+    SHADER_GLYPH        = 1 << 2,
+};
+const int SHADER_FEATURE_COUNT = 3;
+/// @brief The #define each ShaderFeature bit turns into (bit i is SHADER_FEATURE_NAMES[i])
+extern const char *const SHADER_FEATURE_NAMES[SHADER_FEATURE_COUNT];
+
+/**
+ * @brief Loads shader sources and compiles their variants.
+ * @details Sources may "#include "file"" other files (relative to the including file, each file at most once per
+ * stage). A program is registered once by name and each variant (a ShaderFeature bitmask) is compiled the first time
+ * it's asked for. Variants whose final sources are identical (e.g. they only differ by a feature the source never
+ * mentions), or two programs with the same files, share one compiled program. Only use from the OpenGL thread.
+ *
+ * Compiles are only submitted when a variant is asked for: their errors are checked by pollCompiles() or
+ * finishCompiles(), so the driver can work on every program at once while the game loads its other assets.
+ */
 class ShaderManager {
 public:
     /// @brief Default constructor
     ShaderManager() = default;
     /// @brief Default destructor
-    /// @details Clears the shaders map
+    /// @details Deletes every compiled program
     ~ShaderManager();
 
+    ShaderManager(const ShaderManager &) = delete;
+    ShaderManager &operator=(const ShaderManager &) = delete;
 
-    /// @brief Calls loadShaderFromFile() and stores the shader in the shaders map
+    /// @brief Registers a program's source files under a name (nothing is read or compiled until a variant is used)
+    /// @param name Name the variants are looked up with
     /// @param vShaderFile The vertex shader file
     /// @param fShaderFile The fragment shader file
     /// @param gShaderFile The geometry shader file (optional)
-    /// @param name Name used for the shader in the shaders map
+    void addProgram(const std::string &name, const char *vShaderFile, const char *fShaderFile,
+                    const char *gShaderFile = nullptr);
+
+    /// @brief Lets the driver compile on its own threads (GL_KHR_parallel_shader_compile), if it supports it
+    /// @details Without it, submitted compiles still overlap with the CPU work done before finishCompiles(), but
+    /// there is no way to tell if one is done without waiting for it.
+    /// @param maxCompilerThreads glMaxShaderCompilerThreadsKHR (or ARB), looked up by the caller, or nullptr
+    /// @return true if the driver compiles in parallel
+    bool enableParallelCompile(void (APIENTRY *maxCompilerThreads)(GLuint count));
+
+    /// @brief Returns the program's variant with the given features, compiling it on first use
+    /// @details The compile is only submitted: the shader can be used right away (the driver waits for it), but its
+    /// errors aren't logged until pollCompiles() or finishCompiles().
+    /// @param name Name given to addProgram()
+    /// @param features ShaderFeature bits
+    /// @return The variant (an empty Shader with ID 0 if the program was never added)
+    Shader &getVariant(const std::string &name, uint32_t features = 0);
+
+    /// @brief Registers the program and returns its variant without any features (waits for the compile)
+    /// @param vShaderFile The vertex shader file
+    /// @param fShaderFile The fragment shader file
+    /// @param gShaderFile The geometry shader file (optional)
+    /// @param name Name used for the shader
     /// @return The shader that was loaded
     Shader loadShader(const char *vShaderFile, const char *fShaderFile, const char *gShaderFile, std::string name);
 
-    /// @brief Returns a reference to the shader with the given name in the shaders map
+    /// @brief Returns the variant without any features of the program with the given name
     /// @param name The name of the shader
     /// @return The shader with the given name
     Shader& getShader(std::string name);
 
-    /// @brief Clears the shaders map
+    /// @brief Checks the compiles the driver has already finished, without waiting (needs parallel compile)
+    /// @details Call between loading steps, so errors show up as soon as possible and finishCompiles() has less to do.
+    void pollCompiles();
+
+    /// @brief Waits for every submitted compile, logs their errors and how long each one took
+    /// @details Each program's time (from submit to finished) is also recorded in the profiler (startup trace).
+    void finishCompiles();
+
+    /// @brief Number of OpenGL programs compiled so far (variants that turned out identical count once)
+    size_t getCompiledCount() const { return compiled.size(); }
+
+    /// @brief Deletes every compiled program and forgets the variants (the programs stay registered)
     void clear();
 
 private:
-    /// @brief A map of shaders, with the key being the name of the shader
-    std::map<std::string, Shader> shaders;
+    /// @brief The files a registered program is built from
+    struct ProgramFiles {
+        std::string vertex;
+        std::string fragment;
+        /// @brief Empty if the program has no geometry shader
+        std::string geometry;
+    };
+    std::map<std::string, ProgramFiles> programs;
+    /// @brief Variants handed out so far, by program name and features
+    std::map<std::pair<std::string, uint32_t>, Shader> variants;
+    /// @brief Compiled programs by their final sources (vertex, fragment and geometry, separated by '\0')
+    std::map<std::string, Shader> compiled;
+    /// @brief Files read so far (a file included by several shaders is only read once)
+    std::map<std::string, std::string> files;
 
-    /// @brief Loads and compiles a shader from a file
-    /// @details This function is private because we only want to load shaders from within this class
-    /// @param vShaderFile The vertex shader file
-    /// @param fShaderFile The fragment shader file
-    /// @param gShaderFile The geometry shader file (optional)
-    /// @return The shader that was loaded
-    Shader loadShaderFromFile(const char *vShaderFile, const char *fShaderFile, const char *gShaderFile=nullptr);};
+    /// @brief A variant whose compile was submitted but not checked
+    struct PendingCompile {
+        Shader shader;
+        ShaderStages stages;
+        /// @brief Program name and features ("quad/6"), for the log and the profiler
+        std::string label;
+        std::chrono::steady_clock::time_point submitted;
+        /// @brief Source string numbers of each stage (to explain errors)
+        std::vector<std::string> vertexFiles, fragmentFiles;
+    };
+    std::vector<PendingCompile> pending;
+    bool parallelCompile = false;
+    /// @brief Programs compiled since the manager was created (each one gets its own row in traces)
+    uint32_t compileCount = 0;
+
+    /// @brief Checks pending[index] (waiting if the driver isn't done), logs it and removes it
+    void finishPending(size_t index);
+
+    /// @brief Returns the file's contents (cached), or nullptr if it couldn't be read
+    const std::string *readFile(const std::string &path);
+
+    /// @brief Builds the final source of one stage: includes expanded and the features defined after #version
+    /// @param sourceFiles Receives the files in the order their source string numbers were given (see #line)
+    /// @return false if a file couldn't be read
+    bool buildSource(const std::string &path, uint32_t features, std::string &source,
+                     std::vector<std::string> &sourceFiles);
+
+    /// @brief Appends the file with its includes expanded (files already in sourceFiles are skipped)
+    /// @param version If not null, receives the file's #version line (which has to stay first in the final source)
+    bool expandIncludes(const std::string &path, std::string &source, std::vector<std::string> &sourceFiles,
+                        std::string *version);
+};
 
-#endif //GRAPHICS_SHADERMANAGER_H
\ No newline at end of file
+#endif //GRAPHICS_SHADERMANAGER_H
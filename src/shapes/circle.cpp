@@ -1,5 +1,7 @@
 #include "circle.h"
 #include "rect.h"
+#include "collision.h"
+#include "../game/physics.h"
 
 
 Circle::~Circle() {
@@ -8,26 +10,59 @@ Circle::~Circle() {
 }
 
 void Circle::setUniforms() const {
-    Shape::setUniforms(); // Sets model and shapeColor uniforms
-    shader.setFloat("radius", radius);
-    shader.setVector2f("center", pos.x, pos.y);
+    setStyleUniforms();
+    setInstanceUniforms();
+}
+
+void Circle::setStyleUniforms() const {
+    const UniformLocations &uniforms = getLocations();
+    // The glow and the anti-aliased edge have to fit on the quad
+    shader.setFloat(uniforms.padding, style.getPadding());
+    shader.setFloat(uniforms.outlineWidth, style.outlineWidth);
+    shader.setVector4f(uniforms.outlineColor, style.outlineColor);
+    shader.setFloat(uniforms.glowWidth, style.glowWidth);
+    shader.setFloat(uniforms.glowStrength, style.glowStrength);
+}
+
+void Circle::setInstanceUniforms() const {
+    const UniformLocations &uniforms = getLocations();
+    // circle.vert places the quad from the center and radius (no model matrix)
+    shader.setVector4f(uniforms.shapeColor, color.vec);
+    shader.setFloat(uniforms.radius, radius);
+    shader.setVector2f(uniforms.center, pos);
+}
+
+const Circle::UniformLocations &Circle::getLocations() const {
+    if (locations.program != shader.ID) {
+        locations.program = shader.ID;
+        locations.shapeColor = shader.getUniformLocation("shapeColor");
+        locations.radius = shader.getUniformLocation("radius");
+        locations.center = shader.getUniformLocation("center");
+        locations.padding = shader.getUniformLocation("padding");
+        locations.outlineWidth = shader.getUniformLocation("outlineWidth");
+        locations.outlineColor = shader.getUniformLocation("outlineColor");
+        locations.glowWidth = shader.getUniformLocation("glowWidth");
+        locations.glowStrength = shader.getUniformLocation("glowStrength");
+    }
+    return locations;
 }
 
 void Circle::draw() const {
     glBindVertexArray(VAO);
-    glDrawArrays(GL_TRIANGLE_FAN, 0, segments + 2); // +2 for center and last vertex
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
     glBindVertexArray(0);
 }
 
-void Circle::initVectors() {
-    // Center of circle
-    vertices.push_back(0.0f);
-    vertices.push_back(0.0f);
-    for (int i = 0; i <= segments; ++i) {
-        float theta = 2.0f * 3.1415926f * float(i) / float(segments);
-        vertices.push_back(radius * cosf(theta)); // x = r*cos(theta)
-        vertices.push_back(radius * sinf(theta)); // y = r*sin(theta)
-    }
+const vector<float> &Circle::getVertices() {
+    // Unit quad (as wide as the circle's diameter, as a triangle strip), circle.vert scales it up to the circle.
+    // This keeps the vertices independent of the radius so the buffers can be reused when the radius changes.
+    static const vector<float> vertices = {
+        -0.5f, -0.5f,
+        0.5f, -0.5f,
+        -0.5f, 0.5f,
+        0.5f, 0.5f,
+    };
+    return vertices;
 }
 
 void Circle::setRadius(float radius) {
@@ -35,71 +70,24 @@ void Circle::setRadius(float radius) {
     size = vec2(radius * 2, radius * 2);
 }
 
-float Circle::getRadius() const { return radius; }
-
 float Circle::getLeft() const   { return pos.x - radius; }
 float Circle::getRight() const  { return pos.x + radius; }
 float Circle::getTop() const    { return pos.y + radius; }
 float Circle::getBottom() const { return pos.y - radius; }
 
 bool Circle::isOverlapping(const Circle &c) const {
-    // Check if the distance between the centers of the circles is less than the sum of their radii
-    // distance = sqrt((x2 - x1)^2 + (y2 - y1)^2)
-    float dist = distance(pos, c.getPos());
-    float radiusSum = radius + c.getRadius();
-    return dist < radiusSum;
+    return overlaps(*this, c);
 }
 
-//Checks if Circle overlaps Shape (Rectangle)
-bool Circle::isOverlapping(const Shape &r) const{
-    if(const Rect* rect = dynamic_cast<const Rect*>(&r)) {
-        return rect->isOverlapping(*this);
-    }
-    return false;
-}
-
-// Logic for checking if Rectangle and Circle are overlapping (Based on Circles center point distance to the rectangles edge)
 // Circle is overlapping if the distance from its center to the rectangles closest edge is less than the circles radius
 bool Circle::isOverlapping(const Rect &r) const {
-    float closeX = glm::clamp(pos.x, r.getLeft(), r.getRight());   // Getting rectangles length and comparing it with the circles center X value using clamp
-    float closeY = glm::clamp(pos.y, r.getBottom(), r.getTop()); // Getting rectangles height and comparing it with the circles center Y value using clamp
-
-    // Getting the distance from the circles center to the rectangles edges
-    float distX = pos.x - closeX;
-    float distY = pos.y - closeY;
-
-    float distance = sqrt(distX * distX + distY * distY);
-
-    return distance < radius;
+    return overlaps(*this, r);
 }
 
 
 void Circle::bounce(Circle &other) {
-    glm::vec2 delta = other.getPos() - this->getPos();
-    float distance = glm::length(delta);
-    float overlap = 0.5f * (this->getRadius() + other.getRadius() - distance);
-
-    // Check if circles are overlapping
-    if (overlap > 0) {
-        // Adjust positions based on radius (as a proxy for mass)
-        float thisMass = this->getRadius() * this->getRadius() * M_PI;
-        float otherMass = other.getRadius() * other.getRadius() * M_PI;
-        float totalMass = thisMass + otherMass;
-
-        this->setPos(this->getPos() - overlap * (thisMass / totalMass) * delta / distance);
-        other.setPos(other.getPos() + overlap * (otherMass / totalMass) * delta / distance);
-
-        // Velocity calculations for elastic collision
-        glm::vec2 thisVelocity = this->getVelocity();
-        glm::vec2 otherVelocity = other.getVelocity();
-        glm::vec2 velocityDifference = thisVelocity - otherVelocity;
-
-        float dotProduct = glm::dot(velocityDifference, delta) / (distance * distance);
-        glm::vec2 collisionNormal = dotProduct * delta;
-
-        this->setVelocity(thisVelocity - (2 * otherMass / totalMass) * collisionNormal);
-        other.setVelocity(otherVelocity + (2 * thisMass / totalMass) * collisionNormal);
-    }
+    // Shape::velocity (set through setVelocity) is the velocity the engine moves bubbles with
+    bounceCircles(pos, Shape::velocity, radius, other.pos, other.Shape::velocity, other.radius);
 }
 
 void Circle::setColor(struct color c)    { color = c; }
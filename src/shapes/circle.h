@@ -7,27 +7,47 @@ class Rect; //Added this because it kept saying 'Rect' does not name a type even
 #include "../shader/shader.h"
 using std::vector, glm::vec2, glm::vec3, glm::normalize, glm::dot;
 
+/// @brief How a circle's edge is drawn (see circle.frag).
+struct CircleStyle {
+    /// @brief Width of the outline just inside the edge in pixels (0 for none), and its color
+    float outlineWidth = 0;
+    vec4 outlineColor = vec4(0, 0, 0, 1);
+    /// @brief Width of the glow outside the edge in pixels (0 for none), and its opacity next to the edge
+    /// @details The glow is the circle's own color, fading out.
+    float glowWidth = 0;
+    float glowStrength = 0.5f;
+
+    /// @brief How far past the radius the circle is drawn: the glow and a couple of pixels for the anti-aliased edge
+    float getPadding() const { return glowWidth + 2; }
+};
 
-class Circle : public Shape {
+class Circle final : public Shape {
 private:
 
-    /// @brief Number of x,y points to draw the circle
-    const static int segments = 100;
-
     /// @brief Radius of the circle (half of screen width
     float radius;
     /// @brief The x and y velocities of the circle
     vec2 velocity;
+    CircleStyle style;
+
+    /// @brief Uniform locations of circle.vert/frag, looked up again when the shader's program changes
+    struct UniformLocations {
+        unsigned int program = 0;
+        // -1 (ignored by glUniform) until the program is known
+        int shapeColor = -1, radius = -1, center = -1, padding = -1;
+        int outlineWidth = -1, outlineColor = -1, glowWidth = -1, glowStrength = -1;
+    };
+    mutable UniformLocations locations;
+    const UniformLocations &getLocations() const;
 
 public:
     /// @brief Construct a new Circle object
     /// @details This is the main constructor for the Circle class.
     /// @details All other constructors call this constructor.
     Circle(Shader &shader, vec2 pos, vec2 size, vec2 velocity, vec4 color)
-        : Shape(shader, pos, size, color), radius(size.x / 2.0f), velocity(velocity) {
-        initVectors();
+        : Shape(ShapeType::circle, shader, pos, size, color), radius(size.x / 2.0f), velocity(velocity) {
         initVAO();
-        initVBO();
+        initVBO(getVertices());
     }
 
     Circle(Shader & shader, vec2 pos, vec2 size, struct color color)
@@ -43,18 +63,27 @@ public:
     // override setUniforms to set the radius uniform
     void setUniforms() const override;
 
+    /// @brief Sets the uniforms of the circle's style (the same for a whole layer of circles)
+    void setStyleUniforms() const;
+    /// @brief Sets the uniforms of this circle (color, radius and center), after setStyleUniforms()
+    void setInstanceUniforms() const;
+
     /// @brief Destroy the Circle object
     /// @details destroys the VAO and VBO associated with the circle
     ~Circle() override;
 
     /// @brief Draws the circle
+    /// @details The circle is a quad (4 vertices), the fragment shader works out the edge from its distance to it.
     void draw() const override;
 
-    /// @brief Computes the border of the circle, and stores the vertices in the circleVertices array.
-    void initVectors();
+    /// @brief Returns the vertices of the unit quad every circle is drawn on.
+    static const vector<float> &getVertices();
+
+    const CircleStyle &getStyle() const { return style; }
+    void setStyle(const CircleStyle &style) { this->style = style; }
 
     /// @brief Returns the radius of the circle
-    float getRadius() const;
+    float getRadius() const { return radius; }
 
     /// @brief Sets the radius of the circle
     void setRadius(float radius);
@@ -72,10 +101,10 @@ public:
     // Collision Functions
 
     /// @brief Checks if two circles are overlapping
-    /// @details This function is called in Engine's update function to check if any two circles are overlapping.
+    /// @details Same as overlaps(*this, c) from collision.h.
     bool isOverlapping(const Circle &c) const;
-    bool isOverlapping(const Shape &r) const override;
     bool isOverlapping(const Rect& rect) const;
+    using Shape::isOverlapping;
 
     /// @brief Handles the collision between two circles
     /// @details This function is called when two circles are overlapping (in Engine's update function).
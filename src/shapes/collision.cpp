@@ -0,0 +1,22 @@
+#include "collision.h"
+
+namespace {
+using OverlapTest = bool (*)(const Shape &, const Shape &);
+
+/// @brief Casts both shapes to the types their tags say they are and runs that pair's test
+template <typename A, typename B>
+bool overlapsAs(const Shape &a, const Shape &b) {
+    return Narrowphase<A, B>::overlaps(static_cast<const A &>(a), static_cast<const B &>(b));
+}
+
+// Indexed by [a.getType()][b.getType()], in ShapeType order
+constexpr OverlapTest OVERLAP_TESTS[SHAPE_TYPE_COUNT][SHAPE_TYPE_COUNT] = {
+    {overlapsAs<Circle, Circle>, overlapsAs<Circle, Rect>, overlapsAs<Circle, Triangle>},
+    {overlapsAs<Rect, Circle>, overlapsAs<Rect, Rect>, overlapsAs<Rect, Triangle>},
+    {overlapsAs<Triangle, Circle>, overlapsAs<Triangle, Rect>, overlapsAs<Triangle, Triangle>},
+};
+}
+
+bool overlaps(const Shape &a, const Shape &b) {
+    return OVERLAP_TESTS[static_cast<int>(a.getType())][static_cast<int>(b.getType())](a, b);
+}
@@ -0,0 +1,64 @@
+#ifndef GRAPHICS_COLLISION_H
+#define GRAPHICS_COLLISION_H
+
+#include <type_traits>
+#include "circle.h"
+#include "rect.h"
+#include "triangle.h"
+#include "../game/physics.h"
+
+// Narrow phase collision tests between shapes, one Narrowphase specialization per pair of types.
+//
+// When both types are known at compile time, overlaps(circle, rect) picks the specialization directly and inlines
+// it (no virtual call or cast). overlaps(const Shape &, const Shape &) looks the test up in a table indexed by
+// getType() for code that only has Shape references.
+
+/// @brief Overlap test for shapes of type A and B (pairs without a specialization never overlap).
+template <typename A, typename B>
+struct Narrowphase {
+    static bool overlaps(const A &, const B &) { return false; }
+};
+
+template <>
+struct Narrowphase<Circle, Circle> {
+    static bool overlaps(const Circle &a, const Circle &b) {
+        return circlesOverlap(a.getPos(), a.getRadius(), b.getPos(), b.getRadius());
+    }
+};
+
+template <>
+struct Narrowphase<Circle, Rect> {
+    static bool overlaps(const Circle &circle, const Rect &rect) {
+        vec2 halfSize = rect.getSize() / 2.0f;
+        return circleRectOverlap(circle.getPos(), circle.getRadius(), rect.getPos() - halfSize,
+                                 rect.getPos() + halfSize);
+    }
+};
+
+template <>
+struct Narrowphase<Rect, Circle> {
+    static bool overlaps(const Rect &rect, const Circle &circle) {
+        return Narrowphase<Circle, Rect>::overlaps(circle, rect);
+    }
+};
+
+template <>
+struct Narrowphase<Rect, Rect> {
+    static bool overlaps(const Rect &a, const Rect &b) {
+        vec2 halfA = a.getSize() / 2.0f;
+        vec2 halfB = b.getSize() / 2.0f;
+        return rectsOverlap(a.getPos() - halfA, a.getPos() + halfA, b.getPos() - halfB, b.getPos() + halfB);
+    }
+};
+
+/// @brief Checks if two shapes whose types are known at compile time are overlapping (inlined).
+/// @details A Shape reference on either side goes to the table lookup below instead.
+template <typename A, typename B, typename = std::enable_if_t<!std::is_same_v<A, Shape> && !std::is_same_v<B, Shape>>>
+inline bool overlaps(const A &a, const B &b) {
+    return Narrowphase<A, B>::overlaps(a, b);
+}
+
+/// @brief Checks if two shapes of any type are overlapping (one table lookup and an indirect call).
+bool overlaps(const Shape &a, const Shape &b);
+
+#endif //GRAPHICS_COLLISION_H
@@ -10,10 +10,11 @@ using glm::vec2, glm::vec3;
 
 class Circle;
 
-class Rect : public Shape {
+class Rect final : public Shape {
 private:
-    /// @brief Initializes the vertices and indices of the square
-    void initVectors();
+    /// @brief The vertices and indices of the square (shared by every rect)
+    static const vector<float> vertices;
+    static const vector<unsigned int> indices;
 public:
     /// @brief Construct a new Square object
     /// @details This constructor will call the InitRenderData function.
@@ -42,9 +43,9 @@ public:
     float getTop() const override;
     float getBottom() const override;
 
-    // Checks for shape overlapping
-    bool isOverlapping(const Shape &other) const override;
+    // Checks for shape overlapping (same as overlaps(*this, circle) from collision.h)
     bool isOverlapping(const Circle& circle) const;
+    using Shape::isOverlapping;
 };
 
 
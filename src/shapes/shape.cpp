@@ -1,14 +1,15 @@
 #include "shape.h"
 #include "rect.h"
+#include "collision.h"
 
-Shape::Shape(Shader &shader, glm::vec2 pos, glm::vec2 size, struct color color) :
-    shader(shader), pos(pos), size(size), color(color) {}
+Shape::Shape(ShapeType type, Shader &shader, glm::vec2 pos, glm::vec2 size, struct color color) :
+    type(type), shader(shader), pos(pos), size(size), color(color) {}
 
 Shape::Shape(Shape const& other) :
-    shader(other.shader), pos(other.pos), size(other.size), color(other.color) {}
+    type(other.type), shader(other.shader), pos(other.pos), size(other.size), color(other.color) {}
 
-Shape::Shape(Shader &shader, glm::vec2 pos, vec2 size, vec4 color) :
-    shader(shader), pos(pos), size(size), color(color) {}
+Shape::Shape(ShapeType type, Shader &shader, glm::vec2 pos, vec2 size, vec4 color) :
+    type(type), shader(shader), pos(pos), size(size), color(color) {}
 
 
 // Initialize VAO
@@ -19,7 +20,7 @@ unsigned int Shape::initVAO() {
 }
 
 // Initialize VBO
-void Shape::initVBO() {
+void Shape::initVBO(const vector<float> &vertices) {
     // Generate VBO, bind it to VAO, and copy vertices data into it
     glGenBuffers(1, &VBO);
     glBindBuffer(GL_ARRAY_BUFFER, VBO);
@@ -32,7 +33,7 @@ void Shape::initVBO() {
 }
 
 // Initialize EBO
-void Shape::initEBO() {
+void Shape::initEBO(const vector<unsigned int> &indices) {
     glGenBuffers(1, &EBO);
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
     glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(float), indices.data(), GL_STATIC_DRAW);
@@ -53,6 +54,10 @@ void Shape::setUniforms() const {
 }
 
 // Detect Mouse Overlap
+bool Shape::isOverlapping(const Shape &other) const {
+    return overlaps(*this, other);
+}
+
 bool Shape::isMouseOverlaping(const vec2 &point) const {
     float x = point[0];
     float y = point[1];
@@ -89,10 +94,8 @@ void moveX(float deltaWidth);
 void moveY(float deltaHeight);
 
 // Getters
-vec2 Shape::getPos() const      { return pos; }
 float Shape::getPosX() const    { return pos.x; }
 float Shape::getPosY() const    { return pos.y; }
-vec2 Shape::getSize() const     { return size; }
 vec2 Shape::getVelocity() const { return velocity; }
 void Shape::setVelocity(vec2 v) { this->velocity = v;}
 
@@ -2,22 +2,32 @@
 #define GRAPHICS_SHAPE_H
 
 #include "glm/glm.hpp"
+#include <cstdint>
 #include <vector>
 #include "../shader/shader.h"
 #include "../framework/color.h"
 
 using std::vector, glm::vec2, glm::vec3, glm::vec4, glm::mat4, glm::translate, glm::scale;
 
+/// @brief Concrete type of a Shape (picks the collision test without a dynamic_cast, see collision.h).
+enum class ShapeType : uint8_t {
+    circle,
+    rect,
+    triangle,
+};
+const int SHAPE_TYPE_COUNT = 3;
+
 class Shape {
     public:
         /// @brief Construct a new Shape object
+        /// @param type The concrete type of the shape (set by the derived class)
         /// @param shader The shader to use for rendering
         /// @param pos The position of the shape
         /// @param size The size of the shape
         /// @param color The color of the shape
-        Shape(Shader& shader, vec2 pos, vec2 size, color color);
+        Shape(ShapeType type, Shader& shader, vec2 pos, vec2 size, color color);
 
-        Shape(Shader& shader, vec2 pos, vec2 size, vec4 color);
+        Shape(ShapeType type, Shader& shader, vec2 pos, vec2 size, vec4 color);
 
         /// @brief Copy constructor for Shape
         Shape(Shape const& other);
@@ -35,20 +45,23 @@ class Shape {
 
         /// @brief Initializes the VBO.
         /// @details This function is called in the derived classes' constructor.
-        void initVBO();
+        /// @param vertices The vertices of the shape (shared by every shape of the same type)
+        void initVBO(const vector<float> &vertices);
 
         /// @brief Initializes the EBO.
         /// @details This function is called in the derived classes' constructor.
-        /// @details If function has no indices, pass nullptr for indices and 0 for indexCount.
-        void initEBO();
+        /// @param indices The indices of the shape (shared by every shape of the same type)
+        void initEBO(const vector<unsigned int> &indices);
 
         // --------------------------------------------------------
         // Getters
         // --------------------------------------------------------
+        ShapeType getType() const { return type; }
+
         // Position/Movement Functions
         float getPosX() const;
         float getPosY() const;
-        vec2 getPos() const;
+        vec2 getPos() const { return pos; }
         virtual float getLeft() const = 0;
         virtual float getRight() const = 0;
         virtual float getTop() const = 0;
@@ -63,7 +76,7 @@ class Shape {
         float getOpacity() const;
 
         // Size Functions
-        vec2 getSize() const;
+        vec2 getSize() const { return size; }
 
         // Velocity Functions
         vec2 getVelocity() const;
@@ -120,12 +133,15 @@ class Shape {
         // --------------------------------------------------------
         // Collision functions
         // --------------------------------------------------------
-        //Shape overlapping
-        virtual bool isOverlapping(Shape const& other) const = 0;
+        /// @brief Checks if two shapes of any type are overlapping (looks the test up by type).
+        /// @note Code that knows both types should call overlaps(a, b) from collision.h, which is inlined.
+        bool isOverlapping(Shape const& other) const;
         //Mouse overlapping
         virtual bool isMouseOverlaping(const vec2& point) const;
 
 protected:
+        const ShapeType type;
+
         /// @brief Shader used to draw all abstract shapes.
         /// @note This will need to be a pointer for custom shaders.
         Shader & shader;
@@ -142,12 +158,6 @@ protected:
 
         /// @brief The Vertex Array Object, Vertex Buffer Object, and Element Buffer Object of the shape.
         unsigned int VAO, VBO, EBO;
-
-        /// @brief The vertices of the shape
-        vector<float> vertices;
-
-        /// @brief The indices of the shape
-        vector<unsigned int> indices;
 };
 
 #endif //GRAPHICS_SHAPE_H
@@ -1,12 +1,10 @@
 #include "triangle.h"
 
 Triangle::Triangle(Shader & shader, vec2 pos, vec2 size, struct color color)
-    : Shape(shader, pos, size, color) {
-    // Check if a triangle has been initialized
-    initVectors();
+    : Shape(ShapeType::triangle, shader, pos, size, color) {
     initVAO();
-    initVBO();
-    initEBO();
+    initVBO(vertices);
+    initEBO(indices);
 }
 
 Triangle::~Triangle() {
@@ -21,14 +19,12 @@ void Triangle::draw() const {
     glBindVertexArray(0);
 }
 
-void Triangle::initVectors() {
-    this->vertices.insert(this->vertices.end(), {
-            -0.5f, -0.5f,  // Bottom left
-            0.5f, -0.5f,   // Bottom right
-            0.0f, 0.5f     // Top
-    });
+const vector<float> Triangle::vertices = {
+        -0.5f, -0.5f,  // Bottom left
+        0.5f, -0.5f,   // Bottom right
+        0.0f, 0.5f     // Top
+};
 
-    this->indices.insert(this->indices.end(), {
-            0, 1, 2,
-    });
-}
\ No newline at end of file
+const vector<unsigned int> Triangle::indices = {
+        0, 1, 2,
+};
\ No newline at end of file
@@ -22,8 +22,10 @@ public:
     /// @brief Binds the VAO and calls the virtual draw function
     void draw() const override;
 
-    /// @brief Populates the vertices and indices vectors
-    void initVectors();
+private:
+    /// @brief The vertices and indices of the triangle (shared by every triangle)
+    static const vector<float> vertices;
+    static const vector<unsigned int> indices;
 };
 
 #endif //GRAPHICS_TRIANGLE_H
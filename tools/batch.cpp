@@ -0,0 +1,124 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "game/session.h"
+#include "game/policy.h"
+#include "framework/random.h"
+#include "framework/threadPool.h"
+#include "framework/profiler.h"
+
+// dodgeball_batch: plays many independent simulated levels at once (no window) and prints one CSV row per level.
+//
+//   dodgeball_batch [--sessions 1000] [--levels 1,2,3,4,5] [--policy idle|random|greedy|lookahead] [--threads <n>] [--seed 1]
+//
+// Session i plays level levels[i % count] with game seed mix(seed, i), so every session has its own bubbles and
+// policy. Sessions run on a thread pool (one task each, all cores by default); the totals go to stderr.
+
+namespace {
+
+std::vector<int> parseList(const std::string &text) {
+    std::vector<int> values;
+    std::stringstream stream(text);
+    std::string value;
+    while (std::getline(stream, value, ',')) {
+        values.push_back(std::stoi(value));
+    }
+    return values;
+}
+
+}
+
+int main(int argc, char *argv[]) {
+    int sessionCount = 1000;
+    std::vector<int> levels = {1, 2, 3, 4, 5};
+    std::string policyName = "random";
+    int threads = ThreadPool::getDefaultThreadCount();
+    uint64_t seed = 1;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--sessions" && i + 1 < argc) {
+            sessionCount = std::stoi(argv[++i]);
+        }
+        else if (arg == "--levels" && i + 1 < argc) {
+            levels = parseList(argv[++i]);
+        }
+        else if (arg == "--policy" && i + 1 < argc) {
+            policyName = argv[++i];
+        }
+        else if (arg == "--threads" && i + 1 < argc) {
+            threads = std::stoi(argv[++i]);
+        }
+        else if (arg == "--seed" && i + 1 < argc) {
+            seed = std::stoull(argv[++i]);
+        }
+        else {
+            std::cerr << "Usage: " << argv[0] << " [--sessions <n>] [--levels <n,...>] [--policy " << getPolicyNames()
+                      << "] [--threads <n>] [--seed <n>]" << std::endl;
+            return 1;
+        }
+    }
+    if (createPolicy(policyName) == nullptr) {
+        std::cerr << "Unknown policy " << policyName << " (expected " << getPolicyNames() << ")" << std::endl;
+        return 1;
+    }
+    if (levels.empty() || sessionCount <= 0) {
+        std::cerr << "Nothing to run" << std::endl;
+        return 1;
+    }
+
+    // Each task only writes its own result
+    std::vector<SessionResult> results(sessionCount);
+    auto start = std::chrono::steady_clock::now();
+    {
+        ThreadPool pool(threads);
+        threads = pool.getThreadCount();
+        for (int i = 0; i < sessionCount; ++i) {
+            pool.submit([&results, &levels, &policyName, seed, i] {
+                Session session(levels[i % levels.size()], Random::mix(seed, i), createPolicy(policyName));
+                results[i] = session.run();
+            });
+        }
+        // Keep draining the workers' profiler buffers so they don't fill up
+        while (!pool.waitFor(std::chrono::milliseconds(50))) {
+            PROFILE_FRAME();
+        }
+        PROFILE_FRAME();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "level,policy,sessions,survived,survival_rate,mean_time_survived" << std::endl;
+    uint64_t totalTicks = 0;
+    for (int level : levels) {
+        int sessions = 0, survived = 0;
+        double timeSurvived = 0;
+        for (const SessionResult &result : results) {
+            if (result.level != level) {
+                continue;
+            }
+            sessions++;
+            survived += result.survived;
+            timeSurvived += result.timeSurvived;
+        }
+        if (sessions == 0) {
+            continue;
+        }
+        std::cout << level << ',' << policyName << ',' << sessions << ',' << survived << ','
+                  << double(survived) / sessions << ',' << timeSurvived / sessions << std::endl;
+    }
+    for (const SessionResult &result : results) {
+        totalTicks += result.ticks;
+    }
+
+    char line[160];
+    snprintf(line, sizeof(line), "%d sessions (%llu ticks) in %.3fs on %d threads: %.1f sessions/s, %.0f ticks/s",
+             sessionCount, static_cast<unsigned long long>(totalTicks), seconds, threads, sessionCount / seconds,
+             totalTicks / seconds);
+    std::cerr << line << std::endl;
+    return 0;
+}
@@ -0,0 +1,358 @@
+#include <algorithm>
+#include <cmath>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "game/session.h"
+#include "game/policy.h"
+#include "game/replication.h"
+#include "framework/random.h"
+#include "framework/udpSocket.h"
+#include "framework/profiler.h"
+
+// dodgeball_netsync: streams a simulated game to spectators over UDP and reports bandwidth and encode/decode times.
+//
+//   dodgeball_netsync --server [--port 27015] [--bubbles 1000] [--rate 30] [--seconds 10] [--policy lookahead]
+//                              [--loss 0] [--seed 1]
+//   dodgeball_netsync --client [--host 127.0.0.1] [--port 27015] [--delay 100]
+//   dodgeball_netsync --loopback [any of the above]      (server on a thread, client on this one)
+//
+// The server plays sessions of the last level with --bubbles bubbles, on a playfield scaled up to keep the level as
+// crowded (a new session starts when the last is over), at 60 ticks per second. It sends a snapshot to every client
+// that said hello --rate times per second; --loss drops that percentage of its packets. The client draws --delay
+// milliseconds in the past, between the two snapshots around that time.
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Options {
+    uint16_t port = 27015;
+    std::string host = "127.0.0.1";
+    int bubbles = 1000;
+    int rate = 30;
+    double seconds = 10;
+    std::string policy = "lookahead";
+    double loss = 0;
+    uint64_t seed = 1;
+    double delay = 100;
+};
+
+double secondsSince(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+double microsecondsSince(Clock::time_point start) {
+    return std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+}
+
+struct Client {
+    NetAddress address;
+    SnapshotEncoder encoder;
+    uint64_t snapshots = 0;
+    uint64_t deltas = 0;
+    uint64_t bytes = 0;
+    /// @brief Snapshots the socket refused to send (not counted in snapshots or bytes)
+    uint64_t failed = 0;
+    size_t largest = 0;
+    double encodeTime = 0;
+    double maxEncodeTime = 0;
+    Clock::time_point joined;
+};
+
+std::string runServer(UdpSocket &socket, const Options &options, bool drainProfiler) {
+    // The playfield grows with the bubble count, so it's as crowded as the last level
+    LevelConfig config = getLevelConfig(LAST_LEVEL);
+    vec2 bounds = vec2(1600, 1200) * std::sqrt(std::max(1.0f, float(options.bubbles) / config.numberOfBubbles));
+    config.numberOfBubbles = options.bubbles;
+    uint64_t sessionCount = 0;
+    auto newSession = [&] {
+        uint64_t seed = Random::mix(options.seed, sessionCount++);
+        return std::make_unique<Session>(config, seed, createPolicy(options.policy), bounds);
+    };
+    std::unique_ptr<Session> session = newSession();
+
+    std::vector<std::unique_ptr<Client>> clients;
+    std::vector<unsigned char> packet;
+    std::vector<unsigned char> received(UdpSocket::MAX_DATAGRAM);
+    NetSnapshot snapshot;
+    Random loss(Random::mix(options.seed, 0xDEAD));
+    const int interval = std::max(1, NET_TICKS_PER_SECOND / std::max(1, options.rate));
+    const auto tickLength = std::chrono::microseconds(1000000 / NET_TICKS_PER_SECOND);
+    const uint32_t tickCount = uint32_t(options.seconds * NET_TICKS_PER_SECOND);
+    uint32_t sequence = 0;
+    double captureTime = 0;
+
+    std::cout << "Server on port " << socket.getPort() << ": " << options.bubbles << " bubbles in " << int(bounds.x)
+              << 'x' << int(bounds.y) << ", " << NET_TICKS_PER_SECOND / interval << " snapshots/s for "
+              << options.seconds << 's' << std::endl;
+    auto next = Clock::now();
+    for (uint32_t tick = 0; tick < tickCount; ++tick) {
+        NetAddress from;
+        int size;
+        while ((size = socket.receive(received.data(), received.size(), from)) > 0) {
+            NetPacket type;
+            uint32_t value;
+            if (!readMessage(received.data(), size, type, value)) {
+                continue;
+            }
+            auto client = std::find_if(clients.begin(), clients.end(),
+                                       [&](const std::unique_ptr<Client> &client) { return client->address == from; });
+            if (type == PACKET_HELLO && client == clients.end()) {
+                clients.push_back(std::make_unique<Client>());
+                clients.back()->address = from;
+                clients.back()->joined = Clock::now();
+                std::cout << from.toString() << " joined" << std::endl;
+            }
+            else if (type == PACKET_ACK && client != clients.end()) {
+                (*client)->encoder.acknowledge(value);
+            }
+        }
+
+        if (!session->step()) {
+            session = newSession();
+        }
+        if (tick % interval == 0) {
+            auto start = Clock::now();
+            captureSnapshot(*session, ++sequence, tick, snapshot);
+            captureTime += microsecondsSince(start);
+            for (std::unique_ptr<Client> &client : clients) {
+                start = Clock::now();
+                client->encoder.encode(snapshot, packet);
+                double time = microsecondsSince(start);
+                client->encodeTime += time;
+                client->maxEncodeTime = std::max(client->maxEncodeTime, time);
+                // A dropped packet still counts (it was sent, the network lost it)
+                if (loss.nextFloat() * 100 < options.loss ||
+                    socket.send(client->address, packet.data(), packet.size())) {
+                    client->snapshots++;
+                    client->deltas += client->encoder.wasDelta();
+                    client->bytes += packet.size();
+                    client->largest = std::max(client->largest, packet.size());
+                }
+                else {
+                    client->failed++;
+                }
+            }
+        }
+        if (drainProfiler) {
+            PROFILE_FRAME();
+        }
+        next += tickLength;
+        std::this_thread::sleep_until(next);
+    }
+
+    writeMessage(PACKET_BYE, sequence, packet);
+    char line[256];
+    snprintf(line, sizeof(line), "Server: %u snapshots, capture %.1f us avg\n", sequence,
+             captureTime / std::max(sequence, 1u));
+    std::string report = line;
+    for (std::unique_ptr<Client> &client : clients) {
+        socket.send(client->address, packet.data(), packet.size());
+        double seconds = secondsSince(client->joined);
+        snprintf(line, sizeof(line),
+                 "  %s: %llu snapshots (%.0f%% delta), %.1f KB/s, %.0f bytes avg (%zu max), encode %.1f us avg "
+                 "(%.1f max)\n", client->address.toString().c_str(), static_cast<unsigned long long>(client->snapshots),
+                 100.0 * client->deltas / std::max<uint64_t>(client->snapshots, 1), client->bytes / seconds / 1000,
+                 double(client->bytes) / std::max<uint64_t>(client->snapshots, 1), client->largest,
+                 client->encodeTime / std::max<uint64_t>(client->snapshots, 1), client->maxEncodeTime);
+        report += line;
+        if (client->failed > 0) {
+            snprintf(line, sizeof(line), "  %s: %llu snapshots could not be sent\n",
+                     client->address.toString().c_str(), static_cast<unsigned long long>(client->failed));
+            report += line;
+        }
+    }
+    return report;
+}
+
+std::string runClient(UdpSocket &socket, const NetAddress &server, const Options &options) {
+    SnapshotDecoder decoder;
+    SnapshotInterpolator interpolator;
+    NetSnapshot snapshot;
+    InterpolatedState state;
+    std::vector<unsigned char> packet;
+    std::vector<unsigned char> received(UdpSocket::MAX_DATAGRAM);
+
+    uint64_t packets = 0, decoded = 0, bytes = 0, samples = 0, held = 0;
+    double decodeTime = 0, maxDecodeTime = 0;
+    uint32_t firstTick = 0;
+    const double delayTicks = options.delay / 1000 * NET_TICKS_PER_SECOND;
+    const auto sampleLength = std::chrono::microseconds(1000000 / NET_TICKS_PER_SECOND);
+    bool over = false;
+
+    auto start = Clock::now();
+    auto lastPacket = start;
+    auto lastHello = start - std::chrono::seconds(1);
+    Clock::time_point firstPacket, nextSample;
+    while (!over) {
+        auto now = Clock::now();
+        if (packets == 0) {
+            if (now - start > std::chrono::seconds(5)) {
+                return "Client: no answer from " + server.toString() + "\n";
+            }
+            if (now - lastHello > std::chrono::milliseconds(500)) {
+                writeMessage(PACKET_HELLO, 0, packet);
+                socket.send(server, packet.data(), packet.size());
+                lastHello = now;
+            }
+        }
+        else if (now - lastPacket > std::chrono::seconds(3)) {
+            break;
+        }
+
+        NetAddress from;
+        int size;
+        while ((size = socket.receive(received.data(), received.size(), from)) > 0) {
+            if (from != server) {
+                continue;
+            }
+            if (received[0] != PACKET_SNAPSHOT) {
+                NetPacket type;
+                uint32_t value;
+                over = readMessage(received.data(), size, type, value) && type == PACKET_BYE;
+                continue;
+            }
+            lastPacket = Clock::now();
+            if (packets++ == 0) {
+                firstPacket = lastPacket;
+                nextSample = lastPacket;
+            }
+            bytes += size;
+            auto decodeStart = Clock::now();
+            bool valid = decoder.decode(received.data(), size, snapshot);
+            double time = microsecondsSince(decodeStart);
+            if (!valid) {
+                continue;
+            }
+            decodeTime += time;
+            maxDecodeTime = std::max(maxDecodeTime, time);
+            if (decoded++ == 0) {
+                firstTick = snapshot.tick;
+            }
+            interpolator.add(snapshot);
+            writeMessage(PACKET_ACK, decoder.getLatestSequence(), packet);
+            socket.send(server, packet.data(), packet.size());
+        }
+
+        // Draw 60 times per second, a little behind the server
+        now = Clock::now();
+        if (decoded > 0 && now >= nextSample) {
+            double tick = firstTick + std::chrono::duration<double>(now - firstPacket).count() * NET_TICKS_PER_SECOND -
+                          delayTicks;
+            if (tick >= firstTick) {
+                samples++;
+                held += !interpolator.sample(tick, state);
+            }
+            nextSample += sampleLength;
+        }
+        PROFILE_FRAME();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    double seconds = std::max(std::chrono::duration<double>(lastPacket - firstPacket).count(), 1e-3);
+    char line[256];
+    snprintf(line, sizeof(line),
+             "Client: %llu packets, %llu decoded, %.1f KB/s, decode %.1f us avg (%.1f max), %llu frames drawn "
+             "(%.1f%% past the newest snapshot), %zu bubbles\n",
+             static_cast<unsigned long long>(packets), static_cast<unsigned long long>(decoded), bytes / seconds / 1000,
+             decodeTime / std::max<uint64_t>(decoded, 1), maxDecodeTime, static_cast<unsigned long long>(samples),
+             100.0 * held / std::max<uint64_t>(samples, 1), state.bubbles.size());
+    return line;
+}
+
+}
+
+int main(int argc, char *argv[]) {
+    Options options;
+    std::string mode;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--server" || arg == "--client" || arg == "--loopback") {
+            mode = arg.substr(2);
+        }
+        else if (arg == "--port" && i + 1 < argc) {
+            options.port = static_cast<uint16_t>(std::stoi(argv[++i]));
+        }
+        else if (arg == "--host" && i + 1 < argc) {
+            options.host = argv[++i];
+        }
+        else if (arg == "--bubbles" && i + 1 < argc) {
+            options.bubbles = std::stoi(argv[++i]);
+        }
+        else if (arg == "--rate" && i + 1 < argc) {
+            options.rate = std::stoi(argv[++i]);
+        }
+        else if (arg == "--seconds" && i + 1 < argc) {
+            options.seconds = std::stod(argv[++i]);
+        }
+        else if (arg == "--policy" && i + 1 < argc) {
+            options.policy = argv[++i];
+        }
+        else if (arg == "--loss" && i + 1 < argc) {
+            options.loss = std::stod(argv[++i]);
+        }
+        else if (arg == "--seed" && i + 1 < argc) {
+            options.seed = std::stoull(argv[++i]);
+        }
+        else if (arg == "--delay" && i + 1 < argc) {
+            options.delay = std::stod(argv[++i]);
+        }
+        else {
+            mode.clear();
+            break;
+        }
+    }
+    if (mode.empty()) {
+        std::cerr << "Usage: " << argv[0] << " --server|--client|--loopback [--port <n>] [--host <ip>] [--bubbles <n>]"
+                  << " [--rate <n>] [--seconds <s>] [--policy " << getPolicyNames() << "] [--loss <%>] [--seed <n>]"
+                  << " [--delay <ms>]" << std::endl;
+        return 1;
+    }
+    if (options.bubbles < 0 || getMaxSnapshotSize(size_t(options.bubbles)) > UdpSocket::MAX_DATAGRAM) {
+        // A snapshot is one datagram
+        int most = 0;
+        while (getMaxSnapshotSize(size_t(most) + 1) <= UdpSocket::MAX_DATAGRAM) {
+            most++;
+        }
+        std::cerr << "--bubbles " << options.bubbles << " doesn't fit in a snapshot (0 to " << most << ")" << std::endl;
+        return 1;
+    }
+    if (createPolicy(options.policy) == nullptr) {
+        std::cerr << "Unknown policy " << options.policy << " (expected " << getPolicyNames() << ")" << std::endl;
+        return 1;
+    }
+    NetAddress server;
+    if (!NetAddress::parse(mode == "loopback" ? "127.0.0.1" : options.host, options.port, server)) {
+        std::cerr << options.host << " is not an IPv4 address" << std::endl;
+        return 1;
+    }
+
+    UdpSocket serverSocket, clientSocket;
+    if (mode != "client" && !serverSocket.open(options.port)) {
+        return 1;
+    }
+    if (mode != "server" && !clientSocket.open()) {
+        return 1;
+    }
+    if (mode == "server") {
+        std::cout << runServer(serverSocket, options, true);
+    }
+    else if (mode == "client") {
+        std::cout << runClient(clientSocket, server, options);
+    }
+    else {
+        std::string serverReport;
+        std::thread serverThread([&] { serverReport = runServer(serverSocket, options, false); });
+        std::string clientReport = runClient(clientSocket, server, options);
+        serverThread.join();
+        std::cout << serverReport << clientReport;
+    }
+    return 0;
+}
@@ -0,0 +1,153 @@
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+#include "game/level.h"
+#include "game/world.h"
+#include "ecs/registry.h"
+#include "framework/arena.h"
+
+// dodgeball_stress: steps the real bubble simulation (no window) and prints one CSV row per run.
+//
+//   dodgeball_stress [--bubbles 95,1000,10000,100000] [--threads 1,2,4] [--min-radius 5] [--max-radius 25]
+//                    [--speed 55] [--seed 1] [--ticks 300] [--size <width>x<height>]
+//
+// --bubbles and --threads take comma separated lists and every combination is run. Without --size the playfield
+// is scaled with the bubble count so the density matches level 5 (95 bubbles on 1600x1200).
+// Peak RSS is for the whole process so far, so list bubble counts from smallest to largest.
+
+namespace {
+
+const float DELTA_TIME = 1.0f / 60.0f;
+
+std::vector<int> parseList(const std::string &text) {
+    std::vector<int> values;
+    std::stringstream stream(text);
+    std::string value;
+    while (std::getline(stream, value, ',')) {
+        values.push_back(std::stoi(value));
+    }
+    return values;
+}
+
+/// @brief Peak resident set size of the process in kilobytes.
+long getPeakRssKb() {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters));
+    return static_cast<long>(counters.PeakWorkingSetSize / 1024);
+#else
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+    return usage.ru_maxrss / 1024;
+#else
+    return usage.ru_maxrss;
+#endif
+#endif
+}
+
+}
+
+int main(int argc, char *argv[]) {
+    LevelConfig config = getLevelConfig(LAST_LEVEL);
+    std::vector<int> bubbleCounts = {config.numberOfBubbles, 1000, 10000, 100000};
+    std::vector<int> threadCounts = {1};
+    uint64_t seed = 1;
+    int ticks = 300;
+    vec2 size(0);
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--bubbles" && i + 1 < argc) {
+            bubbleCounts = parseList(argv[++i]);
+        }
+        else if (arg == "--threads" && i + 1 < argc) {
+            threadCounts = parseList(argv[++i]);
+        }
+        else if (arg == "--min-radius" && i + 1 < argc) {
+            config.minRadius = std::stof(argv[++i]);
+        }
+        else if (arg == "--max-radius" && i + 1 < argc) {
+            config.maxRadius = std::stof(argv[++i]);
+        }
+        else if (arg == "--speed" && i + 1 < argc) {
+            config.maxSpeed = std::stof(argv[++i]);
+        }
+        else if (arg == "--seed" && i + 1 < argc) {
+            seed = std::stoull(argv[++i]);
+        }
+        else if (arg == "--ticks" && i + 1 < argc) {
+            ticks = std::stoi(argv[++i]);
+        }
+        else if (arg == "--size" && i + 1 < argc) {
+            std::string text = argv[++i];
+            size_t x = text.find('x');
+            if (x == std::string::npos) {
+                std::cerr << "--size must look like 1600x1200" << std::endl;
+                return 1;
+            }
+            size = vec2(std::stof(text.substr(0, x)), std::stof(text.substr(x + 1)));
+        }
+        else {
+            std::cerr << "Usage: " << argv[0] << " [--bubbles <n,...>] [--threads <n,...>] [--min-radius <r>]"
+                      << " [--max-radius <r>] [--speed <s>] [--seed <n>] [--ticks <n>] [--size <w>x<h>]" << std::endl;
+            return 1;
+        }
+    }
+
+    std::cout << "bubbles,threads,width,height,min_radius,max_radius,speed,seed,ticks,"
+                 "ticks_per_sec,pair_tests_per_tick,contacts_per_tick,peak_rss_kb" << std::endl;
+
+    for (int count : bubbleCounts) {
+        vec2 bounds = size;
+        if (bounds.x <= 0 || bounds.y <= 0) {
+            bounds = vec2(1600, 1200) * std::sqrt(float(count) / getLevelConfig(LAST_LEVEL).numberOfBubbles);
+        }
+        config.numberOfBubbles = count;
+
+        for (int threads : threadCounts) {
+            // Same spawn code as the game's levels, so every thread count starts from the same bubbles
+            Arena arena(getSpawnArenaSize(count));
+            LevelSpawns spawns = generateBubbles(config, unsigned(bounds.x), unsigned(bounds.y), seed, arena);
+            if (spawns.count != count) {
+                std::cerr << "Could not allocate " << count << " bubbles" << std::endl;
+                return 1;
+            }
+            Registry registry;
+            registry.reserve(count);
+            for (int i = 0; i < spawns.count; ++i) {
+                spawnBubble(registry, spawns.bubbles[i]);
+            }
+            World world(bounds, threads);
+            world.load(registry);
+
+            uint64_t pairTests = 0, contacts = 0;
+            auto start = std::chrono::steady_clock::now();
+            for (int tick = 0; tick < ticks; ++tick) {
+                world.step(registry, DELTA_TIME);
+                pairTests += world.getStepStats().pairTests;
+                contacts += world.getStepStats().contacts;
+            }
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+            // The thread count the world actually used (it runs at least one)
+            std::cout << count << ',' << world.getThreadCount() << ',' << bounds.x << ',' << bounds.y << ','
+                      << config.minRadius << ',' << config.maxRadius << ',' << config.maxSpeed << ',' << seed << ','
+                      << ticks << ',' << ticks / seconds << ',' << double(pairTests) / ticks << ','
+                      << double(contacts) / ticks << ',' << getPeakRssKb() << std::endl;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,181 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "game/session.h"
+#include "game/policy.h"
+#include "game/player.h"
+#include "framework/random.h"
+#include "framework/threadPool.h"
+#include "framework/profiler.h"
+
+// dodgeball_tuner: Monte Carlo difficulty tuning. Plays many simulated sessions for each set of bubble stats and
+// prints one CSV row per set, with its survival curve (the share of sessions still alive after each second).
+//
+//   dodgeball_tuner [--sessions 500] [--policy lookahead] [--threads <n>] [--seed 1]
+//                   [--counts 20,30] [--radii 40,60] [--speeds 30,50] [--min-radius 10]
+//
+// Without --counts/--radii/--speeds the sets are the game's levels. With any of them, every combination of counts,
+// max radii and max speeds is played (missing lists use the last level's value). Every set is played with the same
+// seeds (mix(seed, i) for session i), so the differences between sets come from the stats, not from luck.
+
+namespace {
+
+std::vector<float> parseList(const std::string &text) {
+    std::vector<float> values;
+    std::stringstream stream(text);
+    std::string value;
+    while (std::getline(stream, value, ',')) {
+        values.push_back(std::stof(value));
+    }
+    return values;
+}
+
+}
+
+int main(int argc, char *argv[]) {
+    int sessionCount = 500;
+    std::string policyName = "lookahead";
+    int threads = ThreadPool::getDefaultThreadCount();
+    uint64_t seed = 1;
+    std::vector<float> counts, radii, speeds;
+    float minRadius = -1;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--sessions" && i + 1 < argc) {
+            sessionCount = std::stoi(argv[++i]);
+        }
+        else if (arg == "--policy" && i + 1 < argc) {
+            policyName = argv[++i];
+        }
+        else if (arg == "--threads" && i + 1 < argc) {
+            threads = std::stoi(argv[++i]);
+        }
+        else if (arg == "--seed" && i + 1 < argc) {
+            seed = std::stoull(argv[++i]);
+        }
+        else if (arg == "--counts" && i + 1 < argc) {
+            counts = parseList(argv[++i]);
+        }
+        else if (arg == "--radii" && i + 1 < argc) {
+            radii = parseList(argv[++i]);
+        }
+        else if (arg == "--speeds" && i + 1 < argc) {
+            speeds = parseList(argv[++i]);
+        }
+        else if (arg == "--min-radius" && i + 1 < argc) {
+            minRadius = std::stof(argv[++i]);
+        }
+        else {
+            std::cerr << "Usage: " << argv[0] << " [--sessions <n>] [--policy " << getPolicyNames()
+                      << "] [--threads <n>] [--seed <n>] [--counts <n,...>] [--radii <r,...>] [--speeds <s,...>]"
+                      << " [--min-radius <r>]" << std::endl;
+            return 1;
+        }
+    }
+    if (createPolicy(policyName) == nullptr) {
+        std::cerr << "Unknown policy " << policyName << " (expected " << getPolicyNames() << ")" << std::endl;
+        return 1;
+    }
+
+    std::vector<LevelConfig> configs;
+    if (counts.empty() && radii.empty() && speeds.empty()) {
+        for (int level = 1; level <= LAST_LEVEL; ++level) {
+            configs.push_back(getLevelConfig(level));
+        }
+    }
+    else {
+        const LevelConfig base = getLevelConfig(LAST_LEVEL);
+        if (counts.empty()) counts = {float(base.numberOfBubbles)};
+        if (radii.empty())  radii = {base.maxRadius};
+        if (speeds.empty()) speeds = {base.maxSpeed};
+        for (float count : counts) {
+            for (float radius : radii) {
+                for (float speed : speeds) {
+                    LevelConfig config = base;
+                    config.numberOfBubbles = static_cast<int>(count);
+                    config.maxRadius = radius;
+                    config.maxSpeed = speed;
+                    if (minRadius >= 0) {
+                        config.minRadius = minRadius;
+                    }
+                    configs.push_back(config);
+                }
+            }
+        }
+    }
+    for (const LevelConfig &config : configs) {
+        if (config.numberOfBubbles <= 0 || config.minRadius > config.maxRadius) {
+            std::cerr << "Bad set: " << config.numberOfBubbles << " bubbles, radius " << config.minRadius << " to "
+                      << config.maxRadius << std::endl;
+            return 1;
+        }
+    }
+    if (sessionCount <= 0) {
+        std::cerr << "Nothing to run" << std::endl;
+        return 1;
+    }
+
+    // Every session of every set goes to the same pool, so sets with short sessions don't leave cores idle
+    std::vector<SessionResult> results(configs.size() * sessionCount);
+    auto start = std::chrono::steady_clock::now();
+    {
+        ThreadPool pool(threads);
+        threads = pool.getThreadCount();
+        for (size_t set = 0; set < configs.size(); ++set) {
+            for (int i = 0; i < sessionCount; ++i) {
+                pool.submit([&results, &configs, &policyName, seed, set, i, sessionCount] {
+                    Session session(configs[set], Random::mix(seed, i), createPolicy(policyName));
+                    results[set * sessionCount + i] = session.run();
+                });
+            }
+        }
+        // Keep draining the workers' profiler buffers so they don't fill up
+        while (!pool.waitFor(std::chrono::milliseconds(50))) {
+            PROFILE_FRAME();
+        }
+        PROFILE_FRAME();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "count,min_radius,max_radius,speed,policy,sessions,survival_rate,mean_time";
+    for (int second = 1; second <= LEVEL_TIME; ++second) {
+        std::cout << ",alive_" << second << 's';
+    }
+    std::cout << std::endl;
+    uint64_t totalTicks = 0;
+    for (size_t set = 0; set < configs.size(); ++set) {
+        const LevelConfig &config = configs[set];
+        int survived = 0;
+        double timeSurvived = 0;
+        std::vector<int> alive(LEVEL_TIME + 1, 0);
+        for (int i = 0; i < sessionCount; ++i) {
+            const SessionResult &result = results[set * sessionCount + i];
+            survived += result.survived;
+            timeSurvived += result.timeSurvived;
+            totalTicks += result.ticks;
+            for (int second = 1; second <= LEVEL_TIME; ++second) {
+                alive[second] += result.survived || result.timeSurvived >= second;
+            }
+        }
+        std::cout << config.numberOfBubbles << ',' << config.minRadius << ',' << config.maxRadius << ','
+                  << config.maxSpeed << ',' << policyName << ',' << sessionCount << ','
+                  << double(survived) / sessionCount << ',' << timeSurvived / sessionCount;
+        for (int second = 1; second <= LEVEL_TIME; ++second) {
+            std::cout << ',' << double(alive[second]) / sessionCount;
+        }
+        std::cout << std::endl;
+    }
+
+    char line[160];
+    snprintf(line, sizeof(line), "%zu sets x %d sessions (%llu ticks) in %.3fs on %d threads: %.0f ticks/s",
+             configs.size(), sessionCount, static_cast<unsigned long long>(totalTicks), seconds, threads,
+             totalTicks / seconds);
+    std::cerr << line << std::endl;
+    return 0;
+}